@@ -0,0 +1,110 @@
+#
+# Generates the MCC/MNC => country table from the tzdata style MCC file
+# (MCC MNC ISO-3166 Name). The output is included by gofono_country.c
+#
+# MCC directly indexes ofono_country_mcc[] which points to the range of
+# ofono_country_mnc[] entries. Consecutive MNCs of the same country are
+# merged into one entry. Two and three digit MNCs are different things
+# ("01" is not "001") so the MNC key is (number of digits * 1000 + MNC).
+# If the same MCC/MNC is listed more than once, the first entry wins.
+#
+
+BEGIN {
+    ncc = 0
+    min = 1000
+    max = -1
+}
+
+/^#/ || NF < 3 {
+    next
+}
+
+{
+    if ($1 !~ /^[0-9][0-9][0-9]$/ || $2 !~ /^[0-9][0-9][0-9]?$/ ||
+        $3 !~ /^[A-Z][A-Z]$/) {
+        printf("%s:%d: invalid entry\n", FILENAME, FNR) > "/dev/stderr"
+        failed = 1
+        exit 1
+    }
+
+    mcc = $1 + 0
+    key = length($2) * 1000 + $2
+    if ((mcc, key) in seen) {
+        next
+    }
+    seen[mcc, key] = 1
+
+    if (!($3 in cc_index)) {
+        cc_index[$3] = ncc
+        cc_list[ncc++] = $3
+    }
+
+    # Insertion sort, the input is mostly sorted
+    i = count[mcc]++
+    while (i > 0 && keys[mcc, i - 1] > key) {
+        keys[mcc, i] = keys[mcc, i - 1]
+        ccs[mcc, i] = ccs[mcc, i - 1]
+        i--
+    }
+    keys[mcc, i] = key
+    ccs[mcc, i] = cc_index[$3]
+    if (mcc < min) min = mcc
+    if (mcc > max) max = mcc
+}
+
+END {
+    if (failed) {
+        exit 1
+    }
+
+    print "/* Generated from the MCC file by country_table.awk, do not edit */"
+    print ""
+    printf("#define OFONO_COUNTRY_MCC_MIN (%d)\n", min)
+    printf("#define OFONO_COUNTRY_MCC_MAX (%d)\n", max)
+    print ""
+
+    print "static const char ofono_country_codes[][3] = {"
+    for (i = 0; i < ncc; i++) {
+        printf("    \"%s\"%s\n", cc_list[i], (i + 1 < ncc) ? "," : "")
+    }
+    print "};"
+    print ""
+
+    nmnc = 0
+    print "static const OfonoCountryMnc ofono_country_mnc[] = {"
+    for (mcc = min; mcc <= max; mcc++) {
+        if (!(mcc in count)) {
+            continue
+        }
+        start[mcc] = nmnc
+        first = keys[mcc, 0]
+        last = first
+        cc = ccs[mcc, 0]
+        for (i = 1; i <= count[mcc]; i++) {
+            if (i < count[mcc] && keys[mcc, i] == last + 1 &&
+                ccs[mcc, i] == cc) {
+                last = keys[mcc, i]
+                continue
+            }
+            printf("    { %d, %d, %d }, /* %03d %s */\n", first, last, cc,
+                mcc, cc_list[cc])
+            nmnc++
+            if (i < count[mcc]) {
+                first = last = keys[mcc, i]
+                cc = ccs[mcc, i]
+            }
+        }
+        size[mcc] = nmnc - start[mcc]
+    }
+    print "};"
+    print ""
+
+    print "static const OfonoCountryMcc ofono_country_mcc[] = {"
+    for (mcc = min; mcc <= max; mcc++) {
+        if (mcc in count) {
+            printf("    [%d - OFONO_COUNTRY_MCC_MIN] = { %d, %d },\n", mcc,
+                start[mcc], size[mcc])
+        }
+    }
+    print "};"
+}
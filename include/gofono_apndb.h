@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_APNDB_H
+#define GOFONO_APNDB_H
+
+#include "gofono_connctx.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Operator/APN database compiled from the mobile-broadband-provider-info
+ * XML (see tools/ofono-apndb). The file is mapped read-only, so its pages
+ * are shared by all processes using the same database, and looked up in
+ * place. Lookups by MCC, MNC and SPN (provider name) take constant time.
+ * If there are no APNs for the given SPN (or SPN is NULL), the APNs of
+ * all providers using this MCC/MNC are returned, primary ones first.
+ *
+ * Strings returned by ofono_apndb_lookup() point to the mapped file and
+ * remain valid for as long as the database is referenced.
+ */
+
+typedef struct ofono_apndb OfonoApnDb;
+typedef struct ofono_apndb_builder OfonoApnDbBuilder;
+
+typedef struct ofono_apndb_apn {
+    const char* provider;                       /* Provider name (SPN) */
+    const char* apn;                            /* AccessPointName */
+    const char* name;                           /* Name */
+    const char* username;                       /* Username */
+    const char* password;                       /* Password */
+    const char* mms_center;                     /* MessageCenter */
+    const char* mms_proxy;                      /* MessageProxy */
+    OFONO_CONNCTX_TYPE type;                    /* Type */
+    OFONO_CONNCTX_AUTH auth;                    /* AuthenticationMethod */
+} OfonoApnDbApn;
+
+OfonoApnDb*
+ofono_apndb_open(
+    const char* path,
+    GError** error);
+
+OfonoApnDb*
+ofono_apndb_ref(
+    OfonoApnDb* db);
+
+void
+ofono_apndb_unref(
+    OfonoApnDb* db);
+
+/*
+ * Fills up to max entries, returns the total number of APNs found
+ * which may be larger than max.
+ */
+guint
+ofono_apndb_lookup(
+    OfonoApnDb* db,
+    const char* mcc,
+    const char* mnc,
+    const char* spn,
+    OfonoApnDbApn* apns,
+    guint max);
+
+/* Builder is used by the compiler */
+
+OfonoApnDbBuilder*
+ofono_apndb_builder_new(
+    void);
+
+void
+ofono_apndb_builder_free(
+    OfonoApnDbBuilder* builder);
+
+/* apn->provider is the SPN, NULL if the provider has no name */
+gboolean
+ofono_apndb_builder_add(
+    OfonoApnDbBuilder* builder,
+    const char* mcc,
+    const char* mnc,
+    gboolean primary,
+    const OfonoApnDbApn* apn);
+
+/* The file is replaced atomically, existing mappings are not affected */
+gboolean
+ofono_apndb_builder_write(
+    OfonoApnDbBuilder* builder,
+    const char* path,
+    GError** error);
+
+G_END_DECLS
+
+#endif /* GOFONO_APNDB_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -35,9 +35,12 @@
 
 #include "gofono_object.h"
 
+#include <netinet/in.h>
+
 G_BEGIN_DECLS
 
 typedef struct ofono_connctx_priv OfonoConnCtxPriv;
+typedef struct ofono_connctx_tx OfonoConnCtxTx;
 
 typedef enum ofono_connctx_protocol {
     OFONO_CONNCTX_PROTOCOL_UNKNOWN = -1,
@@ -62,6 +65,34 @@ typedef enum ofono_connctx_method {
     OFONO_CONNCTX_METHOD_DHCP                   /* dhcp */
 } OFONO_CONNCTX_METHOD;
 
+/* Fields changed by the last update, see ofono_connctx_settings_changed() */
+typedef enum ofono_connctx_settings_changed {
+    OFONO_CONNCTX_SETTINGS_CHANGED_IFNAME = 0x01,
+    OFONO_CONNCTX_SETTINGS_CHANGED_METHOD = 0x02,
+    OFONO_CONNCTX_SETTINGS_CHANGED_ADDRESS = 0x04,
+    OFONO_CONNCTX_SETTINGS_CHANGED_NETMASK = 0x08,
+    OFONO_CONNCTX_SETTINGS_CHANGED_GATEWAY = 0x10,
+    OFONO_CONNCTX_SETTINGS_CHANGED_DNS = 0x20,
+    OFONO_CONNCTX_SETTINGS_CHANGED_PREFIX = 0x40
+} OFONO_CONNCTX_SETTINGS_CHANGED;
+
+/* Binary form of the settings, parsed once when settings change */
+typedef struct ofono_connctx_addr {
+    int family;                                 /* AF_INET/AF_INET6/AF_UNSPEC */
+    union {
+        struct in_addr in;
+        struct in6_addr in6;
+    } u;
+} OfonoConnCtxAddr;
+
+typedef struct ofono_connctx_net_config {
+    OfonoConnCtxAddr address;
+    OfonoConnCtxAddr gateway;
+    guint prefix;                               /* PrefixLength or Netmask */
+    const OfonoConnCtxAddr* dns;
+    guint dns_count;
+} OfonoConnCtxNetConfig;
+
 typedef struct ofono_connctx_settings {
     const char* ifname;                         /* Interface */
     OFONO_CONNCTX_METHOD method;                /* Method */
@@ -70,6 +101,7 @@ typedef struct ofono_connctx_settings {
     const char* gateway;                        /* Gateway */
     char* const* dns;                           /* DomainNameServers */
     guint prefix;                               /* PrefixLength */
+    OfonoConnCtxNetConfig net;
 } OfonoConnCtxSettings;
 
 struct ofono_connctx {
@@ -90,6 +122,24 @@ struct ofono_connctx {
     const char* mms_center;                     /* MessageCenter */
 };
 
+/* Immutable copy of the above, see gofono_snapshot.h */
+typedef struct ofono_connctx_snapshot {
+    OfonoSnapshot snapshot;
+    const char* ifname;
+    gboolean active;
+    const char* apn;
+    OFONO_CONNCTX_TYPE type;
+    OFONO_CONNCTX_AUTH auth;
+    const char* username;
+    const char* password;
+    OFONO_CONNCTX_PROTOCOL protocol;
+    const char* name;
+    const OfonoConnCtxSettings* settings;       /* NULL if none */
+    const OfonoConnCtxSettings* ipv6_settings;  /* NULL if none */
+    const char* mms_proxy;
+    const char* mms_center;
+} OfonoConnCtxSnapshot;
+
 GType ofono_connctx_get_type(void);
 #define OFONO_TYPE_CONNCTX (ofono_connctx_get_type())
 #define OFONO_CONNCTX(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
@@ -115,6 +165,28 @@ void
     const GError* error,
     void* arg);
 
+typedef struct ofono_connctx_tx_result {
+    const char* name;
+    const GError* error;
+} OfonoConnCtxTxResult;
+
+/* The error is the first one in the results, NULL if all writes succeeded */
+typedef
+void
+(*OfonoConnCtxTxHandler)(
+    OfonoConnCtx* sender,
+    const OfonoConnCtxTxResult* results,
+    guint count,
+    const GError* error,
+    void* arg);
+
+/* Microseconds since ofono_connctx_activate_async() was called */
+typedef struct ofono_connctx_activate_timing {
+    gint64 call_reply;                          /* SetProperty reply */
+    gint64 active;                              /* Active = true */
+    gint64 settings;                            /* Settings configured */
+} OfonoConnCtxActivateTiming;
+
 typedef
 void
 (*OfonoConnCtxPropertyHandler)(
@@ -135,6 +207,10 @@ void
 ofono_connctx_unref(
     OfonoConnCtx* context);
 
+OfonoConnCtxSnapshot*
+ofono_connctx_snapshot(
+    OfonoConnCtx* context);
+
 const char*
 ofono_connctx_type_string(
     OFONO_CONNCTX_TYPE type);
@@ -151,6 +227,27 @@ const char*
 ofono_connctx_method_string(
     OFONO_CONNCTX_METHOD method);
 
+gboolean
+ofono_connctx_addr_equal(
+    const OfonoConnCtxAddr* addr1,
+    const OfonoConnCtxAddr* addr2);
+
+/*
+ * Returns OFONO_CONNCTX_SETTINGS_CHANGED mask of the fields changed by the
+ * last update of Settings (or IPv6.Settings if ipv6 is TRUE). Useful in
+ * settings-changed handlers.
+ */
+guint
+ofono_connctx_settings_changed(
+    OfonoConnCtx* context,
+    gboolean ipv6);
+
+/* Compares addresses, prefix and DNS servers (in any order) */
+gboolean
+ofono_connctx_net_config_equal(
+    const OfonoConnCtxNetConfig* config1,
+    const OfonoConnCtxNetConfig* config2);
+
 gulong
 ofono_connctx_add_valid_changed_handler(
     OfonoConnCtx* context,
@@ -237,6 +334,38 @@ void
 ofono_connctx_deactivate(
     OfonoConnCtx* context);
 
+/*
+ * Completes when the context is active and either Settings or
+ * IPv6.Settings have an interface and an address. Fails on activation
+ * failure, deactivation request, timeout (G_IO_ERROR_TIMED_OUT) or
+ * cancellation. Zero or negative timeout means no deadline. Timing
+ * may be NULL, zero times mean that the step was already done.
+ */
+void
+ofono_connctx_activate_async(
+    OfonoConnCtx* context,
+    int timeout_msec,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data);
+
+gboolean
+ofono_connctx_activate_finish(
+    OfonoConnCtx* context,
+    GAsyncResult* result,
+    OfonoConnCtxActivateTiming* timing,
+    GError** error);
+
+/*
+ * Activations and deactivations of the contexts of the same modem are
+ * performed one at a time, those with higher priority first. Default
+ * priority is zero.
+ */
+void
+ofono_connctx_set_activation_priority(
+    OfonoConnCtx* context,
+    int priority);
+
 gboolean
 ofono_connctx_set_string(
     OfonoConnCtx* context,
@@ -297,6 +426,51 @@ ofono_connctx_provision_full(
     OfonoConnCtxCallHandler callback,
     void* arg);
 
+/*
+ * Transaction queues several property writes and issues them all at
+ * once. The handler is invoked when all of them have completed. The
+ * transaction is freed after that. Cancelling the cancellable returned
+ * by ofono_connctx_tx_commit() cancels all writes. A transaction that
+ * has not been committed can be dropped with ofono_connctx_tx_free().
+ * If ofono_connctx_tx_commit() fails, it frees the transaction and
+ * returns NULL.
+ */
+
+OfonoConnCtxTx*
+ofono_connctx_tx_new(
+    OfonoConnCtx* context);
+
+void
+ofono_connctx_tx_free(
+    OfonoConnCtxTx* tx);
+
+gboolean
+ofono_connctx_tx_set_string(
+    OfonoConnCtxTx* tx,
+    const char* name,
+    const char* value);
+
+gboolean
+ofono_connctx_tx_set_type(
+    OfonoConnCtxTx* tx,
+    OFONO_CONNCTX_TYPE type);
+
+gboolean
+ofono_connctx_tx_set_protocol(
+    OfonoConnCtxTx* tx,
+    OFONO_CONNCTX_PROTOCOL protocol);
+
+gboolean
+ofono_connctx_tx_set_auth(
+    OfonoConnCtxTx* tx,
+    OFONO_CONNCTX_AUTH auth);
+
+GCancellable*
+ofono_connctx_tx_commit(
+    OfonoConnCtxTx* tx,
+    OfonoConnCtxTxHandler handler,
+    void* arg);
+
 /* Inline wrappers */
 
 OFONO_INLINE OfonoObject*
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_CONNCTX_NETLINK_H
+#define GOFONO_CONNCTX_NETLINK_H
+
+#include "gofono_connctx.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Optional companion which programs the interface of a connection context
+ * over rtnetlink, instead of running ip(8) or similar tools. It follows
+ * Settings and IPv6.Settings, compares the parsed configuration with what
+ * it has applied before and only sends the difference. Everything it has
+ * added is removed when the context gets deactivated, the interface goes
+ * away or the companion is freed. Requires CAP_NET_ADMIN.
+ */
+
+typedef struct ofono_connctx_netlink OfonoConnCtxNetlink;
+
+typedef enum ofono_connctx_netlink_flags {
+    OFONO_CONNCTX_NETLINK_ADDRESS = 0x01,       /* Interface addresses */
+    OFONO_CONNCTX_NETLINK_ROUTE = 0x02,         /* Default routes */
+    OFONO_CONNCTX_NETLINK_LINK_UP = 0x04,       /* Bring the link up */
+    OFONO_CONNCTX_NETLINK_ALL = 0x07
+} OFONO_CONNCTX_NETLINK_FLAGS;
+
+/* Zero MTU leaves MTU alone, zero metric is the kernel default */
+OfonoConnCtxNetlink*
+ofono_connctx_netlink_new(
+    OfonoConnCtx* context,
+    OFONO_CONNCTX_NETLINK_FLAGS flags,
+    guint mtu,
+    guint metric);
+
+void
+ofono_connctx_netlink_free(
+    OfonoConnCtxNetlink* netlink);
+
+G_END_DECLS
+
+#endif /* GOFONO_CONNCTX_NETLINK_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
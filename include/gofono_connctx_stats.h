@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_CONNCTX_STATS_H
+#define GOFONO_CONNCTX_STATS_H
+
+#include "gofono_connctx.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Traffic counters of the network interfaces of connection contexts.
+ * The sampler reads the counters of all its contexts with a single
+ * rtnetlink dump per tick. Each context is only sampled while it's
+ * active and has an interface, the timer only runs while there's
+ * something to sample. Rates are per second, averaged over the last
+ * interval, and zero for the first sample after the interface changes.
+ */
+
+typedef struct ofono_connctx_stats_sampler OfonoConnCtxStatsSampler;
+
+typedef struct ofono_connctx_stats {
+    gint64 timestamp;                           /* Monotonic, microseconds */
+    guint64 rx_bytes;
+    guint64 tx_bytes;
+    guint64 rx_packets;
+    guint64 tx_packets;
+    guint64 rx_bytes_rate;
+    guint64 tx_bytes_rate;
+    guint64 rx_packets_rate;
+    guint64 tx_packets_rate;
+} OfonoConnCtxStats;
+
+/* The handler may remove items and even free the sampler */
+typedef
+void
+(*OfonoConnCtxStatsHandler)(
+    OfonoConnCtx* context,
+    const OfonoConnCtxStats* stats,
+    void* arg);
+
+OfonoConnCtxStatsSampler*
+ofono_connctx_stats_sampler_new(
+    guint interval_msec);
+
+void
+ofono_connctx_stats_sampler_free(
+    OfonoConnCtxStatsSampler* sampler);
+
+void
+ofono_connctx_stats_sampler_set_interval(
+    OfonoConnCtxStatsSampler* sampler,
+    guint interval_msec);
+
+gulong
+ofono_connctx_stats_sampler_add(
+    OfonoConnCtxStatsSampler* sampler,
+    OfonoConnCtx* context,
+    OfonoConnCtxStatsHandler handler,
+    void* arg);
+
+void
+ofono_connctx_stats_sampler_remove(
+    OfonoConnCtxStatsSampler* sampler,
+    gulong id);
+
+/* The last sample, FALSE if there's none */
+gboolean
+ofono_connctx_stats_sampler_get(
+    OfonoConnCtxStatsSampler* sampler,
+    gulong id,
+    OfonoConnCtxStats* stats);
+
+G_END_DECLS
+
+#endif /* GOFONO_CONNCTX_STATS_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
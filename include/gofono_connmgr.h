@@ -34,6 +34,7 @@
 #define GOFONO_CONNMGR_H
 
 #include "gofono_modemintf.h"
+#include "gofono_connctx.h"
 
 G_BEGIN_DECLS
 
@@ -80,6 +81,17 @@ void
     GVariant* value,
     void* arg);
 
+/* NULL strings, UNKNOWN protocol and UNKNOWN auth keep oFono defaults */
+typedef struct ofono_connmgr_context_config {
+    OFONO_CONNCTX_TYPE type;            /* Type */
+    const char* name;                   /* Name */
+    const char* apn;                    /* AccessPointName */
+    const char* username;               /* Username */
+    const char* password;               /* Password */
+    OFONO_CONNCTX_PROTOCOL protocol;    /* Protocol */
+    OFONO_CONNCTX_AUTH auth;            /* AuthenticationMethod */
+} OfonoConnMgrContextConfig;
+
 OfonoConnMgr*
 ofono_connmgr_new(
     const char* path);
@@ -106,6 +118,99 @@ ofono_connmgr_get_context_for_path(
     OfonoConnMgr* mgr,
     const char* path);
 
+OfonoConnCtx*
+ofono_connmgr_get_context_for_apn(
+    OfonoConnMgr* mgr,
+    const char* apn);
+
+/*
+ * Creates the contexts and writes their properties. All AddContext calls
+ * are issued at once, each context gets configured as soon as it becomes
+ * valid. Completes with the array of valid OfonoConnCtx objects in the
+ * order of the configs. If anything fails (including a new context being
+ * removed or not becoming valid within a minute), the contexts which have
+ * been created are removed. That includes cancellation, in which case the
+ * task completes once the outstanding AddContext calls have finished and
+ * their contexts are gone.
+ */
+void
+ofono_connmgr_add_contexts_async(
+    OfonoConnMgr* mgr,
+    const OfonoConnMgrContextConfig* configs,
+    guint count,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data);
+
+GPtrArray*
+ofono_connmgr_add_contexts_finish(
+    OfonoConnMgr* mgr,
+    GAsyncResult* result,
+    GError** error);
+
+void
+ofono_connmgr_add_context_async(
+    OfonoConnMgr* mgr,
+    OFONO_CONNCTX_TYPE type,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data);
+
+/* Returns a new reference to the valid context */
+OfonoConnCtx*
+ofono_connmgr_add_context_finish(
+    OfonoConnMgr* mgr,
+    GAsyncResult* result,
+    GError** error);
+
+void
+ofono_connmgr_remove_context_async(
+    OfonoConnMgr* mgr,
+    const char* path,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data);
+
+gboolean
+ofono_connmgr_remove_context_finish(
+    OfonoConnMgr* mgr,
+    GAsyncResult* result,
+    GError** error);
+
+void
+ofono_connmgr_deactivate_all_async(
+    OfonoConnMgr* mgr,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data);
+
+gboolean
+ofono_connmgr_deactivate_all_finish(
+    OfonoConnMgr* mgr,
+    GAsyncResult* result,
+    GError** error);
+
+/*
+ * Provisions all valid contexts, running up to max_calls ProvisionContext
+ * calls at a time (zero selects the default limit). Property change
+ * signals of the contexts are held until all calls have completed. The
+ * error is the first one that occurred, prefixed with the number of
+ * contexts that failed.
+ */
+void
+ofono_connmgr_provision_all(
+    OfonoConnMgr* mgr,
+    guint max_calls,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data);
+
+gboolean
+ofono_connmgr_provision_all_finish(
+    OfonoConnMgr* mgr,
+    GAsyncResult* result,
+    GError** error);
+
 gulong
 ofono_connmgr_add_valid_changed_handler(
     OfonoConnMgr* mgr,
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_CONTEXT_H
+#define GOFONO_CONTEXT_H
+
+#include "gofono_types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Library context owns the D-Bus connection, the object registries,
+ * the idle pool and the manager. Objects belong to the context which
+ * was the thread default one when they were created. Unless another
+ * context is pushed, everything happens in the default context.
+ *
+ * Independent contexts may run on different threads, each thread
+ * keeping its context pushed while it's using the library.
+ */
+
+OfonoContext*
+ofono_context_new(void);
+
+OfonoContext*
+ofono_context_ref(
+    OfonoContext* context);
+
+void
+ofono_context_unref(
+    OfonoContext* context);
+
+OfonoContext*
+ofono_context_default(void);
+
+OfonoContext*
+ofono_context_get_thread_default(void);
+
+void
+ofono_context_push_thread_default(
+    OfonoContext* context);
+
+void
+ofono_context_pop_thread_default(
+    OfonoContext* context);
+
+/*
+ * By default, the context asynchronously connects to the bus defined by
+ * OFONO_BUS_TYPE when the first object needs it. A pre-opened connection
+ * (e.g. a private or peer-to-peer one) can be injected instead, or another
+ * bus type selected. Either should be done before any objects are created
+ * in this context, objects which already have the connection keep using it.
+ *
+ * With a peer-to-peer connection there's no bus daemon to watch oFono name,
+ * the peer is assumed to be oFono and to be always present.
+ *
+ * ofono_context_get_bus() returns NULL until the connection is available,
+ * doesn't add a reference.
+ */
+
+void
+ofono_context_set_bus(
+    OfonoContext* context,
+    GDBusConnection* bus);
+
+void
+ofono_context_set_bus_type(
+    OfonoContext* context,
+    GBusType type);
+
+GDBusConnection*
+ofono_context_get_bus(
+    OfonoContext* context);
+
+/*
+ * Integration with external (e.g. epoll based) event loops, which drive
+ * the context's GMainContext (see ofono_main_context_set) without running
+ * a GLib main loop. Each iteration goes like this:
+ *
+ * 1. ofono_context_loop_prepare() fills the poll descriptors and returns
+ *    their number, which may exceed n_fds. In that case nothing has been
+ *    prepared and it needs to be called again with a larger array. The
+ *    timeout is in milliseconds, -1 meaning no timeout.
+ * 2. The external loop waits for those descriptors or the timeout and
+ *    updates revents.
+ * 3. ofono_context_loop_dispatch() invokes whatever is ready, including
+ *    library callbacks, from the calling thread. Returns TRUE if anything
+ *    has been dispatched.
+ *
+ * The GMainContext is owned by the calling thread between the two calls,
+ * both must be made by the same thread. Repeating the prepare call before
+ * dispatch is allowed and doesn't acquire the GMainContext again.
+ */
+
+int
+ofono_context_loop_prepare(
+    OfonoContext* context,
+    GPollFD* fds,
+    int n_fds,
+    int* timeout);
+
+gboolean
+ofono_context_loop_dispatch(
+    OfonoContext* context,
+    GPollFD* fds,
+    int n_fds);
+
+G_END_DECLS
+
+#endif /* GOFONO_CONTEXT_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
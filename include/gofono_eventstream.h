@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_EVENTSTREAM_H
+#define GOFONO_EVENTSTREAM_H
+
+#include "gofono_snapshot.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Event stream delivers ordered change events to a thread which doesn't
+ * run a GLib main loop. The stream is created and freed on the library
+ * thread, events are taken out of it by a single consumer thread which
+ * may poll the file descriptor returned by ofono_event_stream_fd().
+ *
+ * Events don't copy anything. The path and property name are interned
+ * strings, the snapshot (if any) is a reference to the state published
+ * right before the event, which must be released with ofono_event_clear().
+ */
+
+typedef struct ofono_event_stream OfonoEventStream;
+
+typedef enum ofono_event_type {
+    OFONO_EVENT_PROPERTY_CHANGED,       /* name is the property name */
+    OFONO_EVENT_VALID_CHANGED,
+    OFONO_EVENT_MODEM_ADDED,
+    OFONO_EVENT_MODEM_REMOVED,
+    OFONO_EVENT_CONTEXT_ADDED,
+    OFONO_EVENT_CONTEXT_REMOVED
+} OFONO_EVENT_TYPE;
+
+/* What to do when the consumer falls behind */
+typedef enum ofono_event_stream_overflow {
+    OFONO_EVENT_STREAM_DROP_OLDEST,     /* Oldest events are dropped */
+    OFONO_EVENT_STREAM_COALESCE         /* Latest event per key is kept */
+} OFONO_EVENT_STREAM_OVERFLOW;
+
+typedef struct ofono_event {
+    OFONO_EVENT_TYPE type;
+    const char* path;
+    const char* name;
+    OfonoSnapshot* snapshot;
+} OfonoEvent;
+
+OfonoEventStream*
+ofono_event_stream_new(
+    guint capacity,
+    OFONO_EVENT_STREAM_OVERFLOW overflow);
+
+void
+ofono_event_stream_free(
+    OfonoEventStream* stream);
+
+int
+ofono_event_stream_fd(
+    OfonoEventStream* stream);
+
+gboolean
+ofono_event_stream_pop(
+    OfonoEventStream* stream,
+    OfonoEvent* event);
+
+guint
+ofono_event_stream_dropped(
+    OfonoEventStream* stream);
+
+void
+ofono_event_clear(
+    OfonoEvent* event);
+
+G_END_DECLS
+
+#endif /* GOFONO_EVENTSTREAM_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -56,6 +56,23 @@ struct ofono_modem {
     const char* type;                   /* Type */
 };
 
+/* Immutable copy of the above, see gofono_snapshot.h */
+typedef struct ofono_modem_snapshot {
+    OfonoSnapshot snapshot;
+    gboolean powered;
+    gboolean online;
+    gboolean lockdown;
+    gboolean emergency;
+    const char* name;
+    const char* manufacturer;
+    const char* model;
+    const char* revision;
+    const char* serial;
+    char* const* features;
+    char* const* interfaces;
+    const char* type;
+} OfonoModemSnapshot;
+
 GType ofono_modem_get_type(void);
 #define OFONO_TYPE_MODEM (ofono_modem_get_type())
 #define OFONO_MODEM(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
@@ -178,6 +195,14 @@ ofono_modem_set_online_full(
     OfonoModemCallHandler callback,
     void* arg);
 
+void
+ofono_modem_cancel_calls(
+    OfonoModem* modem);
+
+OfonoModemSnapshot*
+ofono_modem_snapshot(
+    OfonoModem* modem);
+
 /* Inline wrappers */
 
 OFONO_INLINE OfonoObject*
@@ -124,6 +124,13 @@
 #define OFONO_NETREG_PROPERTY_NAME                "Name"
 #define OFONO_NETREG_PROPERTY_STRENGTH            "Strength"
 
+/* org.ofono.NetworkOperator */
+#define OFONO_OPERATOR_PROPERTY_NAME              "Name"
+#define OFONO_OPERATOR_PROPERTY_STATUS            "Status"
+#define OFONO_OPERATOR_PROPERTY_MCC               "MobileCountryCode"
+#define OFONO_OPERATOR_PROPERTY_MNC               "MobileNetworkCode"
+#define OFONO_OPERATOR_PROPERTY_TECHNOLOGIES      "Technologies"
+
 #endif /* GOFONO_NAMES_H */
 
 /*
@@ -67,6 +67,26 @@ typedef enum ofono_netreg_tech {
     OFONO_NETREG_TECH_LTE,              /* lte */
 } OFONO_NETREG_TECH;
 
+#define OFONO_NETREG_TECH_BIT(tech) (1u << (tech))
+
+typedef enum ofono_netreg_operator_status {
+    OFONO_NETREG_OPERATOR_STATUS_UNKNOWN = -1,
+    OFONO_NETREG_OPERATOR_STATUS_NONE,
+    OFONO_NETREG_OPERATOR_STATUS_AVAILABLE,     /* available */
+    OFONO_NETREG_OPERATOR_STATUS_CURRENT,       /* current */
+    OFONO_NETREG_OPERATOR_STATUS_FORBIDDEN      /* forbidden */
+} OFONO_NETREG_OPERATOR_STATUS;
+
+/* Element of the operator list, see ofono_netreg_get_operators() */
+typedef struct ofono_netreg_operator {
+    const char* path;
+    const char* name;                   /* Name */
+    const char* mcc;                    /* MobileCountryCode */
+    const char* mnc;                    /* MobileNetworkCode */
+    OFONO_NETREG_OPERATOR_STATUS status;/* Status */
+    guint techs;                        /* Technologies (TECH_BIT mask) */
+} OfonoNetRegOperator;
+
 struct ofono_netreg {
     OfonoModemInterface intf;
     OfonoNetRegPriv* priv;
@@ -81,6 +101,20 @@ struct ofono_netreg {
     guint strength;                     /* Strength */
 };
 
+/* Immutable copy of the above, see gofono_snapshot.h */
+typedef struct ofono_netreg_snapshot {
+    OfonoSnapshot snapshot;
+    OFONO_NETREG_STATUS status;
+    OFONO_NETREG_MODE mode;
+    OFONO_NETREG_TECH tech;
+    const char* mcc;
+    const char* mnc;
+    const char* name;
+    guint cell;
+    guint areacode;
+    guint strength;
+} OfonoNetRegSnapshot;
+
 GType ofono_netreg_get_type(void);
 #define OFONO_TYPE_NETREG (ofono_netreg_get_type())
 #define OFONO_NETREG(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
@@ -100,6 +134,13 @@ void
     GVariant* value,
     void* arg);
 
+typedef
+void
+(*OfonoNetRegStrengthLevelHandler)(
+    OfonoNetReg* sender,
+    guint level,
+    void* arg);
+
 OfonoNetReg*
 ofono_netreg_new(
     const char* path);
@@ -112,6 +153,10 @@ void
 ofono_netreg_unref(
     OfonoNetReg* netreg);
 
+OfonoNetRegSnapshot*
+ofono_netreg_snapshot(
+    OfonoNetReg* netreg);
+
 const char*
 ofono_netreg_country(
     OfonoNetReg* netreg);
@@ -128,12 +173,68 @@ const char*
 ofono_netreg_tech_string(
     OFONO_NETREG_TECH tech);
 
+const char*
+ofono_netreg_operator_status_string(
+    OFONO_NETREG_OPERATOR_STATUS status);
+
+/*
+ * Operator lists are immutable arrays of const OfonoNetRegOperator
+ * pointers, shared by all callers. Release them with g_ptr_array_unref.
+ *
+ * The list is cached and kept up to date by OperatorsChanged signals.
+ * A cached list not older than max_age seconds is returned without any
+ * D-Bus calls, zero max_age forces a new call. Concurrent requests are
+ * served by the same call. Scan only accepts a cached list if it was
+ * produced by another Scan.
+ */
+#define OFONO_NETREG_OPERATORS_MAX_AGE_DEFAULT (60)
+
+GPtrArray*
+ofono_netreg_get_operators(
+    OfonoNetReg* netreg,
+    guint max_age);
+
+void
+ofono_netreg_get_operators_async(
+    OfonoNetReg* netreg,
+    guint max_age,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data);
+
+GPtrArray*
+ofono_netreg_get_operators_finish(
+    OfonoNetReg* netreg,
+    GAsyncResult* result,
+    GError** error);
+
+void
+ofono_netreg_scan_async(
+    OfonoNetReg* netreg,
+    guint max_age,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data);
+
+GPtrArray*
+ofono_netreg_scan_finish(
+    OfonoNetReg* netreg,
+    GAsyncResult* result,
+    GError** error);
+
 gulong
 ofono_netreg_add_valid_changed_handler(
     OfonoNetReg* netreg,
     OfonoNetRegHandler handler,
     void* arg);
 
+/* Emitted when the cached operator list changes */
+gulong
+ofono_netreg_add_operators_changed_handler(
+    OfonoNetReg* netreg,
+    OfonoNetRegHandler handler,
+    void* arg);
+
 /* Properties */
 
 gulong
@@ -197,6 +298,34 @@ ofono_netreg_add_strength_changed_handler(
     OfonoNetRegHandler handler,
     void* arg);
 
+/*
+ * Strength levels. Thresholds must be in ascending order, level N means
+ * that the strength has reached thresholds[N-1]. Dropping back to the
+ * lower level requires the strength to fall hysteresis points below
+ * the threshold. The handler is only invoked when the level changes, on
+ * the thread-default context of the registering thread (same as signal
+ * handlers, see gofono_util.h). Ids are removed with
+ * ofono_netreg_remove_strength_level_handler().
+ */
+gulong
+ofono_netreg_add_strength_level_handler(
+    OfonoNetReg* netreg,
+    const guint* thresholds,
+    guint count,
+    guint hysteresis,
+    OfonoNetRegStrengthLevelHandler handler,
+    void* arg);
+
+guint
+ofono_netreg_strength_level(
+    OfonoNetReg* netreg,
+    gulong id);
+
+void
+ofono_netreg_remove_strength_level_handler(
+    OfonoNetReg* netreg,
+    gulong id);
+
 void
 ofono_netreg_remove_handler(
     OfonoNetReg* netreg,
@@ -33,7 +33,8 @@
 #ifndef GOFONO_OBJECT_H
 #define GOFONO_OBJECT_H
 
-#include "gofono_types.h"
+#include "gofono_callgroup.h"
+#include "gofono_snapshot.h"
 
 G_BEGIN_DECLS
 
@@ -47,6 +48,19 @@ typedef struct ofono_object {
     gboolean valid;
 } OfonoObject;
 
+/*
+ * D-Bus call timeout (in milliseconds). The default one is inherited
+ * from the object, then from its class and eventually from GDBus.
+ */
+#define OFONO_CALL_TIMEOUT_DEFAULT  (-1)
+#define OFONO_CALL_TIMEOUT_INFINITE (G_MAXINT)
+
+typedef enum ofono_object_write_flags {
+    OFONO_OBJECT_WRITE_NONE     = 0x00,
+    OFONO_OBJECT_WRITE_COMBINE  = 0x01, /* Combine SetProperty calls */
+    OFONO_OBJECT_WRITE_OPTIMISTIC = 0x02 /* Apply values before confirmed */
+} OFONO_OBJECT_WRITE_FLAGS;
+
 typedef
 void
 (*OfonoObjectHandler)(
@@ -89,6 +103,15 @@ ofono_object_set_property(
     OfonoObjectCallFinishedCallback callback,
     void* arg);
 
+GCancellable*
+ofono_object_set_property_full(
+    OfonoObject* object,
+    const char* name,
+    GVariant* value,
+    int timeout_msec,
+    OfonoObjectCallFinishedCallback callback,
+    void* arg);
+
 GCancellable*
 ofono_object_set_string(
     OfonoObject* object,
@@ -126,6 +149,11 @@ ofono_object_get_boolean(
     const char* name,
     gboolean default_value);
 
+gboolean
+ofono_object_property_pending(
+    OfonoObject* object,
+    const char* name);
+
 GPtrArray*
 ofono_object_get_property_keys(
     OfonoObject* object);
@@ -160,6 +188,39 @@ ofono_object_remove_handlers(
     gulong* ids,
     unsigned int count);
 
+void
+ofono_object_class_set_call_timeout(
+    GType type,
+    int timeout_msec);
+
+void
+ofono_object_set_call_timeout(
+    OfonoObject* object,
+    int timeout_msec);
+
+void
+ofono_object_set_write_flags(
+    OfonoObject* object,
+    OFONO_OBJECT_WRITE_FLAGS flags);
+
+void
+ofono_object_set_call_group(
+    OfonoObject* object,
+    OfonoCallGroup* group);
+
+OfonoCallGroup*
+ofono_object_call_group(
+    OfonoObject* object);
+
+void
+ofono_object_cancel_calls(
+    OfonoObject* object);
+
+/* Thread safe, the caller must release the returned reference */
+OfonoSnapshot*
+ofono_object_snapshot(
+    OfonoObject* object);
+
 G_END_DECLS
 
 #endif /* GOFONO_OBJECT_H */
@@ -71,6 +71,17 @@ struct ofono_simmgr {
     OFONO_SIMMGR_PIN  pin_required;     /* PinRequired */
 };
 
+/* Immutable copy of the above, see gofono_snapshot.h */
+typedef struct ofono_simmgr_snapshot {
+    OfonoSnapshot snapshot;
+    gboolean present;
+    const char* imsi;
+    const char* mcc;
+    const char* mnc;
+    const char* spn;
+    OFONO_SIMMGR_PIN pin_required;
+} OfonoSimMgrSnapshot;
+
 GType ofono_simmgr_get_type(void);
 #define OFONO_TYPE_SIMMGR (ofono_simmgr_get_type())
 #define OFONO_SIMMGR(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
@@ -102,6 +113,10 @@ void
 ofono_simmgr_unref(
     OfonoSimMgr* sim);
 
+OfonoSimMgrSnapshot*
+ofono_simmgr_snapshot(
+    OfonoSimMgr* sim);
+
 /* Methods */
 
 /* TODO: Make async */
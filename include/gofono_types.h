@@ -42,10 +42,12 @@ G_BEGIN_DECLS
 
 typedef struct ofono_connctx            OfonoConnCtx;
 typedef struct ofono_connmgr            OfonoConnMgr;
+typedef struct ofono_context            OfonoContext;
 typedef struct ofono_manager            OfonoManager;
 typedef struct ofono_modem              OfonoModem;
 typedef struct ofono_netreg             OfonoNetReg;
 typedef struct ofono_simmgr             OfonoSimMgr;
+typedef struct ofono_snapshot           OfonoSnapshot;
 
 typedef enum ofono_connctx_type {
     OFONO_CONNCTX_TYPE_UNKNOWN = -1,
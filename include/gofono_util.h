@@ -69,6 +69,40 @@ ofono_country_code(
 void
 ofono_idle_pool_drain(void);
 
+/*
+ * By default the library context (see gofono_context.h) runs on the
+ * global default GMainContext. A different one (e.g. the one of a
+ * dedicated worker thread) must be selected for the current library
+ * context before any other object is created in it. The library thread
+ * must have both contexts pushed as its thread-default ones, which is
+ * what ofono_main_context_invoke() does, and all library calls are made
+ * from that thread.
+ *
+ * Signal handlers registered from other threads are invoked on the
+ * thread-default context of the registering thread. The object passed
+ * to such a handler may be changing concurrently, the handler should
+ * only look at its immutable snapshot (e.g. ofono_modem_snapshot()) and
+ * must not keep the pointer. The reference held for the duration of
+ * the call is released on the library thread.
+ */
+
+typedef
+void
+(*OfonoInvokeFunc)(
+    void* arg);
+
+void
+ofono_main_context_set(
+    GMainContext* context);
+
+GMainContext*
+ofono_main_context(void);
+
+void
+ofono_main_context_invoke(
+    OfonoInvokeFunc fn,
+    void* arg);
+
 #endif /* GOFONO_UTIL_H */
 
 /*
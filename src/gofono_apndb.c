@@ -0,0 +1,608 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_apndb.h"
+#include "gofono_log.h"
+
+#include <string.h>
+
+/*
+ * File layout (all numbers are 32-bit little-endian):
+ *
+ *   header
+ *   buckets[nbuckets]      operator index + 1, zero if the bucket is empty
+ *   operators[nops]
+ *   apns[napns]
+ *   strings[strings_size]  NUL-terminated, offset zero is the empty string
+ *
+ * The number of buckets is a power of two, collisions are resolved by
+ * linear probing. Operator key combines MCC and MNC, two and three digit
+ * MNCs are different ("01" is not "001"). Each MCC/MNC has a record
+ * without SPN (containing APNs of all providers) and one record per
+ * named provider.
+ */
+
+#define APNDB_MAGIC "GOAPNDB"
+#define APNDB_VERSION (1)
+
+typedef struct ofono_apndb_header {
+    char magic[8];
+    guint32 version;
+    guint32 nbuckets;
+    guint32 nops;
+    guint32 napns;
+    guint32 strings_size;
+    guint32 reserved;
+} OfonoApnDbHeader;
+
+typedef struct ofono_apndb_operator {
+    guint32 key;
+    guint32 spn;                /* String offset, zero if none */
+    guint32 first_apn;
+    guint32 napns;
+} OfonoApnDbOperator;
+
+typedef struct ofono_apndb_record {
+    guint32 provider;
+    guint32 apn;
+    guint32 name;
+    guint32 username;
+    guint32 password;
+    guint32 mms_center;
+    guint32 mms_proxy;
+    guint8 type;                /* OFONO_CONNCTX_TYPE + 1 */
+    guint8 auth;                /* OFONO_CONNCTX_AUTH + 1 */
+    guint8 reserved[2];
+} OfonoApnDbRecord;
+
+G_STATIC_ASSERT(sizeof(OfonoApnDbHeader) == 32);
+G_STATIC_ASSERT(sizeof(OfonoApnDbOperator) == 16);
+G_STATIC_ASSERT(sizeof(OfonoApnDbRecord) == 32);
+
+struct ofono_apndb {
+    gint ref_count;
+    GMappedFile* file;
+    guint32 mask;
+    guint32 nops;
+    guint32 napns;
+    guint32 strings_size;
+    const guint32* buckets;
+    const OfonoApnDbOperator* ops;
+    const OfonoApnDbRecord* apns;
+    const char* strings;
+};
+
+typedef struct ofono_apndb_builder_op {
+    guint32 key;
+    char* spn;
+    gboolean primary;
+    GPtrArray* apns;
+} OfonoApnDbBuilderOp;
+
+struct ofono_apndb_builder {
+    GHashTable* op_table;       /* "key/spn" => OfonoApnDbBuilderOp */
+    GPtrArray* ops;             /* In the order of addition */
+};
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+/* Returns zero if MCC or MNC is invalid */
+static
+guint32
+ofono_apndb_key(
+    const char* mcc,
+    const char* mnc)
+{
+    if (mcc && mnc && strlen(mcc) == 3) {
+        const gsize mnc_len = strlen(mnc);
+        if (mnc_len == 2 || mnc_len == 3) {
+            guint32 mcc_val = 0, mnc_val = 0;
+            guint i;
+
+            for (i = 0; i < 3; i++) {
+                if (!g_ascii_isdigit(mcc[i])) return 0;
+                mcc_val = mcc_val * 10 + (mcc[i] - '0');
+            }
+            for (i = 0; i < mnc_len; i++) {
+                if (!g_ascii_isdigit(mnc[i])) return 0;
+                mnc_val = mnc_val * 10 + (mnc[i] - '0');
+            }
+            return mcc_val * 4000 + mnc_len * 1000 + mnc_val;
+        }
+    }
+    return 0;
+}
+
+/* FNV-1a */
+static
+guint32
+ofono_apndb_hash(
+    guint32 key,
+    const char* spn)
+{
+    guint32 h = 2166136261u;
+    guint i;
+
+    for (i = 0; i < 4; i++) {
+        h = (h ^ ((key >> (8 * i)) & 0xff)) * 16777619u;
+    }
+    if (spn) {
+        const guchar* ptr;
+        for (ptr = (const guchar*)spn; *ptr; ptr++) {
+            h = (h ^ *ptr) * 16777619u;
+        }
+    }
+    return h;
+}
+
+static
+const char*
+ofono_apndb_string(
+    OfonoApnDb* self,
+    guint32 le_offset)
+{
+    const guint32 offset = GUINT32_FROM_LE(le_offset);
+    return (offset && offset < self->strings_size) ?
+        (self->strings + offset) : NULL;
+}
+
+static
+const OfonoApnDbOperator*
+ofono_apndb_find(
+    OfonoApnDb* self,
+    guint32 key,
+    const char* spn)
+{
+    guint32 i = ofono_apndb_hash(key, spn) & self->mask;
+    guint32 n;
+
+    for (n = 0; n <= self->mask; n++, i = (i + 1) & self->mask) {
+        const guint32 index = GUINT32_FROM_LE(self->buckets[i]);
+        const OfonoApnDbOperator* op;
+        const char* op_spn;
+
+        if (!index || index > self->nops) {
+            /* Empty bucket (or a broken one) terminates the search */
+            break;
+        }
+        op = self->ops + (index - 1);
+        op_spn = ofono_apndb_string(self, op->spn);
+        if (GUINT32_FROM_LE(op->key) == key && !g_strcmp0(op_spn, spn)) {
+            return op;
+        }
+    }
+    return NULL;
+}
+
+static
+void
+ofono_apndb_builder_op_free(
+    gpointer data)
+{
+    OfonoApnDbBuilderOp* op = data;
+    g_ptr_array_free(op->apns, TRUE);
+    g_free(op->spn);
+    g_slice_free(OfonoApnDbBuilderOp, op);
+}
+
+static
+void
+ofono_apndb_builder_apn_free(
+    gpointer data)
+{
+    OfonoApnDbApn* apn = data;
+    g_free((char*)apn->provider);
+    g_free((char*)apn->apn);
+    g_free((char*)apn->name);
+    g_free((char*)apn->username);
+    g_free((char*)apn->password);
+    g_free((char*)apn->mms_center);
+    g_free((char*)apn->mms_proxy);
+    g_slice_free(OfonoApnDbApn, apn);
+}
+
+static
+guint32
+ofono_apndb_builder_string(
+    GHashTable* offsets,
+    GByteArray* strings,
+    const char* str)
+{
+    guint32 offset = 0;
+    if (str && str[0]) {
+        gpointer value;
+        if (g_hash_table_lookup_extended(offsets, str, NULL, &value)) {
+            offset = GPOINTER_TO_UINT(value);
+        } else {
+            offset = strings->len;
+            g_byte_array_append(strings, (const guint8*)str, strlen(str) + 1);
+            g_hash_table_insert(offsets, (gpointer)str,
+                GUINT_TO_POINTER(offset));
+        }
+    }
+    return GUINT32_TO_LE(offset);
+}
+
+static
+void
+ofono_apndb_builder_append_apns(
+    GArray* records,
+    GHashTable* offsets,
+    GByteArray* strings,
+    GPtrArray* apns)
+{
+    guint i;
+    for (i = 0; i < apns->len; i++) {
+        const OfonoApnDbApn* apn = apns->pdata[i];
+        OfonoApnDbRecord rec;
+
+        memset(&rec, 0, sizeof(rec));
+        rec.provider = ofono_apndb_builder_string(offsets, strings,
+            apn->provider);
+        rec.apn = ofono_apndb_builder_string(offsets, strings, apn->apn);
+        rec.name = ofono_apndb_builder_string(offsets, strings, apn->name);
+        rec.username = ofono_apndb_builder_string(offsets, strings,
+            apn->username);
+        rec.password = ofono_apndb_builder_string(offsets, strings,
+            apn->password);
+        rec.mms_center = ofono_apndb_builder_string(offsets, strings,
+            apn->mms_center);
+        rec.mms_proxy = ofono_apndb_builder_string(offsets, strings,
+            apn->mms_proxy);
+        rec.type = (guint8)(apn->type + 1);
+        rec.auth = (guint8)(apn->auth + 1);
+        g_array_append_val(records, rec);
+    }
+}
+
+static
+void
+ofono_apndb_builder_append_op(
+    GArray* ops,
+    GArray* records,
+    guint32 key,
+    guint32 spn,
+    guint first_apn)
+{
+    OfonoApnDbOperator op;
+    op.key = GUINT32_TO_LE(key);
+    op.spn = spn;
+    op.first_apn = GUINT32_TO_LE(first_apn);
+    op.napns = GUINT32_TO_LE(records->len - first_apn);
+    g_array_append_val(ops, op);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+OfonoApnDb*
+ofono_apndb_open(
+    const char* path,
+    GError** error)
+{
+    GMappedFile* file = g_mapped_file_new(path, FALSE, error);
+    if (file) {
+        const gsize size = g_mapped_file_get_length(file);
+        const char* data = g_mapped_file_get_contents(file);
+        const OfonoApnDbHeader* hdr = (const OfonoApnDbHeader*)data;
+
+        if (size >= sizeof(*hdr) &&
+            !memcmp(hdr->magic, APNDB_MAGIC, sizeof(hdr->magic)) &&
+            GUINT32_FROM_LE(hdr->version) == APNDB_VERSION) {
+            const guint64 nbuckets = GUINT32_FROM_LE(hdr->nbuckets);
+            const guint64 nops = GUINT32_FROM_LE(hdr->nops);
+            const guint64 napns = GUINT32_FROM_LE(hdr->napns);
+            const guint64 strings_size = GUINT32_FROM_LE(hdr->strings_size);
+            const guint64 expected = sizeof(*hdr) +
+                nbuckets * sizeof(guint32) +
+                nops * sizeof(OfonoApnDbOperator) +
+                napns * sizeof(OfonoApnDbRecord) + strings_size;
+
+            if (nbuckets && !(nbuckets & (nbuckets - 1)) &&
+                expected == size && strings_size &&
+                !data[size - 1]) {
+                OfonoApnDb* self = g_slice_new0(OfonoApnDb);
+                const char* ptr = data + sizeof(*hdr);
+
+                self->ref_count = 1;
+                self->file = file;
+                self->mask = (guint32)(nbuckets - 1);
+                self->nops = (guint32)nops;
+                self->napns = (guint32)napns;
+                self->strings_size = (guint32)strings_size;
+                self->buckets = (const guint32*)ptr;
+                ptr += nbuckets * sizeof(guint32);
+                self->ops = (const OfonoApnDbOperator*)ptr;
+                ptr += nops * sizeof(OfonoApnDbOperator);
+                self->apns = (const OfonoApnDbRecord*)ptr;
+                ptr += napns * sizeof(OfonoApnDbRecord);
+                self->strings = ptr;
+                GDEBUG("%s: %u operator(s), %u APN(s)", path, self->nops,
+                    self->napns);
+                return self;
+            }
+        }
+        GWARN("%s: not a valid APN database", path);
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+            "%s is not a valid APN database", path);
+        g_mapped_file_unref(file);
+    }
+    return NULL;
+}
+
+OfonoApnDb*
+ofono_apndb_ref(
+    OfonoApnDb* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        g_atomic_int_inc(&self->ref_count);
+    }
+    return self;
+}
+
+void
+ofono_apndb_unref(
+    OfonoApnDb* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&self->ref_count)) {
+            g_mapped_file_unref(self->file);
+            g_slice_free(OfonoApnDb, self);
+        }
+    }
+}
+
+guint
+ofono_apndb_lookup(
+    OfonoApnDb* self,
+    const char* mcc,
+    const char* mnc,
+    const char* spn,
+    OfonoApnDbApn* apns,
+    guint max)
+{
+    const guint32 key = ofono_apndb_key(mcc, mnc);
+    if (G_LIKELY(self) && key) {
+        const OfonoApnDbOperator* op = NULL;
+
+        if (spn && spn[0]) {
+            op = ofono_apndb_find(self, key, spn);
+        }
+        if (!op) {
+            op = ofono_apndb_find(self, key, NULL);
+        }
+        if (op) {
+            const guint32 first = GUINT32_FROM_LE(op->first_apn);
+            const guint32 n = GUINT32_FROM_LE(op->napns);
+
+            if (first <= self->napns && n <= self->napns - first) {
+                guint i;
+
+                for (i = 0; i < n && i < max; i++) {
+                    const OfonoApnDbRecord* rec = self->apns + first + i;
+                    OfonoApnDbApn* apn = apns + i;
+
+                    apn->provider = ofono_apndb_string(self, rec->provider);
+                    apn->apn = ofono_apndb_string(self, rec->apn);
+                    apn->name = ofono_apndb_string(self, rec->name);
+                    apn->username = ofono_apndb_string(self, rec->username);
+                    apn->password = ofono_apndb_string(self, rec->password);
+                    apn->mms_center = ofono_apndb_string(self,
+                        rec->mms_center);
+                    apn->mms_proxy = ofono_apndb_string(self, rec->mms_proxy);
+                    apn->type = (OFONO_CONNCTX_TYPE)(rec->type - 1);
+                    apn->auth = (OFONO_CONNCTX_AUTH)(rec->auth - 1);
+                }
+                return n;
+            }
+        }
+    }
+    return 0;
+}
+
+OfonoApnDbBuilder*
+ofono_apndb_builder_new(
+    void)
+{
+    OfonoApnDbBuilder* self = g_slice_new0(OfonoApnDbBuilder);
+    self->op_table = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, NULL);
+    self->ops = g_ptr_array_new_with_free_func(ofono_apndb_builder_op_free);
+    return self;
+}
+
+void
+ofono_apndb_builder_free(
+    OfonoApnDbBuilder* self)
+{
+    if (G_LIKELY(self)) {
+        g_hash_table_destroy(self->op_table);
+        g_ptr_array_free(self->ops, TRUE);
+        g_slice_free(OfonoApnDbBuilder, self);
+    }
+}
+
+gboolean
+ofono_apndb_builder_add(
+    OfonoApnDbBuilder* self,
+    const char* mcc,
+    const char* mnc,
+    gboolean primary,
+    const OfonoApnDbApn* apn)
+{
+    const guint32 key = ofono_apndb_key(mcc, mnc);
+    if (G_LIKELY(self) && G_LIKELY(apn) && apn->apn && key) {
+        const char* spn = (apn->provider && apn->provider[0]) ?
+            apn->provider : NULL;
+        char* id = g_strdup_printf("%u/%s", key, spn ? spn : "");
+        OfonoApnDbBuilderOp* op = g_hash_table_lookup(self->op_table, id);
+        OfonoApnDbApn* copy = g_slice_new0(OfonoApnDbApn);
+
+        if (op) {
+            g_free(id);
+        } else {
+            op = g_slice_new0(OfonoApnDbBuilderOp);
+            op->key = key;
+            op->spn = g_strdup(spn);
+            op->apns = g_ptr_array_new_with_free_func
+                (ofono_apndb_builder_apn_free);
+            g_hash_table_insert(self->op_table, id, op);
+            g_ptr_array_add(self->ops, op);
+        }
+        if (primary) {
+            op->primary = TRUE;
+        }
+        copy->provider = g_strdup(spn);
+        copy->apn = g_strdup(apn->apn);
+        copy->name = g_strdup(apn->name);
+        copy->username = g_strdup(apn->username);
+        copy->password = g_strdup(apn->password);
+        copy->mms_center = g_strdup(apn->mms_center);
+        copy->mms_proxy = g_strdup(apn->mms_proxy);
+        copy->type = apn->type;
+        copy->auth = apn->auth;
+        g_ptr_array_add(op->apns, copy);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+ofono_apndb_builder_write(
+    OfonoApnDbBuilder* self,
+    const char* path,
+    GError** error)
+{
+    GHashTable* offsets = g_hash_table_new(g_str_hash, g_str_equal);
+    GHashTable* done = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GByteArray* strings = g_byte_array_new();
+    GArray* ops = g_array_new(FALSE, FALSE, sizeof(OfonoApnDbOperator));
+    GArray* recs = g_array_new(FALSE, FALSE, sizeof(OfonoApnDbRecord));
+    GByteArray* out = g_byte_array_new();
+    OfonoApnDbHeader hdr;
+    guint32* buckets;
+    guint32 nbuckets = 1;
+    guint i, j, pass;
+    gboolean ok;
+
+    /* Offset zero is the empty string */
+    g_byte_array_append(strings, (const guint8*)"", 1);
+    for (i = 0; i < self->ops->len; i++) {
+        const OfonoApnDbBuilderOp* op = self->ops->pdata[i];
+        guint first;
+
+        /* Named providers get their own records */
+        if (op->spn) {
+            first = recs->len;
+            ofono_apndb_builder_append_apns(recs, offsets, strings, op->apns);
+            ofono_apndb_builder_append_op(ops, recs, op->key,
+                ofono_apndb_builder_string(offsets, strings, op->spn), first);
+        }
+
+        /* And all APNs for this MCC/MNC, primary providers first */
+        if (!g_hash_table_contains(done, GUINT_TO_POINTER(op->key))) {
+            g_hash_table_add(done, GUINT_TO_POINTER(op->key));
+            first = recs->len;
+            for (pass = 0; pass < 2; pass++) {
+                for (j = i; j < self->ops->len; j++) {
+                    const OfonoApnDbBuilderOp* other = self->ops->pdata[j];
+                    if (other->key == op->key &&
+                        other->primary == (pass == 0)) {
+                        ofono_apndb_builder_append_apns(recs, offsets,
+                            strings, other->apns);
+                    }
+                }
+            }
+            ofono_apndb_builder_append_op(ops, recs, op->key, 0, first);
+        }
+    }
+
+    /* Load factor is kept under 1/2 */
+    while (nbuckets < 2 * ops->len) {
+        nbuckets <<= 1;
+    }
+    buckets = g_new0(guint32, nbuckets);
+    for (i = 0; i < ops->len; i++) {
+        const OfonoApnDbOperator* op = &g_array_index(ops,
+            OfonoApnDbOperator, i);
+        const guint32 spn = GUINT32_FROM_LE(op->spn);
+        guint32 b = ofono_apndb_hash(GUINT32_FROM_LE(op->key), spn ?
+            (const char*)strings->data + spn : NULL) & (nbuckets - 1);
+
+        while (buckets[b]) {
+            b = (b + 1) & (nbuckets - 1);
+        }
+        buckets[b] = GUINT32_TO_LE(i + 1);
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, APNDB_MAGIC, sizeof(hdr.magic));
+    hdr.version = GUINT32_TO_LE(APNDB_VERSION);
+    hdr.nbuckets = GUINT32_TO_LE(nbuckets);
+    hdr.nops = GUINT32_TO_LE(ops->len);
+    hdr.napns = GUINT32_TO_LE(recs->len);
+    hdr.strings_size = GUINT32_TO_LE(strings->len);
+    g_byte_array_append(out, (const guint8*)&hdr, sizeof(hdr));
+    g_byte_array_append(out, (const guint8*)buckets,
+        nbuckets * sizeof(guint32));
+    g_byte_array_append(out, (const guint8*)ops->data,
+        ops->len * sizeof(OfonoApnDbOperator));
+    g_byte_array_append(out, (const guint8*)recs->data,
+        recs->len * sizeof(OfonoApnDbRecord));
+    g_byte_array_append(out, strings->data, strings->len);
+
+    GDEBUG("%s: %u operator(s), %u APN(s), %u bytes", path, ops->len,
+        recs->len, out->len);
+    ok = g_file_set_contents(path, (const char*)out->data, out->len, error);
+
+    g_free(buckets);
+    g_byte_array_free(out, TRUE);
+    g_array_free(recs, TRUE);
+    g_array_free(ops, TRUE);
+    g_byte_array_free(strings, TRUE);
+    g_hash_table_destroy(done);
+    g_hash_table_destroy(offsets);
+    return ok;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_callgroup_p.h"
+#include "gofono_log.h"
+
+struct ofono_call_group {
+    gint ref_count;
+    GHashTable* calls;
+};
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+void
+ofono_call_group_add(
+    OfonoCallGroup* self,
+    GCancellable* cancellable)
+{
+    if (G_LIKELY(self) && G_LIKELY(cancellable)) {
+        g_hash_table_add(self->calls, g_object_ref(cancellable));
+    }
+}
+
+void
+ofono_call_group_remove(
+    OfonoCallGroup* self,
+    GCancellable* cancellable)
+{
+    if (G_LIKELY(self) && G_LIKELY(cancellable)) {
+        g_hash_table_remove(self->calls, cancellable);
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+OfonoCallGroup*
+ofono_call_group_new()
+{
+    OfonoCallGroup* self = g_slice_new0(OfonoCallGroup);
+    self->ref_count = 1;
+    self->calls = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        g_object_unref, NULL);
+    return self;
+}
+
+OfonoCallGroup*
+ofono_call_group_ref(
+    OfonoCallGroup* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        g_atomic_int_inc(&self->ref_count);
+    }
+    return self;
+}
+
+void
+ofono_call_group_unref(
+    OfonoCallGroup* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&self->ref_count)) {
+            g_hash_table_destroy(self->calls);
+            g_slice_free(OfonoCallGroup, self);
+        }
+    }
+}
+
+void
+ofono_call_group_cancel(
+    OfonoCallGroup* self)
+{
+    if (G_LIKELY(self) && g_hash_table_size(self->calls)) {
+        /*
+         * Cancelling a call may result in other calls being added to
+         * or removed from the group, make a copy of the list first.
+         */
+        GList* calls = g_hash_table_get_keys(self->calls);
+        GList* l;
+        GDEBUG("Cancelling %u call(s)", g_list_length(calls));
+        g_list_foreach(calls, (GFunc)g_object_ref, NULL);
+        for (l = calls; l; l = l->next) {
+            g_cancellable_cancel(G_CANCELLABLE(l->data));
+        }
+        g_list_free_full(calls, g_object_unref);
+    }
+}
+
+guint
+ofono_call_group_count(
+    OfonoCallGroup* self)
+{
+    return G_LIKELY(self) ? g_hash_table_size(self->calls) : 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -35,22 +35,30 @@
 #include "gofono_modem.h"
 #include "gofono_error.h"
 #include "gofono_names.h"
-#include "gofono_util.h"
+#include "gofono_connmgr_watch_p.h"
+#include "gofono_context_p.h"
+#include "gofono_snapshot_p.h"
+#include "gofono_util_p.h"
 #include "gofono_log.h"
 
 #include <gutil_strv.h>
 #include <gutil_misc.h>
 
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <string.h>
+
 /* Generated headers */
 #define OFONO_OBJECT_PROXY OrgOfonoConnectionContext
 #include "org.ofono.ConnectionContext.h"
-#include "org.ofono.ConnectionManager.h"
 #include "gofono_object_p.h"
 
 /* Retry configuration */
-#define RETRY_DELAY_SEC (1)
 #define MAX_RETRY_COUNT (30)
 
+/* DNS lists up to this size are sorted on stack when compared */
+#define DNS_COMPARE_STACK_COUNT (8)
+
 /* Object definition */
 typedef struct ofono_connctx_settings_priv {
     OfonoConnCtxSettings pub;
@@ -59,6 +67,8 @@ typedef struct ofono_connctx_settings_priv {
     char* netmask;
     char* gateway;
     char** dns;
+    OfonoConnCtxAddr* dns_addr;
+    guint changed;              /* OFONO_CONNCTX_SETTINGS_CHANGED mask */
 } OfonoConnCtxSettingsPriv;
 
 enum modem_event {
@@ -67,12 +77,6 @@ enum modem_event {
     MODEM_EVENT_COUNT
 };
 
-enum connmgr_event {
-    CONNMGR_EVENT_CONTEXT_ADDED,
-    CONNMGR_EVENT_CONTEXT_REMOVED,
-    CONNMGR_EVENT_COUNT
-};
-
 typedef enum connctx_action {
     CONNCTX_ACTION_NONE,
     CONNCTX_ACTION_ACTIVATE,
@@ -82,8 +86,10 @@ typedef enum connctx_action {
 struct ofono_connctx_priv {
     CONNCTX_ACTION next_action;
     CONNCTX_ACTION current_action;
-    guint retry_id;
+    gboolean slot_wait;                 /* Waiting for the connmgr slot */
+    gint64 slot_start;
     guint retry_count;
+    int priority;
     char* ifname;
     char* apn;
     char* name;
@@ -95,11 +101,31 @@ struct ofono_connctx_priv {
     OfonoConnCtxSettingsPriv ipv6_settings;
     OfonoModem* modem;
     gulong modem_event_id[MODEM_EVENT_COUNT];
-    OrgOfonoConnectionManager* connmgr;
-    gulong connmgr_event_id[CONNMGR_EVENT_COUNT];
+    OfonoConnMgrWatch* connmgr;
     gboolean removed;
+    GSList* activate_ops;
 };
 
+enum activate_op_handler {
+    ACTIVATE_OP_HANDLER_ACTIVE,
+    ACTIVATE_OP_HANDLER_SETTINGS,
+    ACTIVATE_OP_HANDLER_IPV6_SETTINGS,
+    ACTIVATE_OP_HANDLER_FAILED,
+    ACTIVATE_OP_HANDLER_COUNT
+};
+
+/* ofono_connctx_activate_async() */
+typedef struct ofono_connctx_activate_op {
+    OfonoConnCtx* self;
+    GTask* task;
+    gint64 start;
+    gboolean was_active;
+    OfonoConnCtxActivateTiming timing;
+    gulong handler_id[ACTIVATE_OP_HANDLER_COUNT];
+    guint timeout_id;
+    guint cancel_id;
+} OfonoConnCtxActivateOp;
+
 typedef OfonoObjectClass OfonoConnCtxClass;
 G_DEFINE_TYPE(OfonoConnCtx, ofono_connctx, OFONO_TYPE_OBJECT)
 #define SUPER_CLASS ofono_connctx_parent_class
@@ -136,7 +162,25 @@ static guint ofono_connctx_signals[CONNCTX_SIGNAL_COUNT] = {0};
     g_signal_emit(self, ofono_connctx_signals[\
     CONNCTX_SIGNAL_##name##_CHANGED], 0)
 
-static GHashTable* ofono_connctx_table = NULL;
+
+/* Transaction */
+typedef struct ofono_connctx_tx_item {
+    OfonoConnCtxTx* tx;
+    char* name;
+    char* value;
+    GCancellable* cancellable;
+    GError* error;
+} OfonoConnCtxTxItem;
+
+struct ofono_connctx_tx {
+    OfonoConnCtx* context;
+    GPtrArray* items;
+    GCancellable* cancellable;
+    gulong cancel_id;
+    guint pending;
+    OfonoConnCtxTxHandler handler;
+    void* arg;
+};
 
 /* Enum <-> string mappings */
 static const OfonoNameIntPair ofono_connctx_type_values[] = {
@@ -195,9 +239,10 @@ ofono_connctx_perform_next_action(
     OfonoConnCtx* self);
 
 static
-gboolean
-ofono_connctx_set_active_retry(
-    gpointer user_data);
+void
+ofono_connctx_activate_op_fail_all(
+    OfonoConnCtx* self,
+    const GError* error);
 
 /*==========================================================================*
  * Implementation
@@ -230,95 +275,228 @@ ofono_connctx_settings_clear(
     g_free(settings->netmask);
     g_free(settings->gateway);
     g_strfreev(settings->dns);
+    g_free(settings->dns_addr);
     memset(settings, 0, sizeof(*settings));
     ofono_connctx_settings_init(settings);
 };
 
 static
 gboolean
-ofono_connctx_settings_decode(
-    OfonoConnCtxSettingsPriv* settings,
-    GVariant* dict)
+ofono_connctx_settings_update_string(
+    char** field,
+    const char** pub,
+    const char* value)
 {
-    GVariant* value;
-    const char* s;
-    guchar y;
-    gboolean empty = TRUE;
-
-    memset(settings, 0, sizeof(*settings));
-    ofono_connctx_settings_init(settings);
+    if (g_strcmp0(*field, value)) {
+        g_free(*field);
+        *pub = *field = g_strdup(value);
+        return TRUE;
+    }
+    return FALSE;
+}
 
-    if (!dict) {
+static
+gboolean
+ofono_connctx_settings_dns_equal(
+    char* const* dns,
+    GVariant* value)
+{
+    const guint n = value ? g_variant_n_children(value) : 0;
+    guint i;
+    if (gutil_strv_length((char**)dns) != n) {
         return FALSE;
     }
+    for (i = 0; i < n; i++) {
+        GVariant* string = g_variant_get_child_value(value, i);
+        const gboolean equal = !g_strcmp0(dns[i],
+            g_variant_get_string(string, NULL));
+        g_variant_unref(string);
+        if (!equal) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static
+void
+ofono_connctx_addr_parse(
+    OfonoConnCtxAddr* addr,
+    const char* str)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->family = AF_UNSPEC;
+    if (str) {
+        if (inet_pton(AF_INET, str, &addr->u.in) > 0) {
+            addr->family = AF_INET;
+        } else if (inet_pton(AF_INET6, str, &addr->u.in6) > 0) {
+            addr->family = AF_INET6;
+        } else {
+            GWARN("Invalid address %s", str);
+        }
+    }
+}
+
+static
+guint
+ofono_connctx_netmask_prefix(
+    const char* netmask)
+{
+    struct in_addr mask;
+    if (netmask && inet_pton(AF_INET, netmask, &mask) > 0) {
+        /* Count the leading ones */
+        guint32 bits = ntohl(mask.s_addr);
+        guint prefix = 0;
+        while (bits & 0x80000000) {
+            bits <<= 1;
+            prefix++;
+        }
+        return prefix;
+    }
+    return 0;
+}
 
-    /* Interface */
-    s = NULL;
-    if (g_variant_lookup(dict, OFONO_CONNCTX_SETTINGS_INTERFACE, "&s", &s) &&
-        s && s[0]) {
-        settings->pub.ifname = settings->ifname = g_strdup(s);
-        empty = FALSE;
-    }
-
-    /* Address */
-    s = NULL;
-    if (g_variant_lookup(dict, OFONO_CONNCTX_SETTINGS_ADDRESS, "&s", &s) &&
-        s && s[0]) {
-        settings->pub.address = settings->address = g_strdup(s);
-        empty = FALSE;
-    }
-
-    /* Netmask */
-    s = NULL;
-    if (g_variant_lookup(dict, OFONO_CONNCTX_SETTINGS_NETMASK, "&s", &s) &&
-        s && s[0]) {
-        settings->pub.netmask = settings->netmask = g_strdup(s);
-        empty = FALSE;
-    }
-
-    /* Gateway */
-    s = NULL;
-    if (g_variant_lookup(dict, OFONO_CONNCTX_SETTINGS_GATEWAY, "&s", &s) &&
-        s && s[0]) {
-        settings->pub.gateway = settings->gateway = g_strdup(s);
-        empty = FALSE;
-    }
-
-    /* Method */
-    s = NULL;
-    if (g_variant_lookup(dict, OFONO_CONNCTX_SETTINGS_METHOD, "&s", &s) &&
-        s && s[0]) {
-        settings->pub.method = ofono_name_to_int(&ofono_connctx_method_map, s);
-        empty = FALSE;
-    }
-
-    /* PrefixLength */
-    y = 0;
-    if (g_variant_lookup(dict, OFONO_CONNCTX_SETTINGS_PREFIX_LENGTH, "y", &y)) {
-        settings->pub.prefix = y;
-        empty = FALSE;
-    }
-
-    /* DomainNameServers */
-    value = g_variant_lookup_value(dict, OFONO_CONNCTX_SETTINGS_DNS,
-        G_VARIANT_TYPE_ARRAY);
-    if (value) {
-        const int n = g_variant_n_children(value);
-        if (n > 0) {
-            int i;
-            settings->pub.dns = settings->dns = g_new(char*, n+1);
-            for (i=0; i<n; i++) {
-                GVariant* string = g_variant_get_child_value(value, i);
-                settings->dns[i] = g_strdup(g_variant_get_string(string, NULL));
-                g_variant_unref(string);
+/* Only re-parses what's changed */
+static
+void
+ofono_connctx_settings_update_net(
+    OfonoConnCtxSettingsPriv* settings,
+    guint changed)
+{
+    OfonoConnCtxNetConfig* net = &settings->pub.net;
+    if (changed & OFONO_CONNCTX_SETTINGS_CHANGED_ADDRESS) {
+        ofono_connctx_addr_parse(&net->address, settings->address);
+    }
+    if (changed & OFONO_CONNCTX_SETTINGS_CHANGED_GATEWAY) {
+        ofono_connctx_addr_parse(&net->gateway, settings->gateway);
+    }
+    if (changed & (OFONO_CONNCTX_SETTINGS_CHANGED_PREFIX |
+        OFONO_CONNCTX_SETTINGS_CHANGED_NETMASK)) {
+        net->prefix = settings->pub.prefix ? settings->pub.prefix :
+            ofono_connctx_netmask_prefix(settings->netmask);
+    }
+    if (changed & OFONO_CONNCTX_SETTINGS_CHANGED_DNS) {
+        const guint n = gutil_strv_length(settings->dns);
+        guint i;
+        g_free(settings->dns_addr);
+        settings->dns_addr = n ? g_new(OfonoConnCtxAddr, n) : NULL;
+        for (i = 0; i < n; i++) {
+            ofono_connctx_addr_parse(settings->dns_addr + i,
+                settings->dns[i]);
+        }
+        net->dns = settings->dns_addr;
+        net->dns_count = n;
+    }
+}
+
+/*
+ * Updates the settings in a single pass over the a{sv} dictionary, only
+ * allocating memory for the fields that have changed. Returns the mask
+ * of changed fields. The strings are borrowed from the dictionary while
+ * it's being parsed.
+ */
+static
+guint
+ofono_connctx_settings_update(
+    OfonoConnCtxSettingsPriv* settings,
+    GVariant* dict,
+    gboolean* empty)
+{
+    const char* ifname = NULL;
+    const char* address = NULL;
+    const char* netmask = NULL;
+    const char* gateway = NULL;
+    OFONO_CONNCTX_METHOD method = OFONO_CONNCTX_METHOD_UNKNOWN;
+    guint prefix = 0;
+    GVariant* dns = NULL;
+    guint present = 0;
+    guint changed = 0;
+
+    if (dict && g_variant_is_of_type(dict, G_VARIANT_TYPE_VARDICT)) {
+        GVariantIter it;
+        GVariant* value;
+        const char* name;
+
+        g_variant_iter_init(&it, dict);
+        while (g_variant_iter_next(&it, "{&sv}", &name, &value)) {
+            if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING)) {
+                const char* s = g_variant_get_string(value, NULL);
+                if (!s[0]) {
+                    /* Empty string is the same as nothing */
+                } else if (!strcmp(name, OFONO_CONNCTX_SETTINGS_INTERFACE)) {
+                    ifname = s;
+                    present |= OFONO_CONNCTX_SETTINGS_CHANGED_IFNAME;
+                } else if (!strcmp(name, OFONO_CONNCTX_SETTINGS_ADDRESS)) {
+                    address = s;
+                    present |= OFONO_CONNCTX_SETTINGS_CHANGED_ADDRESS;
+                } else if (!strcmp(name, OFONO_CONNCTX_SETTINGS_NETMASK)) {
+                    netmask = s;
+                    present |= OFONO_CONNCTX_SETTINGS_CHANGED_NETMASK;
+                } else if (!strcmp(name, OFONO_CONNCTX_SETTINGS_GATEWAY)) {
+                    gateway = s;
+                    present |= OFONO_CONNCTX_SETTINGS_CHANGED_GATEWAY;
+                } else if (!strcmp(name, OFONO_CONNCTX_SETTINGS_METHOD)) {
+                    method = ofono_name_to_int(&ofono_connctx_method_map, s);
+                    present |= OFONO_CONNCTX_SETTINGS_CHANGED_METHOD;
+                }
+            } else if (g_variant_is_of_type(value, G_VARIANT_TYPE_BYTE)) {
+                if (!strcmp(name, OFONO_CONNCTX_SETTINGS_PREFIX_LENGTH)) {
+                    prefix = g_variant_get_byte(value);
+                    present |= OFONO_CONNCTX_SETTINGS_CHANGED_PREFIX;
+                }
+            } else if (g_variant_is_of_type(value,
+                G_VARIANT_TYPE_STRING_ARRAY)) {
+                if (!strcmp(name, OFONO_CONNCTX_SETTINGS_DNS) &&
+                    g_variant_n_children(value) > 0) {
+                    if (dns) g_variant_unref(dns);
+                    dns = g_variant_ref(value);
+                    present |= OFONO_CONNCTX_SETTINGS_CHANGED_DNS;
+                }
             }
-            settings->dns[i] = NULL;
-            empty = FALSE;
+
+            /* The dictionary keeps the data alive */
+            g_variant_unref(value);
         }
-        g_variant_unref(value);
     }
 
-    return !empty;
+    if (ofono_connctx_settings_update_string(&settings->ifname,
+        &settings->pub.ifname, ifname)) {
+        changed |= OFONO_CONNCTX_SETTINGS_CHANGED_IFNAME;
+    }
+    if (ofono_connctx_settings_update_string(&settings->address,
+        &settings->pub.address, address)) {
+        changed |= OFONO_CONNCTX_SETTINGS_CHANGED_ADDRESS;
+    }
+    if (ofono_connctx_settings_update_string(&settings->netmask,
+        &settings->pub.netmask, netmask)) {
+        changed |= OFONO_CONNCTX_SETTINGS_CHANGED_NETMASK;
+    }
+    if (ofono_connctx_settings_update_string(&settings->gateway,
+        &settings->pub.gateway, gateway)) {
+        changed |= OFONO_CONNCTX_SETTINGS_CHANGED_GATEWAY;
+    }
+    if (settings->pub.method != method) {
+        settings->pub.method = method;
+        changed |= OFONO_CONNCTX_SETTINGS_CHANGED_METHOD;
+    }
+    if (settings->pub.prefix != prefix) {
+        settings->pub.prefix = prefix;
+        changed |= OFONO_CONNCTX_SETTINGS_CHANGED_PREFIX;
+    }
+    if (!ofono_connctx_settings_dns_equal(settings->dns, dns)) {
+        g_strfreev(settings->dns);
+        settings->pub.dns = settings->dns = dns ?
+            g_variant_dup_strv(dns, NULL) : NULL;
+        changed |= OFONO_CONNCTX_SETTINGS_CHANGED_DNS;
+    }
+    if (dns) {
+        g_variant_unref(dns);
+    }
+
+    ofono_connctx_settings_update_net(settings, changed);
+    settings->changed = changed;
+    *empty = !present;
+    return changed;
 }
 
 static
@@ -330,16 +508,20 @@ ofono_connctx_set_active_done(
 {
     OfonoConnCtx* self = OFONO_CONNCTX(object);
     OfonoConnCtxPriv* priv = self->priv;
-    GASSERT(!priv->retry_id);
+    const gboolean busy = error && error->domain == OFONO_ERROR &&
+        error->code == OFONO_ERROR_BUSY;
+    GASSERT(!priv->slot_wait);
     GASSERT(priv->current_action != CONNCTX_ACTION_NONE);
+    ofono_connmgr_watch_release_slot(priv->connmgr, object->path, busy,
+        g_get_monotonic_time() - priv->slot_start);
     if (error) {
-        if (error->domain == OFONO_ERROR &&
-            error->code == OFONO_ERROR_BUSY &&
-            priv->retry_count < MAX_RETRY_COUNT) {
+        if (busy && priv->retry_count < MAX_RETRY_COUNT) {
+            /* The scheduler decides when to try again */
             priv->retry_count++;
-            GDEBUG("Retry %d in %d sec", priv->retry_count, RETRY_DELAY_SEC);
-            priv->retry_id = g_timeout_add_seconds(RETRY_DELAY_SEC,
-                ofono_connctx_set_active_retry, self);
+            GDEBUG("Retry %d", priv->retry_count);
+            priv->slot_wait = TRUE;
+            ofono_connmgr_watch_request_slot(priv->connmgr, object->path,
+                priv->priority);
         } else {
             GDEBUG("Giving up on %s", ofono_connctx_path(self));
             if (priv->current_action == CONNCTX_ACTION_ACTIVATE) {
@@ -353,27 +535,43 @@ ofono_connctx_set_active_done(
         }
     } else {
         /* Success */
+        if (priv->current_action == CONNCTX_ACTION_ACTIVATE) {
+            const gint64 now = g_get_monotonic_time();
+            GSList* l;
+            for (l = priv->activate_ops; l; l = l->next) {
+                OfonoConnCtxActivateOp* op = l->data;
+                if (!op->timing.call_reply) {
+                    op->timing.call_reply = now - op->start;
+                }
+            }
+        }
         priv->current_action = CONNCTX_ACTION_NONE;
     }
     ofono_connctx_perform_next_action(self);
 }
 
 static
-gboolean
-ofono_connctx_set_active_retry(
-    gpointer user_data)
+void
+ofono_connctx_set_active_start(
+    OfonoConnCtx* self)
 {
-    OfonoConnCtx* self = OFONO_CONNCTX(user_data);
+    OfonoObject* object = ofono_connctx_object(self);
     OfonoConnCtxPriv* priv = self->priv;
     const gboolean on = (priv->current_action == CONNCTX_ACTION_ACTIVATE);
     GASSERT(priv->current_action != CONNCTX_ACTION_NONE);
-    GASSERT(priv->retry_id);
-    priv->retry_id = 0;
-    GDEBUG("%sctivating %s again", on ? "A" : "Dea", ofono_connctx_path(self));
-    ofono_object_set_boolean(ofono_connctx_object(self),
-        OFONO_CONNCTX_PROPERTY_ACTIVE, on, ofono_connctx_set_active_done,
-        NULL);
-    return G_SOURCE_REMOVE;
+    GASSERT(priv->slot_wait);
+    priv->slot_wait = FALSE;
+    priv->slot_start = g_get_monotonic_time();
+    GDEBUG("%sctivating %s%s", on ? "A" : "Dea", object->path,
+        priv->retry_count ? " again" : "");
+    if (!ofono_object_set_boolean(object, OFONO_CONNCTX_PROPERTY_ACTIVE, on,
+        ofono_connctx_set_active_done, NULL)) {
+        /* No call has been made, release the slot and fail the action */
+        GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_FAILED,
+            "Failed to set " OFONO_CONNCTX_PROPERTY_ACTIVE);
+        ofono_connctx_set_active_done(object, error, NULL);
+        g_error_free(error);
+    }
 }
 
 static
@@ -387,22 +585,22 @@ ofono_connctx_perform_next_action(
         if (priv->current_action != CONNCTX_ACTION_NONE &&
             priv->next_action != CONNCTX_ACTION_NONE &&
             priv->next_action != priv->current_action &&
-            priv->retry_id) {
-            /* Cancel retry, start the next action */
-            priv->current_action = CONNCTX_ACTION_NONE;
-            g_source_remove(priv->retry_id);
-            priv->retry_id = 0;
+            priv->slot_wait) {
+            /* Nothing has been sent yet, replace the action */
+            priv->current_action = priv->next_action;
+            priv->next_action = CONNCTX_ACTION_NONE;
+            priv->retry_count = 0;
         }
         if (priv->current_action == CONNCTX_ACTION_NONE &&
             priv->next_action != CONNCTX_ACTION_NONE) {
-            const gboolean on = (priv->next_action == CONNCTX_ACTION_ACTIVATE);
-            GASSERT(!priv->retry_id);
+            /* Wait for our turn */
+            GASSERT(!priv->slot_wait);
             priv->retry_count = 0;
-            GDEBUG("%sctivating %s", on ? "A" : "Dea", object->path);
-            ofono_object_set_boolean(object, OFONO_CONNCTX_PROPERTY_ACTIVE, on,
-                ofono_connctx_set_active_done, self);
             priv->current_action = priv->next_action;
             priv->next_action = CONNCTX_ACTION_NONE;
+            priv->slot_wait = TRUE;
+            ofono_connmgr_watch_request_slot(priv->connmgr, object->path,
+                priv->priority);
         }
     }
 }
@@ -418,15 +616,16 @@ ofono_connctx_modem_changed(
 
 static
 void
-ofono_connctx_added(
-    OrgOfonoConnectionManager* proxy,
-    const char* path,
-    GVariant* properties,
-    OfonoConnCtx* self)
+ofono_connctx_connmgr_event(
+    OfonoConnMgrWatch* watch,
+    OFONO_CONNMGR_WATCH_EVENT event,
+    void* arg)
 {
-    if (!g_strcmp0(path, ofono_connctx_path(self))) {
-        OfonoConnCtxPriv* priv = self->priv;
-        GVERBOSE_("%s added", path);
+    OfonoConnCtx* self = OFONO_CONNCTX(arg);
+    OfonoConnCtxPriv* priv = self->priv;
+    switch (event) {
+    case OFONO_CONNMGR_WATCH_CONTEXT_ADDED:
+        GVERBOSE_("%s added", ofono_connctx_path(self));
         if (!priv->removed) {
             /*
              * If priv->removed is TRUE, then this object is already
@@ -437,49 +636,25 @@ ofono_connctx_added(
             ofono_connctx_update_ready(self);
         }
         priv->removed = FALSE;
-        ofono_connctx_update_ready(self);
-    }
-}
-
-static
-void
-ofono_connctx_removed(
-    OrgOfonoConnectionManager* proxy,
-    const char* path,
-    OfonoConnCtx* self)
-{
-    if (!g_strcmp0(path, ofono_connctx_path(self))) {
-        OfonoConnCtxPriv* priv = self->priv;
-        GVERBOSE_("%s removed", path);
+        break;
+    case OFONO_CONNMGR_WATCH_CONTEXT_REMOVED:
+        GVERBOSE_("%s removed", ofono_connctx_path(self));
         priv->removed = TRUE;
-        ofono_connctx_update_ready(self);
-    }
-}
-
-static
-void
-ofono_connctx_connection_manager_proxy_created(
-    GObject* source,
-    GAsyncResult* res,
-    gpointer data)
-{
-    OfonoConnCtx* self = OFONO_CONNCTX(data);
-    OfonoConnCtxPriv* priv = self->priv;
-    GError* err = NULL;
-    priv->connmgr = org_ofono_connection_manager_proxy_new_finish(res, &err);
-    if (priv->connmgr) {
-        priv->connmgr_event_id[CONNMGR_EVENT_CONTEXT_ADDED] =
-            g_signal_connect(priv->connmgr, "context-added",
-            G_CALLBACK(ofono_connctx_added), self);
-        priv->connmgr_event_id[CONNMGR_EVENT_CONTEXT_REMOVED] =
-            g_signal_connect(priv->connmgr, "context-removed",
-            G_CALLBACK(ofono_connctx_removed), self);
-        ofono_connctx_update_ready(self);
-    } else {
-        GERR("%s", GERRMSG(err));
+        if (priv->activate_ops) {
+            /* May have been invalid already, fail them right away */
+            GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_CLOSED,
+                "Context removed");
+            ofono_connctx_activate_op_fail_all(self, error);
+            g_error_free(error);
+        }
+        break;
+    case OFONO_CONNMGR_WATCH_READY:
+        break;
+    case OFONO_CONNMGR_WATCH_SLOT:
+        ofono_connctx_set_active_start(self);
+        return;
     }
-    if (err) g_error_free(err);
-    ofono_connctx_unref(self);
+    ofono_connctx_update_ready(self);
 }
 
 static
@@ -488,14 +663,15 @@ ofono_connctx_destroyed(
     gpointer key,
     GObject* ctx)
 {
-    GASSERT(ofono_connctx_table);
+    OfonoContext* context = ofono_context_of(ctx);
+    GASSERT(context->connctxs);
     GVERBOSE_("%s", (char*)key);
-    if (ofono_connctx_table) {
-        GASSERT(g_hash_table_lookup(ofono_connctx_table,key) == ctx);
-        g_hash_table_remove(ofono_connctx_table, key);
-        if (g_hash_table_size(ofono_connctx_table) == 0) {
-            g_hash_table_unref(ofono_connctx_table);
-            ofono_connctx_table = NULL;
+    if (context->connctxs) {
+        GASSERT(g_hash_table_lookup(context->connctxs, key) == ctx);
+        g_hash_table_remove(context->connctxs, key);
+        if (g_hash_table_size(context->connctxs) == 0) {
+            g_hash_table_unref(context->connctxs);
+            context->connctxs = NULL;
         }
     }
 }
@@ -516,6 +692,8 @@ ofono_connctx_create(
 
         /* Initialize modem */
         priv->modem = ofono_modem_new(modem_path);
+        ofono_object_set_call_group(object,
+            ofono_object_call_group(ofono_modem_object(priv->modem)));
         priv->modem_event_id[MODEM_EVENT_VALID] =
             ofono_modem_add_valid_changed_handler(priv->modem,
                 ofono_connctx_modem_changed, self);
@@ -523,11 +701,11 @@ ofono_connctx_create(
             ofono_modem_add_interfaces_changed_handler(priv->modem,
                 ofono_connctx_modem_changed, self);
 
-        /* Initialize ConnectionManager proxy */
-        org_ofono_connection_manager_proxy_new(ofono_object_bus(object),
-            G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES, OFONO_SERVICE,
-            modem_path, NULL, ofono_connctx_connection_manager_proxy_created,
-            ofono_connctx_ref(self));
+        /* ContextAdded/Removed watcher shared with other contexts */
+        priv->connmgr = ofono_connmgr_watch_new(ofono_context_of(self),
+            modem_path);
+        ofono_connmgr_watch_add(priv->connmgr, path,
+            ofono_connctx_connmgr_event, self);
 
         g_free(modem_path);
     }
@@ -535,6 +713,147 @@ ofono_connctx_create(
     return self;
 }
 
+/*==========================================================================*
+ * Asynchronous activation
+ *==========================================================================*/
+
+static
+gboolean
+ofono_connctx_settings_configured(
+    const OfonoConnCtxSettings* settings)
+{
+    return settings && settings->ifname && settings->ifname[0] &&
+        settings->address && settings->address[0];
+}
+
+static
+gboolean
+ofono_connctx_configured(
+    OfonoConnCtx* self)
+{
+    return self->active &&
+        (ofono_connctx_settings_configured(self->settings) ||
+        ofono_connctx_settings_configured(self->ipv6_settings));
+}
+
+static
+void
+ofono_connctx_activate_op_complete(
+    OfonoConnCtxActivateOp* op,
+    GError* error)
+{
+    OfonoConnCtx* self = op->self;
+    OfonoConnCtxPriv* priv = self->priv;
+    GTask* task = op->task;
+    priv->activate_ops = g_slist_remove(priv->activate_ops, op);
+    ofono_connctx_remove_handlers(self, op->handler_id,
+        G_N_ELEMENTS(op->handler_id));
+    if (op->timeout_id) {
+        ofono_source_remove(ofono_context_of(self), op->timeout_id);
+    }
+    if (op->cancel_id) {
+        ofono_source_remove(ofono_context_of(self), op->cancel_id);
+    }
+    g_task_set_task_data(task, ofono_memdup(&op->timing, sizeof(op->timing)),
+        g_free);
+    g_slice_free(OfonoConnCtxActivateOp, op);
+    if (error) {
+        g_task_return_error(task, error);
+    } else {
+        g_task_return_boolean(task, TRUE);
+    }
+    g_object_unref(task);
+}
+
+static
+void
+ofono_connctx_activate_op_fail_all(
+    OfonoConnCtx* self,
+    const GError* error)
+{
+    OfonoConnCtxPriv* priv = self->priv;
+    while (priv->activate_ops) {
+        ofono_connctx_activate_op_complete(priv->activate_ops->data,
+            g_error_copy(error));
+    }
+}
+
+static
+void
+ofono_connctx_activate_op_check(
+    OfonoConnCtx* self,
+    void* arg)
+{
+    OfonoConnCtxActivateOp* op = arg;
+    const gint64 elapsed = g_get_monotonic_time() - op->start;
+    if (self->active && !op->timing.active && !op->was_active) {
+        op->timing.active = elapsed;
+    }
+    if (ofono_connctx_configured(self)) {
+        op->timing.settings = elapsed;
+        ofono_connctx_activate_op_complete(op, NULL);
+    }
+}
+
+static
+void
+ofono_connctx_activate_op_failed(
+    OfonoConnCtx* self,
+    const GError* error,
+    void* arg)
+{
+    ofono_connctx_activate_op_complete(arg, g_error_copy(error));
+}
+
+static
+gboolean
+ofono_connctx_activate_op_timeout(
+    gpointer arg)
+{
+    OfonoConnCtxActivateOp* op = arg;
+    op->timeout_id = 0;
+    ofono_connctx_activate_op_complete(op, g_error_new_literal(G_IO_ERROR,
+        G_IO_ERROR_TIMED_OUT, "Activation timeout"));
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+ofono_connctx_activate_op_cancelled(
+    GCancellable* cancellable,
+    gpointer arg)
+{
+    OfonoConnCtxActivateOp* op = arg;
+    GError* error = NULL;
+    op->cancel_id = 0;
+    g_cancellable_set_error_if_cancelled(cancellable, &error);
+    ofono_connctx_activate_op_complete(op, error);
+    return G_SOURCE_REMOVE;
+}
+
+static
+int
+ofono_connctx_addr_compare(
+    gconstpointer p1,
+    gconstpointer p2)
+{
+    const OfonoConnCtxAddr* a1 = p1;
+    const OfonoConnCtxAddr* a2 = p2;
+    if (a1->family != a2->family) {
+        return (a1->family < a2->family) ? -1 : 1;
+    } else {
+        /* Consistent with ofono_connctx_addr_equal */
+        switch (a1->family) {
+        case AF_INET:
+            return memcmp(&a1->u.in, &a2->u.in, sizeof(a1->u.in));
+        case AF_INET6:
+            return memcmp(&a1->u.in6, &a2->u.in6, sizeof(a1->u.in6));
+        default:
+            return 0;
+        }
+    }
+}
+
 /*==========================================================================*
  * API
  *==========================================================================*/
@@ -543,19 +862,19 @@ OfonoConnCtx*
 ofono_connctx_new(
     const char* path)
 {
+    OfonoContext* lib = ofono_context_current();
     OfonoConnCtx* context = NULL;
-    if (path && ofono_connctx_table) {
-        context = ofono_connctx_ref(g_hash_table_lookup(
-            ofono_connctx_table, path));
+    if (path && lib->connctxs) {
+        context = ofono_connctx_ref(g_hash_table_lookup(lib->connctxs, path));
     }
     if (!context && path) {
         char* key = g_strdup(path);
         context = ofono_connctx_create(path);
-        if (!ofono_connctx_table) {
-            ofono_connctx_table = g_hash_table_new_full(g_str_hash,
+        if (!lib->connctxs) {
+            lib->connctxs = g_hash_table_new_full(g_str_hash,
                 g_str_equal, g_free, NULL);
         }
-        g_hash_table_replace(ofono_connctx_table, key, context);
+        g_hash_table_replace(lib->connctxs, key, context);
         g_object_weak_ref(G_OBJECT(context), ofono_connctx_destroyed, key);
     }
     return context;
@@ -582,6 +901,15 @@ ofono_connctx_unref(
     }
 }
 
+OfonoConnCtxSnapshot*
+ofono_connctx_snapshot(
+    OfonoConnCtx* self)
+{
+    OfonoSnapshot* snapshot =
+        ofono_object_snapshot(ofono_connctx_object(self));
+    return snapshot ? G_CAST(snapshot, OfonoConnCtxSnapshot, snapshot) : NULL;
+}
+
 const char*
 ofono_connctx_type_string(
     OFONO_CONNCTX_TYPE type)
@@ -611,6 +939,92 @@ ofono_connctx_method_string(
     return ofono_int_to_name(&ofono_connctx_method_map, method);
 }
 
+guint
+ofono_connctx_settings_changed(
+    OfonoConnCtx* self,
+    gboolean ipv6)
+{
+    if (G_LIKELY(self)) {
+        OfonoConnCtxPriv* priv = self->priv;
+        return ipv6 ? priv->ipv6_settings.changed : priv->settings.changed;
+    }
+    return 0;
+}
+
+gboolean
+ofono_connctx_addr_equal(
+    const OfonoConnCtxAddr* a1,
+    const OfonoConnCtxAddr* a2)
+{
+    if (a1 == a2) {
+        return TRUE;
+    } else if (!a1 || !a2 || a1->family != a2->family) {
+        return FALSE;
+    } else {
+        switch (a1->family) {
+        case AF_INET:
+            return a1->u.in.s_addr == a2->u.in.s_addr;
+        case AF_INET6:
+            return !memcmp(&a1->u.in6, &a2->u.in6, sizeof(a1->u.in6));
+        default:
+            return TRUE;
+        }
+    }
+}
+
+gboolean
+ofono_connctx_net_config_equal(
+    const OfonoConnCtxNetConfig* c1,
+    const OfonoConnCtxNetConfig* c2)
+{
+    if (c1 == c2) {
+        return TRUE;
+    } else if (!c1 || !c2 || c1->prefix != c2->prefix ||
+        c1->dns_count != c2->dns_count ||
+        !ofono_connctx_addr_equal(&c1->address, &c2->address) ||
+        !ofono_connctx_addr_equal(&c1->gateway, &c2->gateway)) {
+        return FALSE;
+    } else {
+        OfonoConnCtxAddr buf1[DNS_COMPARE_STACK_COUNT];
+        OfonoConnCtxAddr buf2[DNS_COMPARE_STACK_COUNT];
+        OfonoConnCtxAddr* dns1;
+        OfonoConnCtxAddr* dns2;
+        gboolean equal = TRUE;
+        guint i, n;
+        gsize size;
+
+        /* Usually the lists are identical */
+        for (i = 0; i < c1->dns_count &&
+            ofono_connctx_addr_equal(c1->dns + i, c2->dns + i); i++);
+        if (i == c1->dns_count) {
+            return TRUE;
+        }
+
+        /* Compare sorted copies of the rest, duplicates must match too */
+        n = c1->dns_count - i;
+        size = n * sizeof(OfonoConnCtxAddr);
+        if (n <= DNS_COMPARE_STACK_COUNT) {
+            dns1 = buf1;
+            dns2 = buf2;
+        } else {
+            dns1 = g_malloc(size);
+            dns2 = g_malloc(size);
+        }
+        memcpy(dns1, c1->dns + i, size);
+        memcpy(dns2, c2->dns + i, size);
+        qsort(dns1, n, sizeof(*dns1), ofono_connctx_addr_compare);
+        qsort(dns2, n, sizeof(*dns2), ofono_connctx_addr_compare);
+        for (i = 0; i < n && equal; i++) {
+            equal = ofono_connctx_addr_equal(dns1 + i, dns2 + i);
+        }
+        if (dns1 != buf1) {
+            g_free(dns1);
+            g_free(dns2);
+        }
+        return equal;
+    }
+}
+
 gulong
 ofono_connctx_add_valid_changed_handler(
     OfonoConnCtx* self,
@@ -638,7 +1052,7 @@ ofono_connctx_add_name_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_NAME_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -648,7 +1062,7 @@ ofono_connctx_add_apn_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_APN_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -658,7 +1072,7 @@ ofono_connctx_add_type_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_TYPE_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -668,7 +1082,7 @@ ofono_connctx_add_mms_proxy_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_MMS_PROXY_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -678,7 +1092,7 @@ ofono_connctx_add_mms_center_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_MMS_CENTER_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -688,7 +1102,7 @@ ofono_connctx_add_interface_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_INTERFACE_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -698,7 +1112,7 @@ ofono_connctx_add_settings_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_SETTINGS_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -708,7 +1122,7 @@ ofono_connctx_add_ipv6_settings_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_IPV6_SETTINGS_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -718,7 +1132,7 @@ ofono_connctx_add_active_changed_handler(
     OfonoConnCtxHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_ACTIVE_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -728,7 +1142,7 @@ ofono_connctx_add_activate_failed_handler(
     OfonoConnCtxErrorHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNCTX_SIGNAL_ACTIVATE_FAILED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -767,10 +1181,111 @@ ofono_connctx_activate(
     ofono_connctx_perform_action(self, CONNCTX_ACTION_ACTIVATE);
 }
 
+void
+ofono_connctx_activate_async(
+    OfonoConnCtx* self,
+    int timeout_msec,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    GTask* task = g_task_new(self, cancellable, callback, user_data);
+    if (G_UNLIKELY(!self)) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+            "No context");
+        g_object_unref(task);
+    } else if (ofono_connctx_configured(self)) {
+        OfonoConnCtxActivateTiming* timing = g_new0(OfonoConnCtxActivateTiming,
+            1);
+        g_task_set_task_data(task, timing, g_free);
+        g_task_return_boolean(task, TRUE);
+        g_object_unref(task);
+    } else {
+        OfonoConnCtxPriv* priv = self->priv;
+        OfonoConnCtxActivateOp* op = g_slice_new0(OfonoConnCtxActivateOp);
+        op->self = self;
+        op->task = task;
+        op->start = g_get_monotonic_time();
+        op->handler_id[ACTIVATE_OP_HANDLER_ACTIVE] =
+            ofono_connctx_add_active_changed_handler(self,
+                ofono_connctx_activate_op_check, op);
+        op->handler_id[ACTIVATE_OP_HANDLER_SETTINGS] =
+            ofono_connctx_add_settings_changed_handler(self,
+                ofono_connctx_activate_op_check, op);
+        op->handler_id[ACTIVATE_OP_HANDLER_IPV6_SETTINGS] =
+            ofono_connctx_add_ipv6_settings_changed_handler(self,
+                ofono_connctx_activate_op_check, op);
+        op->handler_id[ACTIVATE_OP_HANDLER_FAILED] =
+            ofono_connctx_add_activate_failed_handler(self,
+                ofono_connctx_activate_op_failed, op);
+        if (timeout_msec > 0) {
+            op->timeout_id = ofono_timeout_add(ofono_context_of(self),
+                timeout_msec, ofono_connctx_activate_op_timeout, op);
+        }
+        if (cancellable) {
+            op->cancel_id = ofono_cancellable_add(ofono_context_of(self),
+                cancellable, ofono_connctx_activate_op_cancelled, op);
+        }
+        priv->activate_ops = g_slist_append(priv->activate_ops, op);
+        if (self->active) {
+            /* Just waiting for the settings */
+            op->was_active = TRUE;
+        } else {
+            ofono_connctx_activate(self);
+        }
+    }
+}
+
+gboolean
+ofono_connctx_activate_finish(
+    OfonoConnCtx* self,
+    GAsyncResult* result,
+    OfonoConnCtxActivateTiming* timing,
+    GError** error)
+{
+    GTask* task = G_TASK(result);
+    GASSERT(g_task_is_valid(result, self));
+    if (timing) {
+        const OfonoConnCtxActivateTiming* data = g_task_get_task_data(task);
+        if (data) {
+            *timing = *data;
+        } else {
+            memset(timing, 0, sizeof(*timing));
+        }
+    }
+    return g_task_propagate_boolean(task, error);
+}
+
+void
+ofono_connctx_set_activation_priority(
+    OfonoConnCtx* self,
+    int priority)
+{
+    if (G_LIKELY(self)) {
+        OfonoConnCtxPriv* priv = self->priv;
+        if (priv->priority != priority) {
+            priv->priority = priority;
+            if (priv->slot_wait) {
+                /* Requeue with the new priority */
+                const char* path = ofono_connctx_path(self);
+                ofono_connmgr_watch_cancel_slot(priv->connmgr, path);
+                ofono_connmgr_watch_request_slot(priv->connmgr, path,
+                    priority);
+            }
+        }
+    }
+}
+
 void
 ofono_connctx_deactivate(
     OfonoConnCtx* self)
 {
+    if (G_LIKELY(self) && self->priv->activate_ops) {
+        GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_CANCELLED,
+            "Deactivated");
+        ofono_connctx_activate_op_fail_all(self, error);
+        g_error_free(error);
+    }
     ofono_connctx_perform_action(self, CONNCTX_ACTION_DEACTIVATE);
 }
 
@@ -899,6 +1414,215 @@ ofono_connctx_provision(
     return ofono_connctx_provision_full(self, NULL, NULL) != NULL;
 }
 
+/*==========================================================================*
+ * Transactions
+ *
+ * All writes are issued at once, without waiting for the previous ones
+ * to complete. oFono still processes them one by one but we don't pay
+ * for the round trips.
+ *==========================================================================*/
+
+static
+void
+ofono_connctx_tx_item_free(
+    gpointer data)
+{
+    OfonoConnCtxTxItem* item = data;
+    if (item->error) g_error_free(item->error);
+    g_free(item->name);
+    g_free(item->value);
+    g_slice_free(OfonoConnCtxTxItem, item);
+}
+
+static
+void
+ofono_connctx_tx_cancelled(
+    GCancellable* cancellable,
+    gpointer data)
+{
+    OfonoConnCtxTx* tx = data;
+    guint i;
+    for (i = 0; i < tx->items->len; i++) {
+        OfonoConnCtxTxItem* item = tx->items->pdata[i];
+        if (item->cancellable) {
+            g_cancellable_cancel(item->cancellable);
+        }
+    }
+}
+
+static
+void
+ofono_connctx_tx_finish(
+    OfonoConnCtxTx* tx)
+{
+    const guint n = tx->items->len;
+    OfonoConnCtxTxResult* results = g_new(OfonoConnCtxTxResult, n);
+    const GError* error = NULL;
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        const OfonoConnCtxTxItem* item = tx->items->pdata[i];
+        results[i].name = item->name;
+        results[i].error = item->error;
+        if (item->error && !error) {
+            error = item->error;
+        }
+    }
+    GDEBUG("%s: %u write(s) %s", ofono_connctx_path(tx->context), n,
+        error ? "failed" : "done");
+    if (tx->handler) {
+        tx->handler(tx->context, results, n, error, tx->arg);
+    }
+    g_free(results);
+    ofono_connctx_tx_free(tx);
+}
+
+static
+void
+ofono_connctx_tx_item_finished(
+    OfonoConnCtx* context,
+    const GError* error,
+    void* arg)
+{
+    OfonoConnCtxTxItem* item = arg;
+    OfonoConnCtxTx* tx = item->tx;
+    item->cancellable = NULL;
+    if (error) {
+        item->error = g_error_copy(error);
+    }
+    GASSERT(tx->pending > 0);
+    if (!--tx->pending) {
+        ofono_connctx_tx_finish(tx);
+    }
+}
+
+static
+gboolean
+ofono_connctx_tx_set(
+    OfonoConnCtxTx* tx,
+    const char* name,
+    const char* value)
+{
+    if (G_LIKELY(tx) && G_LIKELY(name) && G_LIKELY(value) &&
+        G_LIKELY(!tx->cancellable)) {
+        OfonoConnCtxTxItem* item;
+        guint i;
+
+        /* The same property written twice keeps its place in the queue */
+        for (i = 0; i < tx->items->len; i++) {
+            item = tx->items->pdata[i];
+            if (!strcmp(item->name, name)) {
+                g_free(item->value);
+                item->value = g_strdup(value);
+                return TRUE;
+            }
+        }
+        item = g_slice_new0(OfonoConnCtxTxItem);
+        item->tx = tx;
+        item->name = g_strdup(name);
+        item->value = g_strdup(value);
+        g_ptr_array_add(tx->items, item);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+OfonoConnCtxTx*
+ofono_connctx_tx_new(
+    OfonoConnCtx* context)
+{
+    if (G_LIKELY(context)) {
+        OfonoConnCtxTx* tx = g_slice_new0(OfonoConnCtxTx);
+        tx->context = ofono_connctx_ref(context);
+        tx->items = g_ptr_array_new_with_free_func(ofono_connctx_tx_item_free);
+        return tx;
+    }
+    return NULL;
+}
+
+void
+ofono_connctx_tx_free(
+    OfonoConnCtxTx* tx)
+{
+    if (G_LIKELY(tx)) {
+        GASSERT(!tx->pending);
+        if (tx->cancellable) {
+            g_cancellable_disconnect(tx->cancellable, tx->cancel_id);
+            g_object_unref(tx->cancellable);
+        }
+        g_ptr_array_free(tx->items, TRUE);
+        ofono_connctx_unref(tx->context);
+        g_slice_free(OfonoConnCtxTx, tx);
+    }
+}
+
+gboolean
+ofono_connctx_tx_set_string(
+    OfonoConnCtxTx* tx,
+    const char* name,
+    const char* value)
+{
+    return ofono_connctx_tx_set(tx, name, value);
+}
+
+gboolean
+ofono_connctx_tx_set_type(
+    OfonoConnCtxTx* tx,
+    OFONO_CONNCTX_TYPE type)
+{
+    return ofono_connctx_tx_set(tx, OFONO_CONNCTX_PROPERTY_TYPE,
+        ofono_int_to_name(&ofono_connctx_type_map, type));
+}
+
+gboolean
+ofono_connctx_tx_set_protocol(
+    OfonoConnCtxTx* tx,
+    OFONO_CONNCTX_PROTOCOL protocol)
+{
+    return ofono_connctx_tx_set(tx, OFONO_CONNCTX_PROPERTY_PROTOCOL,
+        ofono_int_to_name(&ofono_connctx_protocol_map, protocol));
+}
+
+gboolean
+ofono_connctx_tx_set_auth(
+    OfonoConnCtxTx* tx,
+    OFONO_CONNCTX_AUTH auth)
+{
+    return ofono_connctx_tx_set(tx, OFONO_CONNCTX_PROPERTY_AUTH,
+        ofono_int_to_name(&ofono_connctx_auth_map, auth));
+}
+
+GCancellable*
+ofono_connctx_tx_commit(
+    OfonoConnCtxTx* tx,
+    OfonoConnCtxTxHandler handler,
+    void* arg)
+{
+    if (G_LIKELY(tx) && G_LIKELY(!tx->cancellable)) {
+        OfonoObject* object = ofono_connctx_object(tx->context);
+        if (tx->items->len && ofono_object_proxy(object)) {
+            guint i;
+            tx->handler = handler;
+            tx->arg = arg;
+            tx->cancellable = g_cancellable_new();
+            tx->pending = tx->items->len;
+            GDEBUG("%s: %u write(s)", object->path, tx->pending);
+            for (i = 0; i < tx->items->len; i++) {
+                OfonoConnCtxTxItem* item = tx->items->pdata[i];
+                item->cancellable = ofono_object_set_string(object,
+                    item->name, item->value, (OfonoObjectCallFinishedCallback)
+                    ofono_connctx_tx_item_finished, item);
+                GASSERT(item->cancellable);
+            }
+            tx->cancel_id = g_cancellable_connect(tx->cancellable,
+                G_CALLBACK(ofono_connctx_tx_cancelled), tx, NULL);
+            return tx->cancellable;
+        }
+        ofono_connctx_tx_free(tx);
+    }
+    return NULL;
+}
+
 /*==========================================================================*
  * Properties
  *==========================================================================*/
@@ -949,6 +1673,45 @@ ofono_connctx_property_active_apply(
           ofono_object_property_boolean_apply
 #endif
 
+static
+void
+ofono_connctx_settings_dump(
+    const char* name,
+    const OfonoConnCtxSettingsPriv* settings,
+    guint mask)
+{
+    if ((mask & OFONO_CONNCTX_SETTINGS_CHANGED_IFNAME) && settings->ifname) {
+        GDEBUG("%s.%s: %s", name, OFONO_CONNCTX_SETTINGS_INTERFACE,
+            settings->ifname);
+    }
+    if ((mask & OFONO_CONNCTX_SETTINGS_CHANGED_METHOD) &&
+        settings->pub.method != OFONO_CONNCTX_METHOD_UNKNOWN) {
+        GDEBUG("%s.%s: %s", name, OFONO_CONNCTX_SETTINGS_METHOD,
+            ofono_connctx_method_string(settings->pub.method));
+    }
+    if ((mask & OFONO_CONNCTX_SETTINGS_CHANGED_ADDRESS) && settings->address) {
+        GDEBUG("%s.%s: %s", name, OFONO_CONNCTX_SETTINGS_ADDRESS,
+            settings->address);
+    }
+    if ((mask & OFONO_CONNCTX_SETTINGS_CHANGED_NETMASK) && settings->netmask) {
+        GDEBUG("%s.%s: %s", name, OFONO_CONNCTX_SETTINGS_NETMASK,
+            settings->netmask);
+    }
+    if ((mask & OFONO_CONNCTX_SETTINGS_CHANGED_GATEWAY) && settings->gateway) {
+        GDEBUG("%s.%s: %s", name, OFONO_CONNCTX_SETTINGS_GATEWAY,
+            settings->gateway);
+    }
+    if (mask & OFONO_CONNCTX_SETTINGS_CHANGED_PREFIX) {
+        GDEBUG("%s.%s: %u", name, OFONO_CONNCTX_SETTINGS_PREFIX_LENGTH,
+            settings->pub.prefix);
+    }
+    if ((mask & OFONO_CONNCTX_SETTINGS_CHANGED_DNS) && settings->dns) {
+        char* dns = g_strjoinv(" ", settings->dns);
+        GDEBUG("%s.%s: %s", name, OFONO_CONNCTX_SETTINGS_DNS, dns);
+        g_free(dns);
+    }
+}
+
 static
 gboolean
 ofono_connctx_property_settings_apply(
@@ -958,15 +1721,12 @@ ofono_connctx_property_settings_apply(
 {
     OfonoConnCtx* self = OFONO_CONNCTX(object);
     OfonoConnCtxPriv* priv = self->priv;
-    gboolean changed = FALSE;
-    OfonoConnCtxSettingsPriv decoded;
-    const gboolean empty = !ofono_connctx_settings_decode(&decoded, value);
     OfonoConnCtxSettingsPriv* settings = CONNCTX_SETTINGS_PRIV_P(priv,prop);
-    OfonoConnCtxSettingsPriv old = *settings;
+    gboolean empty;
+    const guint mask = ofono_connctx_settings_update(settings, value, &empty);
+    gboolean changed = (mask != 0);
     const char* ifname;
 
-    *settings = decoded;
-
     if (empty) {
         if (CONNCTX_SETTINGS_PUB(self,prop)) {
             CONNCTX_SETTINGS_PUB(self,prop) = NULL;
@@ -977,60 +1737,9 @@ ofono_connctx_property_settings_apply(
         changed = TRUE;
     }
 
-    /* Need to signal these properties individually? */
-    if (g_strcmp0(old.ifname, decoded.ifname)) {
-        changed = TRUE;
-        if (decoded.ifname) {
-            GDEBUG("%s.%s: %s", prop->name, OFONO_CONNCTX_SETTINGS_INTERFACE,
-                decoded.ifname);
-        }
-    }
-
-    if (old.pub.method != decoded.pub.method) {
-        changed = TRUE;
-        if (decoded.pub.method != OFONO_CONNCTX_METHOD_UNKNOWN) {
-            GDEBUG("%s.%s: %s", prop->name, OFONO_CONNCTX_SETTINGS_METHOD,
-                ofono_connctx_method_string(decoded.pub.method));
-        }
-    }
-
-    if (g_strcmp0(old.address, decoded.address)) {
-        changed = TRUE;
-        if (decoded.address) {
-            GDEBUG("%s.%s: %s", prop->name, OFONO_CONNCTX_SETTINGS_ADDRESS,
-                decoded.address);
-        }
-    }
-
-    if (g_strcmp0(old.netmask, decoded.netmask)) {
-        changed = TRUE;
-        if (decoded.netmask) {
-            GDEBUG("%s.%s: %s", prop->name, OFONO_CONNCTX_SETTINGS_NETMASK,
-                decoded.netmask);
-        }
-    }
-
-    if (g_strcmp0(old.gateway, decoded.gateway)) {
-        changed = TRUE;
-        if (decoded.gateway) {
-            GDEBUG("%s.%s: %s", prop->name, OFONO_CONNCTX_SETTINGS_GATEWAY,
-                decoded.gateway);
-        }
-    }
-
-    if (old.pub.prefix != decoded.pub.prefix) {
-        changed = TRUE;
-        GDEBUG("%s.%s: %u", prop->name, OFONO_CONNCTX_SETTINGS_PREFIX_LENGTH,
-            decoded.pub.prefix);
-    }
-
-    if (!gutil_strv_equal(old.dns, decoded.dns)) {
-        changed = TRUE;
-        if (GLOG_ENABLED(GLOG_LEVEL_DEBUG) && decoded.dns) {
-            char* dns = g_strjoinv(" ", decoded.dns);
-            GDEBUG("%s.%s: %s", prop->name, OFONO_CONNCTX_SETTINGS_DNS, dns);
-            g_free(dns);
-        }
+    /* See ofono_connctx_settings_changed() */
+    if (GLOG_ENABLED(GLOG_LEVEL_DEBUG) && mask) {
+        ofono_connctx_settings_dump(prop->name, settings, mask);
     }
 
     ifname = priv->settings.ifname ? priv->settings.ifname :
@@ -1042,7 +1751,6 @@ ofono_connctx_property_settings_apply(
         CONNCTX_SIGNAL_EMIT(self, INTERFACE);
     }
 
-    ofono_connctx_settings_clear(&old);
     return changed;
 }
 
@@ -1067,13 +1775,68 @@ ofono_connctx_property_settings_value(
  * Internals
  *==========================================================================*/
 
+static
+const OfonoConnCtxSettings*
+ofono_connctx_snapshot_settings(
+    OfonoSnapshot* snapshot,
+    OfonoConnCtxSettings* copy,
+    const OfonoConnCtxSettings* settings)
+{
+    if (settings) {
+        copy->ifname = ofono_snapshot_strdup(snapshot, settings->ifname);
+        copy->method = settings->method;
+        copy->address = ofono_snapshot_strdup(snapshot, settings->address);
+        copy->netmask = ofono_snapshot_strdup(snapshot, settings->netmask);
+        copy->gateway = ofono_snapshot_strdup(snapshot, settings->gateway);
+        copy->dns = ofono_snapshot_strv_dup(snapshot, settings->dns);
+        copy->prefix = settings->prefix;
+        copy->net = settings->net;
+        copy->net.dns = ofono_snapshot_memdup(snapshot, settings->net.dns,
+            sizeof(settings->net.dns[0]) * settings->net.dns_count);
+        return copy;
+    }
+    return NULL;
+}
+
+static
+OfonoSnapshot*
+ofono_connctx_snapshot_new(
+    OfonoObject* object)
+{
+    OfonoConnCtx* self = OFONO_CONNCTX(object);
+    /* Settings are allocated together with the snapshot */
+    OfonoSnapshot* snapshot = ofono_snapshot_new(sizeof(OfonoConnCtxSnapshot) +
+        2 * sizeof(OfonoConnCtxSettings));
+    OfonoConnCtxSnapshot* copy = G_CAST(snapshot, OfonoConnCtxSnapshot,
+        snapshot);
+    OfonoConnCtxSettings* settings = (OfonoConnCtxSettings*)(copy + 1);
+    copy->ifname = ofono_snapshot_strdup(snapshot, self->ifname);
+    copy->active = self->active;
+    copy->apn = ofono_snapshot_strdup(snapshot, self->apn);
+    copy->type = self->type;
+    copy->auth = self->auth;
+    copy->username = ofono_snapshot_strdup(snapshot, self->username);
+    copy->password = ofono_snapshot_strdup(snapshot, self->password);
+    copy->protocol = self->protocol;
+    copy->name = ofono_snapshot_strdup(snapshot, self->name);
+    copy->settings = ofono_connctx_snapshot_settings(snapshot, settings,
+        self->settings);
+    copy->ipv6_settings = ofono_connctx_snapshot_settings(snapshot,
+        settings + 1, self->ipv6_settings);
+    copy->mms_proxy = ofono_snapshot_strdup(snapshot, self->mms_proxy);
+    copy->mms_center = ofono_snapshot_strdup(snapshot, self->mms_center);
+    return snapshot;
+}
+
 static
 gboolean
 ofono_connctx_is_present(
     OfonoConnCtx* self)
 {
     OfonoConnCtxPriv* priv = self->priv;
-    return priv->connmgr && ofono_modem_valid(priv->modem) && !priv->removed &&
+    return ofono_connmgr_watch_ready(priv->connmgr) &&
+        ofono_modem_valid(priv->modem) &&
+        !priv->removed &&
         ofono_modem_has_interface(priv->modem, OFONO_CONNMGR_INTERFACE_NAME);
 }
 
@@ -1101,7 +1864,15 @@ ofono_connctx_valid_changed(
     OfonoObject* object)
 {
     OfonoConnCtx* self = OFONO_CONNCTX(object);
-    if (object->valid) ofono_connctx_perform_next_action(self);
+    if (object->valid) {
+        ofono_connctx_perform_next_action(self);
+    } else if (self->priv->activate_ops) {
+        /* Nothing is going to happen until it becomes valid again */
+        GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_CLOSED,
+            "Context is no longer valid");
+        ofono_connctx_activate_op_fail_all(self, error);
+        g_error_free(error);
+    }
     OFONO_OBJECT_CLASS(SUPER_CLASS)->fn_valid_changed(object);
 }
 
@@ -1132,15 +1903,21 @@ ofono_connctx_dispose(
     OfonoConnCtxPriv* priv = self->priv;
     /* OfonoObjectPendingCall maintains a reference to the ofono object while
      * the call is pending (i.e. while current_action is being performed),
-     * meaning that we can't get here until the current action is finished. */
+     * meaning that we can't get here until the current action is finished,
+     * unless we are still waiting for the slot. */
+    if (priv->slot_wait) {
+        ofono_connmgr_watch_cancel_slot(priv->connmgr,
+            ofono_connctx_path(self));
+        priv->slot_wait = FALSE;
+        priv->current_action = CONNCTX_ACTION_NONE;
+    }
     GASSERT(priv->current_action == CONNCTX_ACTION_NONE);
     priv->next_action = CONNCTX_ACTION_NONE;
-    if (priv->retry_id) {
-        g_source_remove(priv->retry_id);
-        priv->retry_id = 0;
+    if (priv->connmgr) {
+        ofono_connmgr_watch_remove(priv->connmgr, ofono_connctx_path(self));
+        ofono_connmgr_watch_unref(priv->connmgr);
+        priv->connmgr = NULL;
     }
-    gutil_disconnect_handlers(priv->connmgr, priv->connmgr_event_id,
-        G_N_ELEMENTS(priv->connmgr_event_id));
     ofono_modem_remove_handlers(priv->modem, priv->modem_event_id,
         G_N_ELEMENTS(priv->modem_event_id));
     G_OBJECT_CLASS(SUPER_CLASS)->dispose(object);
@@ -1166,7 +1943,6 @@ ofono_connctx_finalize(
     ofono_modem_unref(priv->modem);
     ofono_connctx_settings_clear(&priv->settings);
     ofono_connctx_settings_clear(&priv->ipv6_settings);
-    if (priv->connmgr) g_object_unref(priv->connmgr);
     G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
 }
 
@@ -1221,6 +1997,7 @@ ofono_connctx_class_init(
     klass->fn_is_ready = ofono_connctx_is_ready;
     klass->fn_is_valid = ofono_connctx_is_valid;
     klass->fn_valid_changed = ofono_connctx_valid_changed;
+    klass->fn_snapshot = ofono_connctx_snapshot_new;
     object_class->dispose = ofono_connctx_dispose;
     object_class->finalize = ofono_connctx_finalize;
     g_type_class_add_private(klass, sizeof(OfonoConnCtxPriv));
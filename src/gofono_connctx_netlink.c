@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_connctx_netlink.h"
+#include "gofono_netlink_p.h"
+#include "gofono_log.h"
+
+#include <net/if.h>
+#include <string.h>
+#include <errno.h>
+
+enum connctx_handler {
+    CONNCTX_HANDLER_ACTIVE,
+    CONNCTX_HANDLER_INTERFACE,
+    CONNCTX_HANDLER_SETTINGS,
+    CONNCTX_HANDLER_IPV6_SETTINGS,
+    CONNCTX_HANDLER_COUNT
+};
+
+enum connctx_netlink_family {
+    FAMILY_IPV4,
+    FAMILY_IPV6,
+    FAMILY_COUNT
+};
+
+/* Configuration of one address family, either desired or applied */
+typedef struct ofono_connctx_netlink_state {
+    int ifindex;
+    gboolean has_address;
+    gboolean has_route;
+    OfonoConnCtxAddr address;
+    guint prefix;
+    OfonoConnCtxAddr gateway;
+} OfonoConnCtxNetlinkState;
+
+struct ofono_connctx_netlink {
+    OfonoConnCtx* context;
+    OfonoNetlink* netlink;
+    OFONO_CONNCTX_NETLINK_FLAGS flags;
+    guint mtu;
+    guint metric;
+    int link_ifindex;
+    OfonoConnCtxNetlinkState applied[FAMILY_COUNT];
+    gulong handler_id[CONNCTX_HANDLER_COUNT];
+};
+
+static const int ofono_connctx_netlink_af[FAMILY_COUNT] = {
+    AF_INET, AF_INET6
+};
+
+static
+gsize
+ofono_connctx_netlink_addr_size(
+    const OfonoConnCtxAddr* addr)
+{
+    return (addr->family == AF_INET6) ? sizeof(addr->u.in6) :
+        sizeof(addr->u.in);
+}
+
+/* Deleting something that's already gone is fine */
+static
+gboolean
+ofono_connctx_netlink_gone(
+    int err)
+{
+    return !err || err == -ENODEV || err == -ESRCH || err == -ENOENT ||
+        err == -EADDRNOTAVAIL;
+}
+
+static
+void
+ofono_connctx_netlink_desired(
+    OfonoConnCtxNetlink* self,
+    int family,
+    OfonoConnCtxNetlinkState* state)
+{
+    OfonoConnCtx* ctx = self->context;
+    const OfonoConnCtxSettings* settings = (family == FAMILY_IPV6) ?
+        ctx->ipv6_settings : ctx->settings;
+    const int af = ofono_connctx_netlink_af[family];
+
+    memset(state, 0, sizeof(*state));
+    if (ctx->active && settings && settings->net.address.family == af) {
+        const char* ifname = settings->ifname ? settings->ifname : ctx->ifname;
+        state->ifindex = ifname ? (int)if_nametoindex(ifname) : 0;
+        if (state->ifindex > 0) {
+            state->address = settings->net.address;
+            state->prefix = settings->net.prefix ? settings->net.prefix :
+                (af == AF_INET6) ? 128 : 32;
+            state->gateway = settings->net.gateway;
+            state->has_address = (self->flags & OFONO_CONNCTX_NETLINK_ADDRESS)
+                != 0;
+            state->has_route = (self->flags & OFONO_CONNCTX_NETLINK_ROUTE)
+                != 0;
+        }
+    }
+}
+
+static
+int
+ofono_connctx_netlink_address(
+    OfonoConnCtxNetlink* self,
+    const OfonoConnCtxNetlinkState* state,
+    gboolean add)
+{
+    OfonoNetlinkMsg msg;
+    const gsize size = ofono_connctx_netlink_addr_size(&state->address);
+    struct ifaddrmsg* ifa = ofono_netlink_msg_init(&msg,
+        add ? RTM_NEWADDR : RTM_DELADDR,
+        add ? (NLM_F_CREATE | NLM_F_REPLACE) : 0, sizeof(*ifa));
+
+    ifa->ifa_family = state->address.family;
+    ifa->ifa_prefixlen = state->prefix;
+    ifa->ifa_scope = RT_SCOPE_UNIVERSE;
+    ifa->ifa_index = state->ifindex;
+    if (state->address.family == AF_INET6) {
+        /* No point in duplicate address detection on a cellular link */
+        ifa->ifa_flags = IFA_F_NODAD;
+    } else {
+        ofono_netlink_msg_add_attr(&msg, IFA_LOCAL, &state->address.u, size);
+    }
+    ofono_netlink_msg_add_attr(&msg, IFA_ADDRESS, &state->address.u, size);
+    return ofono_netlink_request(self->netlink, &msg);
+}
+
+static
+int
+ofono_connctx_netlink_route(
+    OfonoConnCtxNetlink* self,
+    const OfonoConnCtxNetlinkState* state,
+    gboolean add)
+{
+    OfonoNetlinkMsg msg;
+    const guint32 oif = state->ifindex;
+    const gboolean gw = (state->gateway.family == state->address.family);
+    struct rtmsg* rtm = ofono_netlink_msg_init(&msg,
+        add ? RTM_NEWROUTE : RTM_DELROUTE,
+        add ? (NLM_F_CREATE | NLM_F_REPLACE) : 0, sizeof(*rtm));
+
+    rtm->rtm_family = state->address.family;
+    rtm->rtm_table = RT_TABLE_MAIN;
+    rtm->rtm_protocol = RTPROT_STATIC;
+    rtm->rtm_scope = gw ? RT_SCOPE_UNIVERSE : RT_SCOPE_LINK;
+    rtm->rtm_type = RTN_UNICAST;
+    ofono_netlink_msg_add_attr(&msg, RTA_OIF, &oif, sizeof(oif));
+    if (gw) {
+        ofono_netlink_msg_add_attr(&msg, RTA_GATEWAY, &state->gateway.u,
+            ofono_connctx_netlink_addr_size(&state->gateway));
+    }
+    if (self->metric) {
+        const guint32 metric = self->metric;
+        ofono_netlink_msg_add_attr(&msg, RTA_PRIORITY, &metric,
+            sizeof(metric));
+    }
+    return ofono_netlink_request(self->netlink, &msg);
+}
+
+static
+void
+ofono_connctx_netlink_link(
+    OfonoConnCtxNetlink* self,
+    int ifindex)
+{
+    if (self->link_ifindex != ifindex) {
+        self->link_ifindex = ifindex;
+        if (ifindex > 0 && (self->mtu ||
+            (self->flags & OFONO_CONNCTX_NETLINK_LINK_UP))) {
+            OfonoNetlinkMsg msg;
+            struct ifinfomsg* ifi = ofono_netlink_msg_init(&msg, RTM_NEWLINK,
+                0, sizeof(*ifi));
+            int err;
+
+            ifi->ifi_family = AF_UNSPEC;
+            ifi->ifi_index = ifindex;
+            if (self->flags & OFONO_CONNCTX_NETLINK_LINK_UP) {
+                ifi->ifi_flags = IFF_UP;
+                ifi->ifi_change = IFF_UP;
+            }
+            if (self->mtu) {
+                const guint32 mtu = self->mtu;
+                ofono_netlink_msg_add_attr(&msg, IFLA_MTU, &mtu, sizeof(mtu));
+            }
+            err = ofono_netlink_request(self->netlink, &msg);
+            if (err) {
+                GWARN("Failed to configure link %d: %s", ifindex,
+                    strerror(-err));
+            }
+        }
+    }
+}
+
+static
+void
+ofono_connctx_netlink_apply(
+    OfonoConnCtxNetlink* self,
+    int family,
+    const OfonoConnCtxNetlinkState* want)
+{
+    OfonoConnCtxNetlinkState* cur = self->applied + family;
+    const gboolean address_changed = cur->ifindex != want->ifindex ||
+        cur->prefix != want->prefix ||
+        !ofono_connctx_addr_equal(&cur->address, &want->address);
+    int err;
+
+    /* Remove what's no longer needed, the route first */
+    if (cur->has_route && (!want->has_route || address_changed ||
+        !ofono_connctx_addr_equal(&cur->gateway, &want->gateway))) {
+        err = ofono_connctx_netlink_route(self, cur, FALSE);
+        if (!ofono_connctx_netlink_gone(err)) {
+            GWARN("Failed to remove route: %s", strerror(-err));
+        }
+        cur->has_route = FALSE;
+    }
+    if (cur->has_address && (!want->has_address || address_changed)) {
+        err = ofono_connctx_netlink_address(self, cur, FALSE);
+        if (!ofono_connctx_netlink_gone(err)) {
+            GWARN("Failed to remove address: %s", strerror(-err));
+        }
+        cur->has_address = FALSE;
+    }
+
+    /* Then add what's missing */
+    if (want->has_address && !cur->has_address) {
+        err = ofono_connctx_netlink_address(self, want, TRUE);
+        if (err && err != -EEXIST) {
+            GWARN("Failed to add address: %s", strerror(-err));
+        } else {
+            cur->has_address = TRUE;
+        }
+    }
+    if (want->has_route && !cur->has_route) {
+        err = ofono_connctx_netlink_route(self, want, TRUE);
+        if (err && err != -EEXIST) {
+            GWARN("Failed to add route: %s", strerror(-err));
+        } else {
+            cur->has_route = TRUE;
+        }
+    }
+
+    /* Keep what has been applied so that it can be removed later */
+    cur->ifindex = want->ifindex;
+    cur->address = want->address;
+    cur->prefix = want->prefix;
+    cur->gateway = want->gateway;
+}
+
+static
+void
+ofono_connctx_netlink_sync(
+    OfonoConnCtxNetlink* self,
+    gboolean clear)
+{
+    int ifindex = 0;
+    int i;
+
+    for (i = 0; i < FAMILY_COUNT; i++) {
+        OfonoConnCtxNetlinkState want;
+        if (clear) {
+            memset(&want, 0, sizeof(want));
+        } else {
+            ofono_connctx_netlink_desired(self, i, &want);
+        }
+        if (want.ifindex) {
+            /* The link goes first, addresses need it up */
+            ifindex = want.ifindex;
+            ofono_connctx_netlink_link(self, ifindex);
+        }
+        ofono_connctx_netlink_apply(self, i, &want);
+    }
+    if (!ifindex) {
+        self->link_ifindex = 0;
+    }
+}
+
+static
+void
+ofono_connctx_netlink_changed(
+    OfonoConnCtx* context,
+    void* arg)
+{
+    ofono_connctx_netlink_sync((OfonoConnCtxNetlink*)arg, FALSE);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+OfonoConnCtxNetlink*
+ofono_connctx_netlink_new(
+    OfonoConnCtx* context,
+    OFONO_CONNCTX_NETLINK_FLAGS flags,
+    guint mtu,
+    guint metric)
+{
+    if (G_LIKELY(context)) {
+        OfonoNetlink* netlink = ofono_netlink_new();
+        if (netlink) {
+            OfonoConnCtxNetlink* self = g_slice_new0(OfonoConnCtxNetlink);
+            self->context = ofono_connctx_ref(context);
+            self->netlink = netlink;
+            self->flags = flags;
+            self->mtu = mtu;
+            self->metric = metric;
+            self->handler_id[CONNCTX_HANDLER_ACTIVE] =
+                ofono_connctx_add_active_changed_handler(context,
+                    ofono_connctx_netlink_changed, self);
+            self->handler_id[CONNCTX_HANDLER_INTERFACE] =
+                ofono_connctx_add_interface_changed_handler(context,
+                    ofono_connctx_netlink_changed, self);
+            self->handler_id[CONNCTX_HANDLER_SETTINGS] =
+                ofono_connctx_add_settings_changed_handler(context,
+                    ofono_connctx_netlink_changed, self);
+            self->handler_id[CONNCTX_HANDLER_IPV6_SETTINGS] =
+                ofono_connctx_add_ipv6_settings_changed_handler(context,
+                    ofono_connctx_netlink_changed, self);
+            ofono_connctx_netlink_sync(self, FALSE);
+            return self;
+        }
+    }
+    return NULL;
+}
+
+void
+ofono_connctx_netlink_free(
+    OfonoConnCtxNetlink* self)
+{
+    if (G_LIKELY(self)) {
+        ofono_connctx_remove_handlers(self->context, self->handler_id,
+            G_N_ELEMENTS(self->handler_id));
+        ofono_connctx_netlink_sync(self, TRUE);
+        ofono_netlink_free(self->netlink);
+        ofono_connctx_unref(self->context);
+        g_slice_free(OfonoConnCtxNetlink, self);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
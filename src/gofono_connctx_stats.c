@@ -0,0 +1,433 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_connctx_stats.h"
+#include "gofono_netlink_p.h"
+#include "gofono_context_p.h"
+#include "gofono_util_p.h"
+#include "gofono_log.h"
+
+#include <net/if.h>
+#include <string.h>
+
+#define OFONO_CONNCTX_STATS_MIN_INTERVAL (100) /* ms */
+
+enum connctx_handler {
+    CONNCTX_HANDLER_ACTIVE,
+    CONNCTX_HANDLER_INTERFACE,
+    CONNCTX_HANDLER_COUNT
+};
+
+typedef struct ofono_connctx_stats_item {
+    OfonoConnCtxStatsSampler* sampler;
+    gulong id;
+    OfonoConnCtx* context;
+    OfonoConnCtxStatsHandler handler;
+    void* arg;
+    gulong handler_id[CONNCTX_HANDLER_COUNT];
+    int ifindex;                                /* Zero if not sampled */
+    gboolean up;                                /* Active with an ifname */
+    gboolean sampled;                           /* During the current tick */
+    gboolean have_stats;
+    OfonoConnCtxStats stats;
+} OfonoConnCtxStatsItem;
+
+struct ofono_connctx_stats_sampler {
+    OfonoContext* context;                      /* Owns the timer */
+    OfonoNetlink* netlink;
+    GSList* items;
+    gulong last_id;
+    guint interval;
+    guint timer_id;
+    gboolean dispatching;                       /* Calling the handlers */
+    gboolean freed;                             /* Freed by a handler */
+};
+
+static
+void
+ofono_connctx_stats_sampler_destroy(
+    OfonoConnCtxStatsSampler* self);
+
+static
+int
+ofono_connctx_stats_item_ifindex(
+    OfonoConnCtxStatsItem* item)
+{
+    /* The interface may show up some time after the context is active */
+    return item->up ? (int)if_nametoindex(item->context->ifname) : 0;
+}
+
+static
+OfonoConnCtxStatsItem*
+ofono_connctx_stats_sampler_find(
+    OfonoConnCtxStatsSampler* self,
+    gulong id)
+{
+    GSList* l;
+    for (l = self->items; l; l = l->next) {
+        OfonoConnCtxStatsItem* item = l->data;
+        if (item->id == id) {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+static
+guint64
+ofono_connctx_stats_rate(
+    guint64 now,
+    guint64 before,
+    gint64 usec)
+{
+    /* Counters may get reset, e.g. when the interface is recreated */
+    return (now > before && usec > 0) ?
+        ((now - before) * G_USEC_PER_SEC / usec) : 0;
+}
+
+static
+void
+ofono_connctx_stats_item_update(
+    OfonoConnCtxStatsItem* item,
+    const struct rtnl_link_stats64* link,
+    gint64 now)
+{
+    OfonoConnCtxStats* stats = &item->stats;
+    if (item->have_stats) {
+        const gint64 dt = now - stats->timestamp;
+        stats->rx_bytes_rate = ofono_connctx_stats_rate(link->rx_bytes,
+            stats->rx_bytes, dt);
+        stats->tx_bytes_rate = ofono_connctx_stats_rate(link->tx_bytes,
+            stats->tx_bytes, dt);
+        stats->rx_packets_rate = ofono_connctx_stats_rate(link->rx_packets,
+            stats->rx_packets, dt);
+        stats->tx_packets_rate = ofono_connctx_stats_rate(link->tx_packets,
+            stats->tx_packets, dt);
+    } else {
+        memset(stats, 0, sizeof(*stats));
+        item->have_stats = TRUE;
+    }
+    stats->timestamp = now;
+    stats->rx_bytes = link->rx_bytes;
+    stats->tx_bytes = link->tx_bytes;
+    stats->rx_packets = link->rx_packets;
+    stats->tx_packets = link->tx_packets;
+    item->sampled = TRUE;
+}
+
+typedef struct ofono_connctx_stats_dump {
+    OfonoConnCtxStatsSampler* sampler;
+    gint64 now;
+} OfonoConnCtxStatsDump;
+
+static
+void
+ofono_connctx_stats_sampler_link(
+    const struct nlmsghdr* msg,
+    void* arg)
+{
+    if (msg->nlmsg_type == RTM_NEWLINK) {
+        OfonoConnCtxStatsDump* dump = arg;
+        const struct ifinfomsg* ifi = NLMSG_DATA(msg);
+        const struct rtattr* rta = IFLA_RTA(ifi);
+        int len = IFLA_PAYLOAD(msg);
+
+        for (; RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+            if (rta->rta_type == IFLA_STATS64 &&
+                RTA_PAYLOAD(rta) >= sizeof(struct rtnl_link_stats64)) {
+                struct rtnl_link_stats64 link;
+                GSList* l;
+
+                /* The attribute is only 4-byte aligned */
+                memcpy(&link, RTA_DATA(rta), sizeof(link));
+                for (l = dump->sampler->items; l; l = l->next) {
+                    OfonoConnCtxStatsItem* item = l->data;
+                    if (item->ifindex == ifi->ifi_index) {
+                        ofono_connctx_stats_item_update(item, &link,
+                            dump->now);
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
+
+static
+gboolean
+ofono_connctx_stats_sampler_tick(
+    gpointer data)
+{
+    OfonoConnCtxStatsSampler* self = data;
+    OfonoConnCtxStatsDump dump;
+    OfonoNetlinkMsg msg;
+    struct ifinfomsg* ifi;
+    GArray* ids;
+    gboolean need_dump = FALSE;
+    GSList* l;
+    guint i;
+
+    /* Retry the interfaces which didn't exist last time */
+    for (l = self->items; l; l = l->next) {
+        OfonoConnCtxStatsItem* item = l->data;
+        if (!item->ifindex) {
+            item->ifindex = ofono_connctx_stats_item_ifindex(item);
+        }
+        if (item->ifindex > 0) {
+            need_dump = TRUE;
+        }
+    }
+
+    /* One dump for all interfaces */
+    if (need_dump) {
+        dump.sampler = self;
+        dump.now = g_get_monotonic_time();
+        ifi = ofono_netlink_msg_init(&msg, RTM_GETLINK, 0, sizeof(*ifi));
+        ifi->ifi_family = AF_UNSPEC;
+        ofono_netlink_dump(self->netlink, &msg,
+            ofono_connctx_stats_sampler_link, &dump);
+    }
+
+    /* Handlers may remove items */
+    ids = g_array_new(FALSE, FALSE, sizeof(gulong));
+    for (l = self->items; l; l = l->next) {
+        OfonoConnCtxStatsItem* item = l->data;
+        if (item->sampled) {
+            item->sampled = FALSE;
+            g_array_append_val(ids, item->id);
+        }
+    }
+    /* Or free the sampler, in which case we finish the job */
+    self->dispatching = TRUE;
+    for (i = 0; i < ids->len && !self->freed; i++) {
+        OfonoConnCtxStatsItem* item = ofono_connctx_stats_sampler_find(self,
+            g_array_index(ids, gulong, i));
+        if (item && item->handler) {
+            item->handler(item->context, &item->stats, item->arg);
+        }
+    }
+    self->dispatching = FALSE;
+    g_array_free(ids, TRUE);
+    if (self->freed) {
+        ofono_connctx_stats_sampler_destroy(self);
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static
+void
+ofono_connctx_stats_sampler_update_timer(
+    OfonoConnCtxStatsSampler* self)
+{
+    gboolean need_timer = FALSE;
+    GSList* l;
+
+    for (l = self->items; l && !need_timer; l = l->next) {
+        OfonoConnCtxStatsItem* item = l->data;
+        need_timer = item->up;
+    }
+    if (need_timer && !self->timer_id) {
+        self->timer_id = ofono_timeout_add(self->context, self->interval,
+            ofono_connctx_stats_sampler_tick, self);
+    } else if (!need_timer && self->timer_id) {
+        ofono_source_remove(self->context, self->timer_id);
+        self->timer_id = 0;
+    }
+}
+
+static
+void
+ofono_connctx_stats_item_changed(
+    OfonoConnCtx* context,
+    void* arg)
+{
+    OfonoConnCtxStatsItem* item = arg;
+    int ifindex;
+
+    item->up = (context->active && context->ifname);
+    ifindex = ofono_connctx_stats_item_ifindex(item);
+    if (item->ifindex != ifindex) {
+        /* Start over */
+        item->ifindex = ifindex;
+        item->have_stats = FALSE;
+    }
+    ofono_connctx_stats_sampler_update_timer(item->sampler);
+}
+
+static
+void
+ofono_connctx_stats_item_free(
+    OfonoConnCtxStatsItem* item)
+{
+    ofono_connctx_remove_handlers(item->context, item->handler_id,
+        G_N_ELEMENTS(item->handler_id));
+    ofono_connctx_unref(item->context);
+    g_slice_free(OfonoConnCtxStatsItem, item);
+}
+
+static
+void
+ofono_connctx_stats_sampler_destroy(
+    OfonoConnCtxStatsSampler* self)
+{
+    g_slist_free_full(self->items, (GDestroyNotify)
+        ofono_connctx_stats_item_free);
+    ofono_netlink_free(self->netlink);
+    ofono_context_unref(self->context);
+    g_slice_free(OfonoConnCtxStatsSampler, self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+OfonoConnCtxStatsSampler*
+ofono_connctx_stats_sampler_new(
+    guint interval_msec)
+{
+    OfonoNetlink* netlink = ofono_netlink_new();
+    if (netlink) {
+        OfonoConnCtxStatsSampler* self =
+            g_slice_new0(OfonoConnCtxStatsSampler);
+        self->context = ofono_context_ref(ofono_context_current());
+        self->netlink = netlink;
+        self->interval = MAX(interval_msec, OFONO_CONNCTX_STATS_MIN_INTERVAL);
+        return self;
+    }
+    return NULL;
+}
+
+void
+ofono_connctx_stats_sampler_free(
+    OfonoConnCtxStatsSampler* self)
+{
+    if (G_LIKELY(self)) {
+        if (self->timer_id) {
+            ofono_source_remove(self->context, self->timer_id);
+            self->timer_id = 0;
+        }
+        if (self->dispatching) {
+            /* Called from a handler, the tick will do the rest */
+            self->freed = TRUE;
+        } else {
+            ofono_connctx_stats_sampler_destroy(self);
+        }
+    }
+}
+
+void
+ofono_connctx_stats_sampler_set_interval(
+    OfonoConnCtxStatsSampler* self,
+    guint interval_msec)
+{
+    if (G_LIKELY(self)) {
+        interval_msec = MAX(interval_msec, OFONO_CONNCTX_STATS_MIN_INTERVAL);
+        if (self->interval != interval_msec) {
+            self->interval = interval_msec;
+            if (self->timer_id) {
+                /* Restart the timer */
+                ofono_source_remove(self->context, self->timer_id);
+                self->timer_id = 0;
+                ofono_connctx_stats_sampler_update_timer(self);
+            }
+        }
+    }
+}
+
+gulong
+ofono_connctx_stats_sampler_add(
+    OfonoConnCtxStatsSampler* self,
+    OfonoConnCtx* context,
+    OfonoConnCtxStatsHandler handler,
+    void* arg)
+{
+    if (G_LIKELY(self) && G_LIKELY(context)) {
+        OfonoConnCtxStatsItem* item = g_slice_new0(OfonoConnCtxStatsItem);
+        item->sampler = self;
+        item->id = ++(self->last_id);
+        item->context = ofono_connctx_ref(context);
+        item->handler = handler;
+        item->arg = arg;
+        item->handler_id[CONNCTX_HANDLER_ACTIVE] =
+            ofono_connctx_add_active_changed_handler(context,
+                ofono_connctx_stats_item_changed, item);
+        item->handler_id[CONNCTX_HANDLER_INTERFACE] =
+            ofono_connctx_add_interface_changed_handler(context,
+                ofono_connctx_stats_item_changed, item);
+        self->items = g_slist_append(self->items, item);
+        ofono_connctx_stats_item_changed(context, item);
+        return item->id;
+    }
+    return 0;
+}
+
+void
+ofono_connctx_stats_sampler_remove(
+    OfonoConnCtxStatsSampler* self,
+    gulong id)
+{
+    if (G_LIKELY(self) && G_LIKELY(id)) {
+        OfonoConnCtxStatsItem* item = ofono_connctx_stats_sampler_find(self,
+            id);
+        if (item) {
+            self->items = g_slist_remove(self->items, item);
+            ofono_connctx_stats_item_free(item);
+            ofono_connctx_stats_sampler_update_timer(self);
+        }
+    }
+}
+
+gboolean
+ofono_connctx_stats_sampler_get(
+    OfonoConnCtxStatsSampler* self,
+    gulong id,
+    OfonoConnCtxStats* stats)
+{
+    if (G_LIKELY(self) && G_LIKELY(id)) {
+        OfonoConnCtxStatsItem* item = ofono_connctx_stats_sampler_find(self,
+            id);
+        if (item && item->have_stats) {
+            if (stats) *stats = item->stats;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
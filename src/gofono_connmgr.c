@@ -33,7 +33,10 @@
 #include "gofono_connmgr.h"
 #include "gofono_connctx.h"
 #include "gofono_modem_p.h"
+#include "gofono_callgroup_p.h"
+#include "gofono_context_p.h"
 #include "gofono_error_p.h"
+#include "gofono_eventstream_p.h"
 #include "gofono_util_p.h"
 #include "gofono_names.h"
 #include "gofono_log.h"
@@ -52,24 +55,115 @@ enum proxy_handler_id {
     PROXY_HANDLER_COUNT
 };
 
+enum connctx_handler {
+    CONNCTX_HANDLER_VALID,
+    CONNCTX_HANDLER_TYPE,
+    CONNCTX_HANDLER_APN,
+    CONNCTX_HANDLER_COUNT
+};
+
 typedef struct ofono_connmgr_context_data {
     OfonoConnCtx* context;
-    gulong valid_handler_id;
+    gulong handler_id[CONNCTX_HANDLER_COUNT];
+    gboolean indexed;
+    OFONO_CONNCTX_TYPE type;            /* Keys the context is indexed by */
+    char* apn;
 } OfonoConnMgrContextData;
 
 typedef struct ofono_connmgr_get_contexts_call {
     OFONO_OBJECT_PROXY* proxy;
     GCancellable* cancel;
+    OfonoCallGroup* group;
     OfonoConnMgr* self;
 } OfonoConnMgrGetContextsCall;
 
+typedef struct ofono_connmgr_batch OfonoConnMgrBatch;
+
+typedef struct ofono_connmgr_batch_item {
+    OfonoConnMgrBatch* batch;
+    OFONO_CONNCTX_PROTOCOL protocol;
+    OFONO_CONNCTX_AUTH auth;
+    char* name;
+    char* apn;
+    char* username;
+    char* password;
+    char* path;                         /* AddContext result */
+    OfonoConnCtx* context;              /* Set when the context is valid */
+    gboolean done;
+} OfonoConnMgrBatchItem;
+
+typedef struct ofono_connmgr_call {
+    const char* name;
+    gboolean (*finish)(OrgOfonoConnectionManager* proxy,
+        GAsyncResult* result, GError** error);
+} OfonoConnMgrCall;
+
+static const OfonoConnMgrCall ofono_connmgr_call_remove_context = {
+    "RemoveContext", org_ofono_connection_manager_call_remove_context_finish
+};
+
+static const OfonoConnMgrCall ofono_connmgr_call_deactivate_all = {
+    "DeactivateAll", org_ofono_connection_manager_call_deactivate_all_finish
+};
+
+typedef struct ofono_connmgr_provision_op OfonoConnMgrProvisionOp;
+
+typedef struct ofono_connmgr_provision_item {
+    OfonoConnMgrProvisionOp* op;
+    OfonoConnCtx* context;
+    GCancellable* call;                 /* ProvisionContext in progress */
+} OfonoConnMgrProvisionItem;
+
+struct ofono_connmgr_provision_op {
+    GTask* task;
+    OfonoConnMgrProvisionItem* items;
+    guint count;
+    guint next;                         /* Next item to start */
+    guint pending;                      /* Calls in progress */
+    guint max_calls;
+    guint failed;
+    guint cancel_id;
+    gboolean cancelled;
+    GError* error;
+};
+
+#define PROVISION_ALL_MAX_CALLS (4)
+#define ADD_CONTEXTS_TIMEOUT_SEC (60)
+
+/* Properties written by ProvisionContext */
+static const char* const ofono_connmgr_provision_properties[] = {
+    OFONO_CONNCTX_PROPERTY_NAME,
+    OFONO_CONNCTX_PROPERTY_APN,
+    OFONO_CONNCTX_PROPERTY_USERNAME,
+    OFONO_CONNCTX_PROPERTY_PASSWORD,
+    OFONO_CONNCTX_PROPERTY_PROTOCOL,
+    OFONO_CONNCTX_PROPERTY_AUTH,
+    OFONO_CONNCTX_PROPERTY_MMS_PROXY,
+    OFONO_CONNCTX_PROPERTY_MMS_CENTER,
+    NULL
+};
+
+struct ofono_connmgr_batch {
+    OfonoConnMgr* self;
+    GTask* task;
+    guint cancel_id;                    /* Watches the task cancellable */
+    guint timeout_id;                   /* Deadline for the whole batch */
+    OfonoConnMgrBatchItem* items;
+    guint count;
+    guint pending;
+    GError* error;
+};
+
 struct ofono_connmgr_priv {
     const char* name;
     gulong proxy_handler_id[PROXY_HANDLER_COUNT];
-    GUtilIdlePool* pool;
     OfonoConnMgrGetContextsCall* get_contexts_pending;
     GHashTable* all_contexts;
-    GPtrArray* valid_contexts;
+    GPtrArray* valid_contexts;          /* Sorted by path */
+    GHashTable* valid_by_path;          /* path => OfonoConnCtx */
+    GHashTable* valid_by_type;          /* type => GPtrArray sorted by path */
+    GHashTable* valid_by_apn;           /* APN => GPtrArray sorted by path */
+    GSList* batches;                    /* OfonoConnMgrBatch */
     gboolean get_contexts_ok;
 };
 
@@ -98,6 +192,24 @@ static guint ofono_connmgr_signals[CONNMGR_SIGNAL_COUNT] = { 0 };
 #define CONNMGR_DEFINE_PROPERTY_BOOL(NAME,var) \
     OFONO_OBJECT_DEFINE_PROPERTY_BOOL(CONNMGR,NAME,OfonoConnMgr,var)
 
+static
+void
+ofono_connmgr_batch_context_valid(
+    OfonoConnMgr* self,
+    OfonoConnCtx* context);
+
+static
+void
+ofono_connmgr_batch_context_removed(
+    OfonoConnMgr* self,
+    const char* path);
+
+static
+void
+ofono_connmgr_start_get_contexts(
+    OfonoConnMgr* self,
+    OFONO_OBJECT_PROXY* proxy);
+
 /*==========================================================================*
  * Implementation
  *==========================================================================*/
@@ -132,39 +244,159 @@ ofono_connmgr_context_data_destroy(
     gpointer value)
 {
     OfonoConnMgrContextData* data = value;
-    ofono_connctx_remove_handler(data->context, data->valid_handler_id);
+    ofono_connctx_remove_handlers(data->context, data->handler_id,
+        G_N_ELEMENTS(data->handler_id));
     ofono_connctx_unref(data->context);
+    g_free(data->apn);
     g_slice_free(OfonoConnMgrContextData, data);
 }
 
+/*
+ * Binary search in the list sorted by path. Returns the index of the
+ * matching context or, if there's none, where it should be inserted.
+ */
 static
-gint
-ofono_connmgr_context_compare(
-    gconstpointer a,
-    gconstpointer b)
+guint
+ofono_connmgr_context_bsearch(
+    GPtrArray* list,
+    const char* path,
+    gboolean* found)
 {
-    OfonoConnCtx* const* ctx1 = a;
-    OfonoConnCtx* const* ctx2 = b;
-    return g_strcmp0(ofono_connctx_path(*ctx1), ofono_connctx_path(*ctx2));
+    guint lo = 0, hi = list->len;
+    while (lo < hi) {
+        const guint mid = (lo + hi) / 2;
+        const int diff = strcmp(ofono_connctx_path(list->pdata[mid]), path);
+        if (diff < 0) {
+            lo = mid + 1;
+        } else if (diff > 0) {
+            hi = mid;
+        } else {
+            *found = TRUE;
+            return mid;
+        }
+    }
+    *found = FALSE;
+    return lo;
 }
 
 static
-int
-ofono_connmgr_find_valid_context(
-    OfonoConnMgr* self,
-    const char* path)
+void
+ofono_connmgr_bucket_add(
+    GHashTable* index,
+    gconstpointer key,
+    GBoxedCopyFunc copy_key,
+    OfonoConnCtx* ctx)
 {
-    if (path) {
-        GPtrArray* list = self->priv->valid_contexts;
-        int i, n = list->len;
-        for (i=0; i<n; i++) {
-            OfonoConnCtx* ctx = OFONO_CONNCTX(list->pdata[i]);
-            if (!g_strcmp0(path, ofono_connctx_path(ctx))) {
-                return i;
+    GPtrArray* list = g_hash_table_lookup(index, key);
+    gboolean found;
+    guint pos;
+    if (!list) {
+        list = g_ptr_array_new();
+        g_hash_table_insert(index, copy_key ? copy_key(key) :
+            (gpointer)key, list);
+    }
+    pos = ofono_connmgr_context_bsearch(list, ofono_connctx_path(ctx), &found);
+    if (!found) {
+        g_ptr_array_insert(list, pos, ctx);
+    }
+}
+
+static
+void
+ofono_connmgr_bucket_remove(
+    GHashTable* index,
+    gconstpointer key,
+    OfonoConnCtx* ctx)
+{
+    GPtrArray* list = g_hash_table_lookup(index, key);
+    if (list) {
+        gboolean found;
+        const guint pos = ofono_connmgr_context_bsearch(list,
+            ofono_connctx_path(ctx), &found);
+        if (found) {
+            g_ptr_array_remove_index(list, pos);
+            if (!list->len) {
+                g_hash_table_remove(index, key);
             }
         }
     }
-    return -1;
+}
+
+static
+void
+ofono_connmgr_index_context(
+    OfonoConnMgr* self,
+    OfonoConnMgrContextData* data)
+{
+    OfonoConnMgrPriv* priv = self->priv;
+    OfonoConnCtx* ctx = data->context;
+    GASSERT(!data->indexed);
+    data->indexed = TRUE;
+    data->type = ctx->type;
+    ofono_connmgr_bucket_add(priv->valid_by_type, GINT_TO_POINTER(data->type),
+        NULL, ctx);
+    if (ctx->apn) {
+        data->apn = g_strdup(ctx->apn);
+        ofono_connmgr_bucket_add(priv->valid_by_apn, data->apn,
+            (GBoxedCopyFunc)g_strdup, ctx);
+    }
+}
+
+static
+void
+ofono_connmgr_unindex_context(
+    OfonoConnMgr* self,
+    OfonoConnMgrContextData* data)
+{
+    if (data->indexed) {
+        OfonoConnMgrPriv* priv = self->priv;
+        data->indexed = FALSE;
+        ofono_connmgr_bucket_remove(priv->valid_by_type,
+            GINT_TO_POINTER(data->type), data->context);
+        if (data->apn) {
+            ofono_connmgr_bucket_remove(priv->valid_by_apn, data->apn,
+                data->context);
+            g_free(data->apn);
+            data->apn = NULL;
+        }
+    }
+}
+
+static
+void
+ofono_connmgr_context_key_changed(
+    OfonoConnCtx* ctx,
+    void* arg)
+{
+    OfonoConnMgr* self = OFONO_CONNMGR(arg);
+    OfonoConnMgrContextData* data = g_hash_table_lookup(self->priv->
+        all_contexts, ofono_connctx_path(ctx));
+    if (data && data->indexed) {
+        /* Type or APN has changed, move the context to the right buckets */
+        ofono_connmgr_unindex_context(self, data);
+        ofono_connmgr_index_context(self, data);
+    }
+}
+
+static
+void
+ofono_connmgr_clear_indexes(
+    OfonoConnMgr* self)
+{
+    OfonoConnMgrPriv* priv = self->priv;
+    GHashTableIter it;
+    gpointer value;
+    g_hash_table_iter_init(&it, priv->all_contexts);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        OfonoConnMgrContextData* data = value;
+        data->indexed = FALSE;
+        g_free(data->apn);
+        data->apn = NULL;
+    }
+    g_hash_table_remove_all(priv->valid_by_path);
+    g_hash_table_remove_all(priv->valid_by_type);
+    g_hash_table_remove_all(priv->valid_by_apn);
+    g_ptr_array_set_size(priv->valid_contexts, 0);
 }
 
 static
@@ -173,12 +405,32 @@ ofono_connmgr_add_valid_context(
     OfonoConnMgr* self,
     OfonoConnCtx* ctx)
 {
+    OfonoConnMgrPriv* priv = self->priv;
+    const char* path = ofono_connctx_path(ctx);
     GASSERT(ofono_connctx_valid(ctx));
-    if (ofono_connmgr_find_valid_context(self, ofono_connctx_path(ctx)) < 0) {
-        OfonoConnMgrPriv* priv = self->priv;
-        g_ptr_array_add(priv->valid_contexts, ofono_connctx_ref(ctx));
-        g_ptr_array_sort(priv->valid_contexts, ofono_connmgr_context_compare);
+    if (!g_hash_table_contains(priv->valid_by_path, path)) {
+        OfonoConnMgrContextData* data =
+            g_hash_table_lookup(priv->all_contexts, path);
+        gboolean found;
+        const guint pos = ofono_connmgr_context_bsearch(priv->valid_contexts,
+            path, &found);
+
+        GASSERT(!found);
+        g_ptr_array_insert(priv->valid_contexts, pos, ofono_connctx_ref(ctx));
+        g_hash_table_insert(priv->valid_by_path, (gpointer)path, ctx);
+        if (data) {
+            ofono_connmgr_index_context(self, data);
+        }
+        if (priv->batches) {
+            ofono_connmgr_batch_context_valid(self, ctx);
+        }
         if (ofono_connmgr_valid(self)) {
+            OfonoSnapshot* snapshot =
+                ofono_object_snapshot(ofono_connctx_object(ctx));
+            ofono_event_stream_post(ofono_context_of(self),
+                OFONO_EVENT_CONTEXT_ADDED, ofono_connctx_path(ctx), NULL,
+                snapshot);
+            ofono_snapshot_unref(snapshot);
             CONNMGR_OBJECT_SIGNAL_EMIT(self, CONTEXT_ADDED, ctx);
         }
     }
@@ -190,12 +442,25 @@ ofono_connmgr_remove_valid_context(
     OfonoConnMgr* self,
     const char* path)
 {
-    const int index = ofono_connmgr_find_valid_context(self, path);
-    if (index >= 0) {
-        OfonoConnMgrPriv* priv = self->priv;
-        g_ptr_array_remove_index(priv->valid_contexts, index);
-        if (ofono_connmgr_valid(self)) {
-            CONNMGR_OBJECT_SIGNAL_EMIT(self, CONTEXT_REMOVED, path);
+    OfonoConnMgrPriv* priv = self->priv;
+    if (path && g_hash_table_remove(priv->valid_by_path, path)) {
+        OfonoConnMgrContextData* data =
+            g_hash_table_lookup(priv->all_contexts, path);
+        gboolean found;
+        const guint pos = ofono_connmgr_context_bsearch(priv->valid_contexts,
+            path, &found);
+
+        if (data) {
+            ofono_connmgr_unindex_context(self, data);
+        }
+        GASSERT(found);
+        if (found) {
+            g_ptr_array_remove_index(priv->valid_contexts, pos);
+            if (ofono_connmgr_valid(self)) {
+                ofono_event_stream_post(ofono_context_of(self),
+                    OFONO_EVENT_CONTEXT_REMOVED, path, NULL, NULL);
+                CONNMGR_OBJECT_SIGNAL_EMIT(self, CONTEXT_REMOVED, path);
+            }
         }
     }
 }
@@ -226,14 +491,27 @@ ofono_connmgr_add_context(
 {
     if (path && path[0] == '/') {
         OfonoConnMgrPriv* priv = self->priv;
-        OfonoConnCtx* ctx = ofono_connctx_new(path);
+        OfonoContext* context = ofono_context_of(self);
         OfonoConnMgrContextData* data = g_slice_new0(OfonoConnMgrContextData);
-        gpointer key = (gpointer)ofono_connctx_path(ctx);
+        OfonoConnCtx* ctx;
+        gpointer key;
+
+        /* May be invoked by a D-Bus signal with no context pushed */
+        ofono_context_push_thread_default(context);
+        ctx = ofono_connctx_new(path);
+        ofono_context_pop_thread_default(context);
+        key = (gpointer)ofono_connctx_path(ctx);
 
         data->context = ctx;
-        data->valid_handler_id =
+        data->handler_id[CONNCTX_HANDLER_VALID] =
             ofono_connctx_add_valid_changed_handler(ctx,
                 ofono_connmgr_context_valid_changed, self);
+        data->handler_id[CONNCTX_HANDLER_TYPE] =
+            ofono_connctx_add_type_changed_handler(ctx,
+                ofono_connmgr_context_key_changed, self);
+        data->handler_id[CONNCTX_HANDLER_APN] =
+            ofono_connctx_add_apn_changed_handler(ctx,
+                ofono_connmgr_context_key_changed, self);
 
         GASSERT(!g_hash_table_lookup(priv->all_contexts, path));
         g_hash_table_replace(priv->all_contexts, key, data);
@@ -269,6 +547,9 @@ ofono_connmgr_context_removed(
     OfonoConnMgr* self = OFONO_CONNMGR(data);
     OfonoConnMgrPriv* priv = self->priv;
     GVERBOSE_("%s", path);
+    if (priv->batches) {
+        ofono_connmgr_batch_context_removed(self, path);
+    }
     ofono_connmgr_remove_valid_context(self, path);
     g_hash_table_remove(priv->all_contexts, path);
 }
@@ -284,6 +565,7 @@ ofono_connmgr_get_contexts_finished(
     GVariant* contexts = NULL;
     GError* error = NULL;
     OFONO_OBJECT_PROXY* proxy = ORG_OFONO_CONNECTION_MANAGER(proxy_object);
+    OfonoConnMgr* restart = NULL;
     gboolean ok = org_ofono_connection_manager_call_get_contexts_finish(proxy,
         &contexts, result, &error);
     GASSERT(!call->self || call->self->priv->get_contexts_pending == call);
@@ -311,6 +593,10 @@ ofono_connmgr_get_contexts_finished(
             org_ofono_connection_manager_call_get_contexts(proxy,
                 call->cancel, ofono_connmgr_get_contexts_finished, call);
             call = NULL;
+        } else if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            /* The call group has been cancelled, start over */
+            GDEBUG("%s.GetContexts cancelled", OFONO_CONNMGR_INTERFACE_NAME);
+            restart = call->self;
         } else {
             GERR("%s.GetContexts %s", OFONO_CONNMGR_INTERFACE_NAME,
                 GERRMSG(error));
@@ -323,12 +609,17 @@ ofono_connmgr_get_contexts_finished(
             OfonoConnMgrPriv* priv = call->self->priv;
             priv->get_contexts_ok = ok;
             priv->get_contexts_pending = NULL;
-            ofono_connmgr_update_valid(call->self);
+            if (!restart) ofono_connmgr_update_valid(call->self);
         }
+        ofono_call_group_remove(call->group, call->cancel);
+        ofono_call_group_unref(call->group);
         g_object_unref(call->proxy);
         g_object_unref(call->cancel);
         g_slice_free(OfonoConnMgrGetContextsCall, call);
     }
+    if (restart) {
+        ofono_connmgr_start_get_contexts(restart, proxy);
+    }
 }
 
 static
@@ -355,12 +646,17 @@ ofono_connmgr_start_get_contexts(
 
     call = g_slice_new0(OfonoConnMgrGetContextsCall);
     call->cancel = g_cancellable_new();
+    call->group = ofono_call_group_ref(ofono_object_call_group(
+        ofono_connmgr_object(self)));
+    ofono_call_group_add(call->group, call->cancel);
     call->self = self;
     g_object_ref(call->proxy = proxy);
 
     ofono_connmgr_cancel_get_contexts(self);
     priv->get_contexts_ok = FALSE;
     priv->get_contexts_pending = call;
+    ofono_object_prepare_call(ofono_connmgr_object(self),
+        OFONO_CALL_TIMEOUT_DEFAULT);
     org_ofono_connection_manager_call_get_contexts(proxy, call->cancel,
         ofono_connmgr_get_contexts_finished, call);
 }
@@ -393,6 +689,516 @@ ofono_connmgr_proxy_created(
     }
 }
 
+/*==========================================================================*
+ * Async calls
+ *
+ * AddContext calls of a batch are all issued at once. Each context is
+ * configured with a single transaction as soon as it becomes valid,
+ * while the other ones are still being created. AddContext calls are
+ * never cancelled, oFono creates the context anyway. If the batch fails,
+ * each created context is removed as soon as its path is known and the
+ * task completes after all those RemoveContext calls have finished.
+ *==========================================================================*/
+
+static
+void
+ofono_connmgr_batch_free(
+    OfonoConnMgrBatch* batch)
+{
+    guint i;
+    if (batch->cancel_id) {
+        ofono_source_remove(ofono_context_of(batch->self), batch->cancel_id);
+    }
+    if (batch->timeout_id) {
+        ofono_source_remove(ofono_context_of(batch->self), batch->timeout_id);
+    }
+    for (i = 0; i < batch->count; i++) {
+        OfonoConnMgrBatchItem* item = batch->items + i;
+        if (item->context) ofono_connctx_unref(item->context);
+        g_free(item->name);
+        g_free(item->apn);
+        g_free(item->username);
+        g_free(item->password);
+        g_free(item->path);
+    }
+    if (batch->error) g_error_free(batch->error);
+    g_free(batch->items);
+    g_slice_free(OfonoConnMgrBatch, batch);
+}
+
+static
+void
+ofono_connmgr_batch_complete(
+    OfonoConnMgrBatch* batch)
+{
+    OfonoConnMgr* self = batch->self;
+    OfonoConnMgrPriv* priv = self->priv;
+    GTask* task = batch->task;
+    guint i;
+
+    priv->batches = g_slist_remove(priv->batches, batch);
+    if (batch->error) {
+        /* The contexts have already been removed */
+        g_task_return_error(task, batch->error);
+        batch->error = NULL;
+    } else {
+        GPtrArray* contexts = g_ptr_array_new_full(batch->count,
+            g_object_unref);
+        for (i = 0; i < batch->count; i++) {
+            g_ptr_array_add(contexts,
+                ofono_connctx_ref(batch->items[i].context));
+        }
+        g_task_return_pointer(task, contexts,
+            (GDestroyNotify)g_ptr_array_unref);
+    }
+    ofono_connmgr_batch_free(batch);
+    g_object_unref(task);
+}
+
+static
+void
+ofono_connmgr_batch_pending_done(
+    OfonoConnMgrBatch* batch)
+{
+    GASSERT(batch->pending > 0);
+    if (!--batch->pending) {
+        ofono_connmgr_batch_complete(batch);
+    }
+}
+
+static
+void
+ofono_connmgr_batch_item_done(
+    OfonoConnMgrBatchItem* item)
+{
+    GASSERT(!item->done);
+    item->done = TRUE;
+    ofono_connmgr_batch_pending_done(item->batch);
+}
+
+static
+void
+ofono_connmgr_batch_item_removed(
+    GObject* proxy,
+    GAsyncResult* result,
+    gpointer data)
+{
+    GError* error = NULL;
+    if (!org_ofono_connection_manager_call_remove_context_finish(
+        ORG_OFONO_CONNECTION_MANAGER(proxy), result, &error)) {
+        GERR("%s.RemoveContext %s", OFONO_CONNMGR_INTERFACE_NAME,
+            GERRMSG(error));
+        g_error_free(error);
+    }
+    ofono_connmgr_batch_pending_done(data);
+}
+
+static
+void
+ofono_connmgr_batch_item_rollback(
+    OfonoConnMgrBatchItem* item)
+{
+    if (item->path) {
+        OfonoConnMgrBatch* batch = item->batch;
+        OFONO_OBJECT_PROXY* proxy = ofono_connmgr_proxy(batch->self);
+        if (proxy) {
+            /* The batch completes when the context is gone */
+            GDEBUG("Removing %s", item->path);
+            batch->pending++;
+            org_ofono_connection_manager_call_remove_context(proxy,
+                item->path, NULL, ofono_connmgr_batch_item_removed, batch);
+        }
+        g_free(item->path);
+        item->path = NULL;
+    }
+}
+
+static
+void
+ofono_connmgr_batch_fail(
+    OfonoConnMgrBatch* batch,
+    const GError* error)
+{
+    if (!batch->error) {
+        guint i;
+
+        batch->error = g_error_copy(error);
+        batch->pending++;
+        for (i = 0; i < batch->count; i++) {
+            OfonoConnMgrBatchItem* item = batch->items + i;
+
+            /*
+             * Stop waiting for the contexts to become valid. Writes
+             * which are already in progress are left to complete.
+             * Pending AddContext calls roll back their contexts when
+             * they finish.
+             */
+            if (item->path && !item->context && !item->done) {
+                ofono_connmgr_batch_item_done(item);
+            }
+            ofono_connmgr_batch_item_rollback(item);
+        }
+        ofono_connmgr_batch_pending_done(batch);
+    }
+}
+
+static
+void
+ofono_connmgr_batch_fail_all(
+    OfonoConnMgr* self,
+    const GError* error)
+{
+    OfonoConnMgrPriv* priv = self->priv;
+    GSList* l = priv->batches;
+    while (l) {
+        OfonoConnMgrBatch* batch = l->data;
+        l = l->next;
+        ofono_connmgr_batch_fail(batch, error);
+    }
+}
+
+static
+void
+ofono_connmgr_batch_item_configured(
+    OfonoConnCtx* context,
+    const OfonoConnCtxTxResult* results,
+    guint count,
+    const GError* error,
+    void* arg)
+{
+    OfonoConnMgrBatchItem* item = arg;
+    if (error) {
+        GERR("%s configuration failed: %s", ofono_connctx_path(context),
+            GERRMSG(error));
+        ofono_connmgr_batch_fail(item->batch, error);
+    }
+    ofono_connmgr_batch_item_done(item);
+}
+
+static
+void
+ofono_connmgr_batch_item_configure(
+    OfonoConnMgrBatchItem* item,
+    OfonoConnCtx* context)
+{
+    OfonoConnCtxTx* tx = ofono_connctx_tx_new(context);
+    guint writes = 0;
+
+    GASSERT(!item->context);
+    item->context = ofono_connctx_ref(context);
+    writes += ofono_connctx_tx_set_string(tx, OFONO_CONNCTX_PROPERTY_NAME,
+        item->name);
+    writes += ofono_connctx_tx_set_string(tx, OFONO_CONNCTX_PROPERTY_APN,
+        item->apn);
+    writes += ofono_connctx_tx_set_string(tx, OFONO_CONNCTX_PROPERTY_USERNAME,
+        item->username);
+    writes += ofono_connctx_tx_set_string(tx, OFONO_CONNCTX_PROPERTY_PASSWORD,
+        item->password);
+    if (item->protocol > OFONO_CONNCTX_PROTOCOL_NONE) {
+        writes += ofono_connctx_tx_set_protocol(tx, item->protocol);
+    }
+    if (item->auth != OFONO_CONNCTX_AUTH_UNKNOWN) {
+        writes += ofono_connctx_tx_set_auth(tx, item->auth);
+    }
+
+    if (!writes) {
+        /* Nothing to configure */
+        ofono_connctx_tx_free(tx);
+        ofono_connmgr_batch_item_done(item);
+    } else if (!ofono_connctx_tx_commit(tx,
+        ofono_connmgr_batch_item_configured, item)) {
+        /* The transaction has been freed */
+        GError* error = g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
+            "%s is not available", ofono_connctx_path(context));
+        GERR("%s", error->message);
+        ofono_connmgr_batch_fail(item->batch, error);
+        ofono_connmgr_batch_item_done(item);
+        g_error_free(error);
+    }
+}
+
+static
+void
+ofono_connmgr_batch_context_valid(
+    OfonoConnMgr* self,
+    OfonoConnCtx* context)
+{
+    OfonoConnMgrPriv* priv = self->priv;
+    const char* path = ofono_connctx_path(context);
+    GSList* l = priv->batches;
+    while (l) {
+        OfonoConnMgrBatch* batch = l->data;
+        guint i;
+
+        l = l->next;
+        for (i = 0; i < batch->count; i++) {
+            OfonoConnMgrBatchItem* item = batch->items + i;
+            if (!item->done && !item->context && !g_strcmp0(item->path,
+                path)) {
+                ofono_connmgr_batch_item_configure(item, context);
+                break;
+            }
+        }
+    }
+}
+
+static
+void
+ofono_connmgr_batch_context_removed(
+    OfonoConnMgr* self,
+    const char* path)
+{
+    OfonoConnMgrPriv* priv = self->priv;
+    GSList* l = priv->batches;
+    while (l) {
+        OfonoConnMgrBatch* batch = l->data;
+        guint i;
+
+        l = l->next;
+        for (i = 0; i < batch->count; i++) {
+            OfonoConnMgrBatchItem* item = batch->items + i;
+            if (!item->done && !item->context && !g_strcmp0(item->path,
+                path)) {
+                GError* error = g_error_new(G_IO_ERROR, G_IO_ERROR_CLOSED,
+                    "%s has been removed", path);
+
+                /*
+                 * It's not going to become valid. There's nothing to
+                 * roll back for this one, the rest is removed as usual.
+                 * The item keeps the batch alive until it's done.
+                 */
+                GERR("%s", error->message);
+                g_free(item->path);
+                item->path = NULL;
+                ofono_connmgr_batch_fail(batch, error);
+                ofono_connmgr_batch_item_done(item);
+                g_error_free(error);
+                break;
+            }
+        }
+    }
+}
+
+static
+void
+ofono_connmgr_batch_item_added(
+    GObject* proxy,
+    GAsyncResult* result,
+    gpointer data)
+{
+    OfonoConnMgrBatchItem* item = data;
+    OfonoConnMgrBatch* batch = item->batch;
+    GError* error = NULL;
+    char* path = NULL;
+
+    if (org_ofono_connection_manager_call_add_context_finish(
+        ORG_OFONO_CONNECTION_MANAGER(proxy), &path, result, &error)) {
+        GDEBUG("Added %s", path);
+        item->path = path;
+        if (!batch->error) {
+            OfonoConnMgrPriv* priv = batch->self->priv;
+            OfonoConnCtx* context = g_hash_table_lookup(priv->valid_by_path,
+                path);
+
+            /* Otherwise wait for the context to become valid */
+            if (context) {
+                ofono_connmgr_batch_item_configure(item, context);
+            }
+            return;
+        }
+        /* Too late, the batch has failed */
+        ofono_connmgr_batch_item_rollback(item);
+    } else {
+        if (!batch->error) {
+            GERR("%s.AddContext %s", OFONO_CONNMGR_INTERFACE_NAME,
+                GERRMSG(error));
+            ofono_connmgr_batch_fail(batch, error);
+        }
+        g_error_free(error);
+    }
+    ofono_connmgr_batch_item_done(item);
+}
+
+static
+gboolean
+ofono_connmgr_batch_cancelled(
+    GCancellable* cancellable,
+    gpointer arg)
+{
+    OfonoConnMgrBatch* batch = arg;
+    GError* error = NULL;
+    batch->cancel_id = 0;
+    g_cancellable_set_error_if_cancelled(cancellable, &error);
+    ofono_connmgr_batch_fail(batch, error);
+    g_error_free(error);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+ofono_connmgr_batch_timeout(
+    gpointer arg)
+{
+    OfonoConnMgrBatch* batch = arg;
+    GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+        "Timed out waiting for the contexts");
+    GERR("%s", error->message);
+    batch->timeout_id = 0;
+    ofono_connmgr_batch_fail(batch, error);
+    g_error_free(error);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+ofono_connmgr_call_check(
+    OfonoConnMgr* self,
+    GTask* task)
+{
+    if (G_UNLIKELY(!self)) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+            "No connection manager");
+    } else if (!ofono_connmgr_proxy(self)) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
+            "Connection manager is not available");
+    } else if (!g_task_return_error_if_cancelled(task)) {
+        ofono_object_prepare_call(ofono_connmgr_object(self),
+            OFONO_CALL_TIMEOUT_DEFAULT);
+        return TRUE;
+    }
+    g_object_unref(task);
+    return FALSE;
+}
+
+static
+void
+ofono_connmgr_call_finished(
+    GObject* proxy,
+    GAsyncResult* result,
+    gpointer data)
+{
+    GTask* task = G_TASK(data);
+    const OfonoConnMgrCall* call = g_task_get_task_data(task);
+    GError* error = NULL;
+
+    if (call->finish(ORG_OFONO_CONNECTION_MANAGER(proxy), result, &error)) {
+        g_task_return_boolean(task, TRUE);
+    } else {
+        GERR("%s.%s %s", OFONO_CONNMGR_INTERFACE_NAME, call->name,
+            GERRMSG(error));
+        g_task_return_error(task, error);
+    }
+    g_object_unref(task);
+}
+
+static
+void
+ofono_connmgr_provision_op_complete(
+    OfonoConnMgrProvisionOp* op)
+{
+    GTask* task = op->task;
+    guint i;
+
+    if (op->cancel_id) {
+        ofono_source_remove(ofono_context_of(g_task_get_source_object(task)),
+            op->cancel_id);
+    }
+    for (i = 0; i < op->count; i++) {
+        OfonoConnCtx* context = op->items[i].context;
+
+        /* This emits the signals held since the start */
+        ofono_object_release_signals(ofono_connctx_object(context));
+        ofono_connctx_unref(context);
+    }
+    g_free(op->items);
+    if (op->error) {
+        if (!op->cancelled) {
+            g_prefix_error(&op->error, "%u of %u context(s) failed: ",
+                op->failed, op->count);
+        }
+        g_task_return_error(task, op->error);
+    } else {
+        g_task_return_boolean(task, TRUE);
+    }
+    g_slice_free(OfonoConnMgrProvisionOp, op);
+    g_object_unref(task);
+}
+
+static
+void
+ofono_connmgr_provision_item_done(
+    OfonoConnCtx* context,
+    const GError* error,
+    void* arg);
+
+static
+void
+ofono_connmgr_provision_next(
+    OfonoConnMgrProvisionOp* op)
+{
+    while (!op->cancelled && op->pending < op->max_calls &&
+        op->next < op->count) {
+        OfonoConnMgrProvisionItem* item = op->items + (op->next++);
+        item->call = ofono_connctx_provision_full(item->context,
+            ofono_connmgr_provision_item_done, item);
+        if (item->call) {
+            op->pending++;
+        } else {
+            op->failed++;
+            if (!op->error) {
+                op->error = g_error_new(G_IO_ERROR, G_IO_ERROR_FAILED,
+                    "%s is not available", ofono_connctx_path(item->context));
+            }
+        }
+    }
+    if (!op->pending) {
+        ofono_connmgr_provision_op_complete(op);
+    }
+}
+
+static
+void
+ofono_connmgr_provision_item_done(
+    OfonoConnCtx* context,
+    const GError* error,
+    void* arg)
+{
+    OfonoConnMgrProvisionItem* item = arg;
+    OfonoConnMgrProvisionOp* op = item->op;
+    GASSERT(op->pending > 0);
+    item->call = NULL;
+    op->pending--;
+    if (error && !op->cancelled) {
+        op->failed++;
+        if (!op->error) {
+            op->error = g_error_copy(error);
+        }
+    }
+    ofono_connmgr_provision_next(op);
+}
+
+static
+gboolean
+ofono_connmgr_provision_op_cancelled(
+    GCancellable* cancellable,
+    gpointer arg)
+{
+    OfonoConnMgrProvisionOp* op = arg;
+    guint i;
+
+    op->cancel_id = 0;
+    op->cancelled = TRUE;
+    if (op->error) g_error_free(op->error);
+    op->error = NULL;
+    g_cancellable_set_error_if_cancelled(cancellable, &op->error);
+    for (i = 0; i < op->count; i++) {
+        if (op->items[i].call) {
+            g_cancellable_cancel(op->items[i].call);
+        }
+    }
+    return G_SOURCE_REMOVE;
+}
+
 /*==========================================================================*
  * API
  *==========================================================================*/
@@ -456,7 +1262,8 @@ ofono_connmgr_get_contexts(
         for (i=0; i<n; i++) {
             g_ptr_array_add(contexts, ofono_connctx_ref(list->pdata[i]));
         }
-        gutil_idle_pool_add_ptr_array(priv->pool, contexts);
+        ofono_idle_pool_add(ofono_context_of(self), contexts,
+            (GDestroyNotify)g_ptr_array_unref);
     }
     return contexts;
 }
@@ -466,19 +1273,19 @@ ofono_connmgr_get_context_for_type(
     OfonoConnMgr* self,
     OFONO_CONNCTX_TYPE type)
 {
+    OfonoConnCtx* context = NULL;
     if (G_LIKELY(self) && G_LIKELY(type >= OFONO_CONNCTX_TYPE_NONE)) {
         OfonoConnMgrPriv* priv = self->priv;
-        GPtrArray* list = priv->valid_contexts;
-        int i, n = list->len;
-        for (i=0; i<n; i++) {
-            OfonoConnCtx* context = OFONO_CONNCTX(list->pdata[i]);
-            if (context->type == type || type == OFONO_CONNCTX_TYPE_NONE) {
-                gutil_idle_pool_add_object_ref(priv->pool, context);
-                return context;
-            }
+        GPtrArray* list = (type == OFONO_CONNCTX_TYPE_NONE) ?
+            priv->valid_contexts :
+            g_hash_table_lookup(priv->valid_by_type, GINT_TO_POINTER(type));
+        if (list && list->len > 0) {
+            context = OFONO_CONNCTX(list->pdata[0]);
+            ofono_idle_pool_add(ofono_context_of(self), g_object_ref(context),
+                g_object_unref);
         }
     }
-    return NULL;
+    return context;
 }
 
 OfonoConnCtx*
@@ -491,20 +1298,251 @@ ofono_connmgr_get_context_for_path(
         OfonoConnMgrPriv* priv = self->priv;
         GPtrArray* list = priv->valid_contexts;
         if (path) {
-            int i = ofono_connmgr_find_valid_context(self, path);
-            if (i >= 0) {
-                context = OFONO_CONNCTX(list->pdata[i]);
-            }
+            context = g_hash_table_lookup(priv->valid_by_path, path);
         } else if (list->len > 0) {
             context = OFONO_CONNCTX(list->pdata[0]);
         }
         if (context) {
-            gutil_idle_pool_add_object_ref(priv->pool, context);
+            ofono_idle_pool_add(ofono_context_of(self), g_object_ref(context),
+                g_object_unref);
         }
     }
     return context;
 }
 
+OfonoConnCtx*
+ofono_connmgr_get_context_for_apn(
+    OfonoConnMgr* self,
+    const char* apn)
+{
+    OfonoConnCtx* context = NULL;
+    if (G_LIKELY(self) && G_LIKELY(apn)) {
+        OfonoConnMgrPriv* priv = self->priv;
+        GPtrArray* list = g_hash_table_lookup(priv->valid_by_apn, apn);
+        if (list && list->len > 0) {
+            context = OFONO_CONNCTX(list->pdata[0]);
+            ofono_idle_pool_add(ofono_context_of(self), g_object_ref(context),
+                g_object_unref);
+        }
+    }
+    return context;
+}
+
+void
+ofono_connmgr_add_contexts_async(
+    OfonoConnMgr* self,
+    const OfonoConnMgrContextConfig* configs,
+    guint count,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    GTask* task = g_task_new(self, cancellable, callback, user_data);
+    guint i;
+
+    for (i = 0; i < count; i++) {
+        if (!ofono_connctx_type_string(configs[i].type)) {
+            g_task_return_new_error(task, G_IO_ERROR,
+                G_IO_ERROR_INVALID_ARGUMENT, "Invalid context type %d",
+                configs[i].type);
+            g_object_unref(task);
+            return;
+        }
+    }
+    if (ofono_connmgr_call_check(self, task)) {
+        if (count) {
+            OfonoConnMgrPriv* priv = self->priv;
+            OFONO_OBJECT_PROXY* proxy = ofono_connmgr_proxy(self);
+            OfonoConnMgrBatch* batch = g_slice_new0(OfonoConnMgrBatch);
+
+            batch->self = self;
+            batch->task = task;
+            batch->items = g_new0(OfonoConnMgrBatchItem, count);
+            batch->count = batch->pending = count;
+            for (i = 0; i < count; i++) {
+                const OfonoConnMgrContextConfig* config = configs + i;
+                OfonoConnMgrBatchItem* item = batch->items + i;
+
+                item->batch = batch;
+                item->protocol = config->protocol;
+                item->auth = config->auth;
+                item->name = g_strdup(config->name);
+                item->apn = g_strdup(config->apn);
+                item->username = g_strdup(config->username);
+                item->password = g_strdup(config->password);
+            }
+            if (cancellable) {
+                batch->cancel_id = ofono_cancellable_add(
+                    ofono_context_of(self), cancellable,
+                    ofono_connmgr_batch_cancelled, batch);
+            }
+            /* In case some of the contexts never show up */
+            batch->timeout_id = ofono_timeout_add_seconds(
+                ofono_context_of(self), ADD_CONTEXTS_TIMEOUT_SEC,
+                ofono_connmgr_batch_timeout, batch);
+            priv->batches = g_slist_append(priv->batches, batch);
+            GDEBUG("Adding %u context(s)", count);
+            for (i = 0; i < count; i++) {
+                org_ofono_connection_manager_call_add_context(proxy,
+                    ofono_connctx_type_string(configs[i].type),
+                    NULL, ofono_connmgr_batch_item_added,
+                    batch->items + i);
+            }
+        } else {
+            g_task_return_pointer(task, g_ptr_array_new(),
+                (GDestroyNotify)g_ptr_array_unref);
+            g_object_unref(task);
+        }
+    }
+}
+
+GPtrArray*
+ofono_connmgr_add_contexts_finish(
+    OfonoConnMgr* self,
+    GAsyncResult* result,
+    GError** error)
+{
+    GASSERT(g_task_is_valid(result, self));
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+void
+ofono_connmgr_add_context_async(
+    OfonoConnMgr* self,
+    OFONO_CONNCTX_TYPE type,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    OfonoConnMgrContextConfig config;
+    memset(&config, 0, sizeof(config));
+    config.type = type;
+    config.protocol = OFONO_CONNCTX_PROTOCOL_UNKNOWN;
+    config.auth = OFONO_CONNCTX_AUTH_UNKNOWN;
+    ofono_connmgr_add_contexts_async(self, &config, 1, cancellable,
+        callback, user_data);
+}
+
+OfonoConnCtx*
+ofono_connmgr_add_context_finish(
+    OfonoConnMgr* self,
+    GAsyncResult* result,
+    GError** error)
+{
+    GPtrArray* contexts = ofono_connmgr_add_contexts_finish(self, result,
+        error);
+    if (contexts) {
+        OfonoConnCtx* context = ofono_connctx_ref(contexts->pdata[0]);
+        g_ptr_array_unref(contexts);
+        return context;
+    }
+    return NULL;
+}
+
+void
+ofono_connmgr_remove_context_async(
+    OfonoConnMgr* self,
+    const char* path,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    GTask* task = g_task_new(self, cancellable, callback, user_data);
+    if (G_UNLIKELY(!path)) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+            "No context path");
+        g_object_unref(task);
+    } else if (ofono_connmgr_call_check(self, task)) {
+        g_task_set_task_data(task, (gpointer)
+            &ofono_connmgr_call_remove_context, NULL);
+        org_ofono_connection_manager_call_remove_context(
+            ofono_connmgr_proxy(self), path, cancellable,
+            ofono_connmgr_call_finished, task);
+    }
+}
+
+gboolean
+ofono_connmgr_remove_context_finish(
+    OfonoConnMgr* self,
+    GAsyncResult* result,
+    GError** error)
+{
+    GASSERT(g_task_is_valid(result, self));
+    return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+void
+ofono_connmgr_deactivate_all_async(
+    OfonoConnMgr* self,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    GTask* task = g_task_new(self, cancellable, callback, user_data);
+    if (ofono_connmgr_call_check(self, task)) {
+        g_task_set_task_data(task, (gpointer)
+            &ofono_connmgr_call_deactivate_all, NULL);
+        org_ofono_connection_manager_call_deactivate_all(
+            ofono_connmgr_proxy(self), cancellable,
+            ofono_connmgr_call_finished, task);
+    }
+}
+
+gboolean
+ofono_connmgr_deactivate_all_finish(
+    OfonoConnMgr* self,
+    GAsyncResult* result,
+    GError** error)
+{
+    GASSERT(g_task_is_valid(result, self));
+    return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+void
+ofono_connmgr_provision_all(
+    OfonoConnMgr* self,
+    guint max_calls,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    GTask* task = g_task_new(self, cancellable, callback, user_data);
+    if (ofono_connmgr_call_check(self, task)) {
+        GPtrArray* list = self->priv->valid_contexts;
+        OfonoConnMgrProvisionOp* op = g_slice_new0(OfonoConnMgrProvisionOp);
+        guint i;
+
+        op->task = task;
+        op->count = list->len;
+        op->max_calls = max_calls ? max_calls : PROVISION_ALL_MAX_CALLS;
+        op->items = g_new0(OfonoConnMgrProvisionItem, op->count);
+        for (i = 0; i < op->count; i++) {
+            OfonoConnMgrProvisionItem* item = op->items + i;
+            item->op = op;
+            item->context = ofono_connctx_ref(list->pdata[i]);
+            /* Active and Settings changes are reported right away */
+            ofono_object_hold_signals(ofono_connctx_object(item->context),
+                ofono_connmgr_provision_properties);
+        }
+        if (cancellable) {
+            op->cancel_id = ofono_cancellable_add(ofono_context_of(self),
+                cancellable, ofono_connmgr_provision_op_cancelled, op);
+        }
+        GDEBUG("Provisioning %u context(s)", op->count);
+        ofono_connmgr_provision_next(op);
+    }
+}
+
+gboolean
+ofono_connmgr_provision_all_finish(
+    OfonoConnMgr* self,
+    GAsyncResult* result,
+    GError** error)
+{
+    GASSERT(g_task_is_valid(result, self));
+    return g_task_propagate_boolean(G_TASK(result), error);
+}
+
 gulong
 ofono_connmgr_add_valid_changed_handler(
     OfonoConnMgr* self,
@@ -532,7 +1570,7 @@ ofono_connmgr_add_context_added_handler(
     OfonoConnMgrContextAddedHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNMGR_SIGNAL_CONTEXT_ADDED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -542,7 +1580,7 @@ ofono_connmgr_add_context_removed_handler(
     OfonoConnMgrContextRemovedHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNMGR_SIGNAL_CONTEXT_REMOVED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -552,7 +1590,7 @@ ofono_connmgr_add_attached_changed_handler(
     OfonoConnMgrHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNMGR_SIGNAL_ATTACHED_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -562,7 +1600,7 @@ ofono_connmgr_add_roaming_allowed_changed_handler(
     OfonoConnMgrHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNMGR_SIGNAL_ROAMING_ALLOWED_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -572,7 +1610,7 @@ ofono_connmgr_add_powered_changed_handler(
     OfonoConnMgrHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         CONNMGR_SIGNAL_POWERED_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -617,8 +1655,14 @@ ofono_connmgr_ready_changed(
         ofono_connmgr_cancel_get_contexts(self);
         if (!ready) {
             OfonoConnMgrPriv* priv = self->priv;
+            if (priv->batches) {
+                GError* error = g_error_new_literal(G_IO_ERROR,
+                    G_IO_ERROR_CLOSED, "Connection manager is gone");
+                ofono_connmgr_batch_fail_all(self, error);
+                g_error_free(error);
+            }
+            ofono_connmgr_clear_indexes(self);
             g_hash_table_remove_all(priv->all_contexts);
-            g_ptr_array_set_size(priv->valid_contexts, 0);
         }
     }
     OFONO_OBJECT_CLASS(SUPER_CLASS)->fn_ready_changed(object, ready);
@@ -635,8 +1679,12 @@ ofono_connmgr_init(
     OfonoConnMgrPriv* priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
         OFONO_TYPE_CONNMGR, OfonoConnMgrPriv);
     self->priv = priv;
-    priv->pool = gutil_idle_pool_ref(ofono_idle_pool());
     priv->valid_contexts = g_ptr_array_new_with_free_func(g_object_unref);
+    priv->valid_by_path = g_hash_table_new(g_str_hash, g_str_equal);
+    priv->valid_by_type = g_hash_table_new_full(g_direct_hash,
+        g_direct_equal, NULL, (GDestroyNotify)g_ptr_array_unref);
+    priv->valid_by_apn = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify)g_ptr_array_unref);
     priv->all_contexts = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
         ofono_connmgr_context_data_destroy);
 }
@@ -652,9 +1700,11 @@ ofono_connmgr_finalize(
     OfonoConnMgr* self = OFONO_CONNMGR(object);
     OfonoConnMgrPriv* priv = self->priv;
     ofono_connmgr_cancel_get_contexts(self);
-    gutil_idle_pool_unref(priv->pool);
     gutil_disconnect_handlers(ofono_connmgr_proxy(self),
         priv->proxy_handler_id, G_N_ELEMENTS(priv->proxy_handler_id));
+    g_hash_table_destroy(priv->valid_by_path);
+    g_hash_table_destroy(priv->valid_by_type);
+    g_hash_table_destroy(priv->valid_by_apn);
     g_ptr_array_unref(priv->valid_contexts);
     g_hash_table_destroy(priv->all_contexts);
     G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
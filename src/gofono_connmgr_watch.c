@@ -0,0 +1,467 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_connmgr_watch_p.h"
+#include "gofono_context_p.h"
+#include "gofono_util_p.h"
+#include "gofono_names.h"
+#include "gofono_log.h"
+
+#include <gutil_misc.h>
+
+#include <string.h>
+
+#include "org.ofono.ConnectionManager.h"
+
+/* Backoff before the next slot after InProgress, in milliseconds */
+#define SLOT_BACKOFF_MIN (100)
+#define SLOT_BACKOFF_MAX (5000)
+#define SLOT_BACKOFF_MAX_SHIFT (5)
+
+/* Initial guess for the (de)activation time, in microseconds */
+#define SLOT_COMPLETION_TIME_DEFAULT (1000000)
+
+enum connmgr_watch_proxy_handler {
+    PROXY_HANDLER_CONTEXT_ADDED,
+    PROXY_HANDLER_CONTEXT_REMOVED,
+    PROXY_HANDLER_COUNT
+};
+
+typedef struct ofono_connmgr_watch_entry {
+    OfonoConnMgrWatchFunc fn;
+    void* arg;
+} OfonoConnMgrWatchEntry;
+
+typedef struct ofono_connmgr_watch_slot_request {
+    char* path;
+    int priority;
+} OfonoConnMgrWatchSlotRequest;
+
+struct ofono_connmgr_watch {
+    gint ref_count;
+    OfonoContext* context;
+    char* modem_path;
+    guint bus_call_id;
+    GCancellable* cancel;
+    OrgOfonoConnectionManager* proxy;
+    gulong proxy_handler_id[PROXY_HANDLER_COUNT];
+    GHashTable* entries;
+    GList* slot_queue;
+    char* slot_owner;
+    guint slot_grant_id;
+    gint64 slot_not_before;             /* Monotonic time */
+    guint busy_count;                   /* Consecutive InProgress replies */
+    gint64 completion_time;             /* Average, in microseconds */
+};
+
+static
+void
+ofono_connmgr_watch_dispatch(
+    OfonoConnMgrWatch* self,
+    const char* path,
+    OFONO_CONNMGR_WATCH_EVENT event)
+{
+    OfonoConnMgrWatchEntry* entry = g_hash_table_lookup(self->entries, path);
+    if (entry) {
+        entry->fn(self, event, entry->arg);
+    }
+}
+
+static
+void
+ofono_connmgr_watch_slot_request_free(
+    OfonoConnMgrWatchSlotRequest* req)
+{
+    g_free(req->path);
+    g_slice_free(OfonoConnMgrWatchSlotRequest, req);
+}
+
+static
+gint
+ofono_connmgr_watch_slot_request_compare(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const OfonoConnMgrWatchSlotRequest* r1 = a;
+    const OfonoConnMgrWatchSlotRequest* r2 = b;
+    const int diff = (r2->priority > r1->priority) -
+        (r2->priority < r1->priority);
+
+    /*
+     * Higher priority first. g_list_insert_sorted() inserts the new
+     * request (a) in front of the first one which doesn't compare less,
+     * ties return 1 to keep equal ones in order of requests.
+     */
+    return diff ? diff : 1;
+}
+
+static
+gboolean
+ofono_connmgr_watch_grant_slot(
+    gpointer data)
+{
+    OfonoConnMgrWatch* self = data;
+    OfonoConnMgrWatchSlotRequest* req = self->slot_queue->data;
+    GASSERT(!self->slot_owner);
+    self->slot_grant_id = 0;
+    self->slot_queue = g_list_delete_link(self->slot_queue, self->slot_queue);
+    self->slot_owner = req->path;
+    req->path = NULL;
+    ofono_connmgr_watch_slot_request_free(req);
+    GVERBOSE_("%s", self->slot_owner);
+    ofono_connmgr_watch_dispatch(self, self->slot_owner,
+        OFONO_CONNMGR_WATCH_SLOT);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+ofono_connmgr_watch_schedule_slot(
+    OfonoConnMgrWatch* self)
+{
+    if (!self->slot_owner && self->slot_queue && !self->slot_grant_id) {
+        const gint64 delay = self->slot_not_before - g_get_monotonic_time();
+        self->slot_grant_id = (delay > 0) ?
+            ofono_timeout_add(self->context, (guint)((delay + 999) / 1000),
+                ofono_connmgr_watch_grant_slot, self) :
+            ofono_idle_add(self->context, ofono_connmgr_watch_grant_slot,
+                self);
+    }
+}
+
+static
+guint
+ofono_connmgr_watch_backoff(
+    OfonoConnMgrWatch* self)
+{
+    /*
+     * Whatever keeps the modem busy is likely to take about as long
+     * as our own requests do. Wait for half of that, then back off
+     * exponentially.
+     */
+    guint ms = (guint)(self->completion_time / 2000);
+    ms = MAX(ms, SLOT_BACKOFF_MIN);
+    ms <<= MIN(self->busy_count - 1, SLOT_BACKOFF_MAX_SHIFT);
+    return MIN(ms, SLOT_BACKOFF_MAX);
+}
+
+static
+void
+ofono_connmgr_watch_context_added(
+    OrgOfonoConnectionManager* proxy,
+    const char* path,
+    GVariant* properties,
+    OfonoConnMgrWatch* self)
+{
+    ofono_connmgr_watch_dispatch(self, path,
+        OFONO_CONNMGR_WATCH_CONTEXT_ADDED);
+}
+
+static
+void
+ofono_connmgr_watch_context_removed(
+    OrgOfonoConnectionManager* proxy,
+    const char* path,
+    OfonoConnMgrWatch* self)
+{
+    ofono_connmgr_watch_dispatch(self, path,
+        OFONO_CONNMGR_WATCH_CONTEXT_REMOVED);
+}
+
+static
+void
+ofono_connmgr_watch_proxy_created(
+    GObject* source,
+    GAsyncResult* res,
+    gpointer data)
+{
+    GError* err = NULL;
+    OrgOfonoConnectionManager* proxy =
+        org_ofono_connection_manager_proxy_new_finish(res, &err);
+    if (proxy) {
+        /* The watch is still alive, otherwise the call would be cancelled */
+        OfonoConnMgrWatch* self = data;
+        GList* paths;
+        GList* l;
+        GASSERT(!self->proxy);
+        self->proxy = proxy;
+        self->proxy_handler_id[PROXY_HANDLER_CONTEXT_ADDED] =
+            g_signal_connect(proxy, "context-added",
+            G_CALLBACK(ofono_connmgr_watch_context_added), self);
+        self->proxy_handler_id[PROXY_HANDLER_CONTEXT_REMOVED] =
+            g_signal_connect(proxy, "context-removed",
+            G_CALLBACK(ofono_connmgr_watch_context_removed), self);
+        g_object_unref(self->cancel);
+        self->cancel = NULL;
+
+        /* Callbacks may remove entries (and even drop the watch) */
+        self->ref_count++;
+        paths = g_hash_table_get_keys(self->entries);
+        for (l = paths; l; l = l->next) {
+            l->data = g_strdup(l->data);
+        }
+        for (l = paths; l; l = l->next) {
+            ofono_connmgr_watch_dispatch(self, l->data,
+                OFONO_CONNMGR_WATCH_READY);
+        }
+        g_list_free_full(paths, g_free);
+        ofono_connmgr_watch_unref(self);
+    } else if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        GERR("%s", GERRMSG(err));
+    }
+    if (err) g_error_free(err);
+}
+
+static
+void
+ofono_connmgr_watch_bus_ready(
+    OfonoContext* context,
+    GDBusConnection* bus,
+    gpointer data)
+{
+    OfonoConnMgrWatch* self = data;
+    self->bus_call_id = 0;
+    if (bus) {
+        self->cancel = g_cancellable_new();
+        org_ofono_connection_manager_proxy_new(bus,
+            G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES, OFONO_SERVICE,
+            self->modem_path, self->cancel,
+            ofono_connmgr_watch_proxy_created, self);
+    }
+}
+
+static
+OfonoConnMgrWatch*
+ofono_connmgr_watch_create(
+    OfonoContext* context,
+    const char* modem_path)
+{
+    OfonoConnMgrWatch* self = g_slice_new0(OfonoConnMgrWatch);
+    self->ref_count = 1;
+    self->context = context;
+    self->completion_time = SLOT_COMPLETION_TIME_DEFAULT;
+    self->modem_path = g_strdup(modem_path);
+    self->entries = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, g_free);
+    self->bus_call_id = ofono_context_bus_call(context,
+        ofono_connmgr_watch_bus_ready, self);
+    return self;
+}
+
+static
+void
+ofono_connmgr_watch_free(
+    OfonoConnMgrWatch* self)
+{
+    OfonoContext* context = self->context;
+    GASSERT(!g_hash_table_size(self->entries));
+    GASSERT(!self->slot_queue);
+    GASSERT(!self->slot_owner);
+    if (self->slot_grant_id) {
+        ofono_source_remove(context, self->slot_grant_id);
+    }
+    g_hash_table_remove(context->connmgr_watches, self->modem_path);
+    if (g_hash_table_size(context->connmgr_watches) == 0) {
+        g_hash_table_unref(context->connmgr_watches);
+        context->connmgr_watches = NULL;
+    }
+    ofono_context_bus_call_cancel(context, self->bus_call_id);
+    if (self->cancel) {
+        /* ofono_connmgr_watch_proxy_created() won't touch the watch */
+        g_cancellable_cancel(self->cancel);
+        g_object_unref(self->cancel);
+    }
+    if (self->proxy) {
+        gutil_disconnect_handlers(self->proxy, self->proxy_handler_id,
+            G_N_ELEMENTS(self->proxy_handler_id));
+        g_object_unref(self->proxy);
+    }
+    g_hash_table_destroy(self->entries);
+    g_free(self->modem_path);
+    g_slice_free(OfonoConnMgrWatch, self);
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+OfonoConnMgrWatch*
+ofono_connmgr_watch_new(
+    OfonoContext* context,
+    const char* modem_path)
+{
+    /* One instance per modem per library context */
+    OfonoConnMgrWatch* self = NULL;
+    if (context->connmgr_watches) {
+        self = g_hash_table_lookup(context->connmgr_watches, modem_path);
+    }
+    if (self) {
+        self->ref_count++;
+    } else {
+        self = ofono_connmgr_watch_create(context, modem_path);
+        if (!context->connmgr_watches) {
+            context->connmgr_watches = g_hash_table_new(g_str_hash,
+                g_str_equal);
+        }
+        g_hash_table_insert(context->connmgr_watches, self->modem_path, self);
+    }
+    return self;
+}
+
+void
+ofono_connmgr_watch_unref(
+    OfonoConnMgrWatch* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        if (!--self->ref_count) {
+            ofono_connmgr_watch_free(self);
+        }
+    }
+}
+
+gboolean
+ofono_connmgr_watch_ready(
+    OfonoConnMgrWatch* self)
+{
+    return G_LIKELY(self) && self->proxy;
+}
+
+void
+ofono_connmgr_watch_add(
+    OfonoConnMgrWatch* self,
+    const char* path,
+    OfonoConnMgrWatchFunc fn,
+    void* arg)
+{
+    if (G_LIKELY(self) && G_LIKELY(path) && G_LIKELY(fn)) {
+        OfonoConnMgrWatchEntry* entry = g_new(OfonoConnMgrWatchEntry, 1);
+        GASSERT(!g_hash_table_contains(self->entries, path));
+        entry->fn = fn;
+        entry->arg = arg;
+        g_hash_table_replace(self->entries, g_strdup(path), entry);
+    }
+}
+
+void
+ofono_connmgr_watch_remove(
+    OfonoConnMgrWatch* self,
+    const char* path)
+{
+    if (G_LIKELY(self) && G_LIKELY(path)) {
+        ofono_connmgr_watch_cancel_slot(self, path);
+        g_hash_table_remove(self->entries, path);
+    }
+}
+
+void
+ofono_connmgr_watch_request_slot(
+    OfonoConnMgrWatch* self,
+    const char* path,
+    int priority)
+{
+    if (G_LIKELY(self) && G_LIKELY(path)) {
+        OfonoConnMgrWatchSlotRequest* req =
+            g_slice_new(OfonoConnMgrWatchSlotRequest);
+        GASSERT(g_strcmp0(self->slot_owner, path));
+        req->path = g_strdup(path);
+        req->priority = priority;
+        /* Goes after the requests with the same priority */
+        self->slot_queue = g_list_insert_sorted(self->slot_queue, req,
+            ofono_connmgr_watch_slot_request_compare);
+        ofono_connmgr_watch_schedule_slot(self);
+    }
+}
+
+void
+ofono_connmgr_watch_cancel_slot(
+    OfonoConnMgrWatch* self,
+    const char* path)
+{
+    if (G_LIKELY(self) && G_LIKELY(path)) {
+        GList* l;
+        if (!g_strcmp0(self->slot_owner, path)) {
+            g_free(self->slot_owner);
+            self->slot_owner = NULL;
+        }
+        for (l = self->slot_queue; l; l = l->next) {
+            OfonoConnMgrWatchSlotRequest* req = l->data;
+            if (!strcmp(req->path, path)) {
+                self->slot_queue = g_list_delete_link(self->slot_queue, l);
+                ofono_connmgr_watch_slot_request_free(req);
+                break;
+            }
+        }
+        if (!self->slot_queue && self->slot_grant_id) {
+            ofono_source_remove(self->context, self->slot_grant_id);
+            self->slot_grant_id = 0;
+        }
+        ofono_connmgr_watch_schedule_slot(self);
+    }
+}
+
+void
+ofono_connmgr_watch_release_slot(
+    OfonoConnMgrWatch* self,
+    const char* path,
+    gboolean busy,
+    gint64 elapsed_us)
+{
+    if (G_LIKELY(self) && G_LIKELY(path) &&
+        !g_strcmp0(self->slot_owner, path)) {
+        g_free(self->slot_owner);
+        self->slot_owner = NULL;
+        if (busy) {
+            guint delay;
+            self->busy_count++;
+            delay = ofono_connmgr_watch_backoff(self);
+            GDEBUG("Modem %s is busy, waiting %u ms", self->modem_path, delay);
+            self->slot_not_before = g_get_monotonic_time() + delay * 1000;
+        } else {
+            self->busy_count = 0;
+            if (elapsed_us > 0) {
+                /* Exponentially weighted moving average */
+                self->completion_time = (3 * self->completion_time +
+                    elapsed_us) / 4;
+            }
+        }
+        ofono_connmgr_watch_schedule_slot(self);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
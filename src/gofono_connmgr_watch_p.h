@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_CONNMGR_WATCH_PRIVATE_H
+#define GOFONO_CONNMGR_WATCH_PRIVATE_H
+
+#include "gofono_types.h"
+
+/*
+ * ConnectionManager watcher shared by all connection contexts of the
+ * same modem (within the same library context). It owns the only proxy
+ * and the only pair of ContextAdded/ContextRemoved subscriptions per
+ * modem and dispatches those by context path, so that each context only
+ * hears about itself.
+ *
+ * It also serializes activation and deactivation of those contexts.
+ * The modem can only handle one at a time and replies InProgress to
+ * the others. Contexts request a slot and get OFONO_CONNMGR_WATCH_SLOT
+ * event when it's their turn (higher priority first, then in order of
+ * requests). When the modem is busy anyway, the next slot is granted
+ * after a backoff derived from the observed completion times.
+ */
+
+typedef struct ofono_connmgr_watch OfonoConnMgrWatch;
+
+typedef enum ofono_connmgr_watch_event {
+    OFONO_CONNMGR_WATCH_READY,          /* Proxy has been created */
+    OFONO_CONNMGR_WATCH_CONTEXT_ADDED,
+    OFONO_CONNMGR_WATCH_CONTEXT_REMOVED,
+    OFONO_CONNMGR_WATCH_SLOT            /* The context may (de)activate */
+} OFONO_CONNMGR_WATCH_EVENT;
+
+typedef
+void
+(*OfonoConnMgrWatchFunc)(
+    OfonoConnMgrWatch* watch,
+    OFONO_CONNMGR_WATCH_EVENT event,
+    void* arg);
+
+OfonoConnMgrWatch*
+ofono_connmgr_watch_new(
+    OfonoContext* context,
+    const char* modem_path);
+
+void
+ofono_connmgr_watch_unref(
+    OfonoConnMgrWatch* watch);
+
+gboolean
+ofono_connmgr_watch_ready(
+    OfonoConnMgrWatch* watch);
+
+/* One callback per context path */
+void
+ofono_connmgr_watch_add(
+    OfonoConnMgrWatch* watch,
+    const char* path,
+    OfonoConnMgrWatchFunc fn,
+    void* arg);
+
+/* Also cancels the slot request */
+void
+ofono_connmgr_watch_remove(
+    OfonoConnMgrWatch* watch,
+    const char* path);
+
+void
+ofono_connmgr_watch_request_slot(
+    OfonoConnMgrWatch* watch,
+    const char* path,
+    int priority);
+
+void
+ofono_connmgr_watch_cancel_slot(
+    OfonoConnMgrWatch* watch,
+    const char* path);
+
+/* Elapsed time is only used if the modem wasn't busy */
+void
+ofono_connmgr_watch_release_slot(
+    OfonoConnMgrWatch* watch,
+    const char* path,
+    gboolean busy,
+    gint64 elapsed_us);
+
+#endif /* GOFONO_CONNMGR_WATCH_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_context_p.h"
+#include "gofono_snapshot_p.h"
+#include "gofono_util_p.h"
+#include "gofono_names.h"
+#include "gofono_log.h"
+
+#define OFONO_CONTEXT_BUS_RETRY_SEC (5)
+
+/* Stack of contexts pushed by the current thread */
+static GPrivate ofono_context_stack;
+static OfonoContext* ofono_default_context = NULL;
+
+typedef struct ofono_context_bus_waiter {
+    guint id;
+    OfonoContextBusFunc fn;
+    gpointer data;
+} OfonoContextBusWaiter;
+
+static
+GQuark
+ofono_context_quark(void)
+{
+    static GQuark quark = 0;
+    if (G_UNLIKELY(!quark)) {
+        quark = g_quark_from_static_string("ofono-context");
+    }
+    return quark;
+}
+
+static
+void
+ofono_context_free(
+    OfonoContext* self)
+{
+    /* Everything that has been using the context is gone by now */
+    GASSERT(!self->modems);
+    GASSERT(!self->connctxs);
+    GASSERT(!self->connmgr_watches);
+    GASSERT(!self->manager);
+    GASSERT(!self->manager_proxy);
+    GASSERT(!self->event_streams);
+    GASSERT(!self->bus_waiters);
+    GASSERT(!self->bus_cancel); /* ofono_context_bus_ready() holds a ref */
+    GASSERT(!self->bus_retry_id);
+    if (self->loop_prepared) {
+        /* Prepared but never dispatched */
+        g_main_context_release(self->main_context ? self->main_context :
+            g_main_context_default());
+    }
+    ofono_snapshot_release_retired(self);
+    ofono_idle_pool_release(self);
+    gutil_idle_pool_unref(self->pool);
+    if (self->main_context) {
+        g_main_context_unref(self->main_context);
+    }
+    if (self->bus) {
+        g_object_unref(self->bus);
+    }
+    g_slice_free(OfonoContext, self);
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+void
+ofono_context_bind(
+    gpointer object,
+    OfonoContext* context)
+{
+    g_object_set_qdata_full(G_OBJECT(object), ofono_context_quark(),
+        ofono_context_ref(context), (GDestroyNotify)ofono_context_unref);
+}
+
+OfonoContext*
+ofono_context_of(
+    gpointer object)
+{
+    OfonoContext* context = object ?
+        g_object_get_qdata(G_OBJECT(object), ofono_context_quark()) : NULL;
+    return context ? context : ofono_context_current();
+}
+
+static
+void
+ofono_context_notify_bus_waiters(
+    OfonoContext* self)
+{
+    /* Callbacks may add or cancel waiters, detach the list first */
+    GSList* waiters = g_slist_reverse(self->bus_waiters);
+    GSList* l;
+    self->bus_waiters = NULL;
+    ofono_context_ref(self);
+    for (l = waiters; l; l = l->next) {
+        OfonoContextBusWaiter* waiter = l->data;
+        waiter->fn(self, self->bus, waiter->data);
+        g_slice_free(OfonoContextBusWaiter, waiter);
+    }
+    g_slist_free(waiters);
+    ofono_context_unref(self);
+}
+
+static
+void
+ofono_context_bus_ready(
+    GObject* object,
+    GAsyncResult* result,
+    gpointer data);
+
+static
+void
+ofono_context_bus_get(
+    OfonoContext* self)
+{
+    GASSERT(!self->bus_cancel);
+    self->bus_cancel = g_cancellable_new();
+
+    /* The callback is invoked on the thread-default context */
+    g_main_context_push_thread_default(self->main_context);
+    g_bus_get(self->bus_type, self->bus_cancel, ofono_context_bus_ready,
+        ofono_context_ref(self));
+    g_main_context_pop_thread_default(self->main_context);
+}
+
+static
+gboolean
+ofono_context_bus_retry(
+    gpointer data)
+{
+    OfonoContext* self = data;
+    self->bus_retry_id = 0;
+    if (!self->bus && self->bus_waiters && !self->bus_cancel) {
+        ofono_context_bus_get(self);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+ofono_context_bus_ready(
+    GObject* object,
+    GAsyncResult* result,
+    gpointer data)
+{
+    OfonoContext* self = data;
+    GError* error = NULL;
+    GDBusConnection* bus = g_bus_get_finish(result, &error);
+    if (bus) {
+        /* Unless ofono_context_set_bus() has been called in the meantime */
+        if (!self->bus) {
+            g_dbus_connection_set_exit_on_close(bus, FALSE);
+            self->bus = bus;
+        } else {
+            g_object_unref(bus);
+        }
+    } else if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        GERR("%s", GERRMSG(error));
+    }
+    if (error) g_error_free(error);
+    g_object_unref(self->bus_cancel);
+    self->bus_cancel = NULL;
+    if (self->bus) {
+        if (self->bus_waiters) {
+            ofono_context_notify_bus_waiters(self);
+        }
+    } else if (self->bus_waiters) {
+        /* Keep the waiters and try again a bit later */
+        GASSERT(!self->bus_retry_id);
+        self->bus_retry_id = ofono_timeout_add_seconds(self,
+            OFONO_CONTEXT_BUS_RETRY_SEC, ofono_context_bus_retry, self);
+    }
+    ofono_context_unref(self);
+}
+
+guint
+ofono_context_bus_call(
+    OfonoContext* self,
+    OfonoContextBusFunc fn,
+    gpointer data)
+{
+    if (self->bus) {
+        fn(self, self->bus, data);
+        return 0;
+    } else {
+        OfonoContextBusWaiter* waiter = g_slice_new(OfonoContextBusWaiter);
+        waiter->id = ++(self->bus_last_waiter_id);
+        if (!waiter->id) waiter->id = ++(self->bus_last_waiter_id);
+        waiter->fn = fn;
+        waiter->data = data;
+        self->bus_waiters = g_slist_prepend(self->bus_waiters, waiter);
+        if (!self->bus_cancel && !self->bus_retry_id) {
+            ofono_context_bus_get(self);
+        }
+        return waiter->id;
+    }
+}
+
+void
+ofono_context_bus_call_cancel(
+    OfonoContext* self,
+    guint id)
+{
+    if (id) {
+        GSList* l;
+        for (l = self->bus_waiters; l; l = l->next) {
+            OfonoContextBusWaiter* waiter = l->data;
+            if (waiter->id == id) {
+                self->bus_waiters = g_slist_delete_link(self->bus_waiters, l);
+                g_slice_free(OfonoContextBusWaiter, waiter);
+                break;
+            }
+        }
+        if (!self->bus_waiters && self->bus_retry_id) {
+            /* Nobody is waiting anymore */
+            ofono_source_remove(self, self->bus_retry_id);
+            self->bus_retry_id = 0;
+        }
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+OfonoContext*
+ofono_context_new()
+{
+    OfonoContext* self = g_slice_new0(OfonoContext);
+    self->ref_count = 1;
+    self->bus_type = OFONO_BUS_TYPE;
+    self->pool = gutil_idle_pool_new();
+    return self;
+}
+
+OfonoContext*
+ofono_context_ref(
+    OfonoContext* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        g_atomic_int_inc(&self->ref_count);
+    }
+    return self;
+}
+
+void
+ofono_context_unref(
+    OfonoContext* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&self->ref_count)) {
+            ofono_context_free(self);
+        }
+    }
+}
+
+OfonoContext*
+ofono_context_default()
+{
+    if (g_once_init_enter(&ofono_default_context)) {
+        /* The default context is never freed */
+        g_once_init_leave(&ofono_default_context, ofono_context_new());
+    }
+    return ofono_default_context;
+}
+
+OfonoContext*
+ofono_context_get_thread_default()
+{
+    GSList* stack = g_private_get(&ofono_context_stack);
+    return stack ? stack->data : ofono_context_default();
+}
+
+void
+ofono_context_push_thread_default(
+    OfonoContext* context)
+{
+    if (G_LIKELY(context)) {
+        GSList* stack = g_private_get(&ofono_context_stack);
+        g_private_set(&ofono_context_stack, g_slist_prepend(stack,
+            ofono_context_ref(context)));
+    }
+}
+
+void
+ofono_context_pop_thread_default(
+    OfonoContext* context)
+{
+    if (G_LIKELY(context)) {
+        GSList* stack = g_private_get(&ofono_context_stack);
+        GASSERT(stack && stack->data == context);
+        if (stack && stack->data == context) {
+            g_private_set(&ofono_context_stack,
+                g_slist_delete_link(stack, stack));
+            ofono_context_unref(context);
+        }
+    }
+}
+
+void
+ofono_context_set_bus(
+    OfonoContext* self,
+    GDBusConnection* bus)
+{
+    if (G_LIKELY(self) && G_LIKELY(bus) && self->bus != bus) {
+        if (self->bus) {
+            g_object_unref(self->bus);
+        }
+        self->bus = g_object_ref(bus);
+        if (self->bus_retry_id) {
+            ofono_source_remove(self, self->bus_retry_id);
+            self->bus_retry_id = 0;
+        }
+        if (self->bus_cancel) {
+            /* ofono_context_bus_ready() will drop what it gets */
+            g_cancellable_cancel(self->bus_cancel);
+        }
+        ofono_context_notify_bus_waiters(self);
+    }
+}
+
+void
+ofono_context_set_bus_type(
+    OfonoContext* self,
+    GBusType type)
+{
+    if (G_LIKELY(self)) {
+        self->bus_type = type;
+    }
+}
+
+GDBusConnection*
+ofono_context_get_bus(
+    OfonoContext* self)
+{
+    return G_LIKELY(self) ? self->bus : NULL;
+}
+
+int
+ofono_context_loop_prepare(
+    OfonoContext* self,
+    GPollFD* fds,
+    int n_fds,
+    int* timeout)
+{
+    int n = 0, ms = -1;
+    if (G_LIKELY(self)) {
+        GMainContext* mc = self->main_context ? self->main_context :
+            g_main_context_default();
+        /* Prepare may be repeated, but dispatch releases only once */
+        if (self->loop_prepared || g_main_context_acquire(mc)) {
+            const gboolean ready = g_main_context_prepare(mc,
+                &self->loop_priority);
+            n = g_main_context_query(mc, self->loop_priority, &ms,
+                fds, n_fds);
+            if (ready) {
+                /* Something can be dispatched right away */
+                ms = 0;
+            }
+            if (n <= n_fds) {
+                /* Keep it acquired until ofono_context_loop_dispatch() */
+                self->loop_prepared = TRUE;
+            } else {
+                self->loop_prepared = FALSE;
+                g_main_context_release(mc);
+            }
+        } else {
+            GERR("Main context is owned by another thread");
+        }
+    }
+    if (timeout) *timeout = ms;
+    return n;
+}
+
+gboolean
+ofono_context_loop_dispatch(
+    OfonoContext* self,
+    GPollFD* fds,
+    int n_fds)
+{
+    gboolean dispatched = FALSE;
+    if (G_LIKELY(self) && self->loop_prepared) {
+        GMainContext* mc = g_main_context_ref(self->main_context ?
+            self->main_context : g_main_context_default());
+        self->loop_prepared = FALSE;
+        if (g_main_context_check(mc, self->loop_priority, fds, n_fds)) {
+            /* Callbacks may drop the last reference to the context */
+            g_main_context_push_thread_default(mc);
+            ofono_context_push_thread_default(self);
+            g_main_context_dispatch(mc);
+            ofono_context_pop_thread_default(self);
+            g_main_context_pop_thread_default(mc);
+            dispatched = TRUE;
+        }
+        g_main_context_release(mc);
+        g_main_context_unref(mc);
+    }
+    return dispatched;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_CONTEXT_PRIVATE_H
+#define GOFONO_CONTEXT_PRIVATE_H
+
+#include "gofono_context.h"
+
+#include <gutil_idlepool.h>
+
+struct ofono_context {
+    gint ref_count;
+    GDBusConnection* bus;
+    GBusType bus_type;
+    gboolean loop_prepared;             /* See ofono_context_loop_prepare() */
+    gint loop_priority;
+    GCancellable* bus_cancel;           /* Non-NULL while connecting */
+    guint bus_retry_id;                 /* Waiting to connect again */
+    GSList* bus_waiters;                /* See ofono_context_bus_call() */
+    guint bus_last_waiter_id;
+    GMainContext* main_context;         /* NULL for the global default */
+    GUtilIdlePool* pool;
+    GPtrArray* deferred;                /* See ofono_idle_pool_add() */
+    guint deferred_id;
+    GHashTable* modems;
+    GHashTable* connctxs;
+    GHashTable* connmgr_watches;
+    OfonoManager* manager;
+    gpointer manager_proxy;
+    GSList* event_streams;
+    GSList* retired_snapshots;
+    guint reclaim_id;
+};
+
+/* Thread default or the default one, doesn't add a reference */
+#define ofono_context_current() ofono_context_get_thread_default()
+
+void
+ofono_context_bind(
+    gpointer object,
+    OfonoContext* context);
+
+OfonoContext*
+ofono_context_of(
+    gpointer object);
+
+/*
+ * Invokes the callback as soon as the connection is available (right
+ * away if it's already there, in which case zero is returned). Failed
+ * connection attempts are periodically retried for as long as someone is
+ * waiting, so the callback always gets a valid connection.
+ */
+typedef
+void
+(*OfonoContextBusFunc)(
+    OfonoContext* context,
+    GDBusConnection* bus,
+    gpointer data);
+
+guint
+ofono_context_bus_call(
+    OfonoContext* context,
+    OfonoContextBusFunc fn,
+    gpointer data);
+
+void
+ofono_context_bus_call_cancel(
+    OfonoContext* context,
+    guint id);
+
+#endif /* GOFONO_CONTEXT_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
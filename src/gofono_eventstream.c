@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_eventstream_p.h"
+#include "gofono_context_p.h"
+#include "gofono_util_p.h"
+#include "gofono_log.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#define OFONO_EVENT_STREAM_MIN_CAPACITY (16)
+#define OFONO_EVENT_STREAM_FLUSH_DELAY (10) /* ms */
+
+/*
+ * The ring is a single-producer single-consumer queue. The producer is
+ * the thread running the library context the stream was created in,
+ * it's the only one writing the ring and the head. The tail is advanced
+ * by the consumer, and by the producer when it's dropping the oldest
+ * event. Whoever advances the tail owns the event. In coalescing mode
+ * the events which don't fit into the ring wait in the backlog, which
+ * is only touched by the producer.
+ */
+struct ofono_event_stream {
+    OfonoContext* context;
+    OfonoEvent* ring;
+    guint mask;
+    gint head;
+    gint tail;
+    gint dropped;
+    int fd;
+    OFONO_EVENT_STREAM_OVERFLOW overflow;
+    GQueue backlog;
+    GHashTable* backlog_keys;
+    guint flush_id;
+};
+
+static
+OFONO_EVENT_TYPE
+ofono_event_key_type(
+    OFONO_EVENT_TYPE type)
+{
+    /* Added and removed events for the same path replace each other */
+    switch (type) {
+    case OFONO_EVENT_MODEM_REMOVED:
+        return OFONO_EVENT_MODEM_ADDED;
+    case OFONO_EVENT_CONTEXT_REMOVED:
+        return OFONO_EVENT_CONTEXT_ADDED;
+    default:
+        return type;
+    }
+}
+
+static
+guint
+ofono_event_key_hash(
+    gconstpointer key)
+{
+    /* Paths and names are interned */
+    const OfonoEvent* event = key;
+    return (g_direct_hash(event->path) * 31 + g_direct_hash(event->name)) *
+        31 + ofono_event_key_type(event->type);
+}
+
+static
+gboolean
+ofono_event_key_equal(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const OfonoEvent* e1 = a;
+    const OfonoEvent* e2 = b;
+    return e1->path == e2->path && e1->name == e2->name &&
+        ofono_event_key_type(e1->type) == ofono_event_key_type(e2->type);
+}
+
+static
+void
+ofono_event_free(
+    gpointer data)
+{
+    OfonoEvent* event = data;
+    ofono_event_clear(event);
+    g_slice_free(OfonoEvent, event);
+}
+
+static
+gboolean
+ofono_event_stream_push(
+    OfonoEventStream* self,
+    const OfonoEvent* event)
+{
+    const guint capacity = self->mask + 1;
+    for (;;) {
+        /* Nobody else writes the head */
+        const guint head = (guint)self->head;
+        const guint tail = (guint)g_atomic_int_get(&self->tail);
+        if (head - tail < capacity) {
+            self->ring[head & self->mask] = *event;
+            g_atomic_int_set(&self->head, (gint)(head + 1));
+            eventfd_write(self->fd, 1);
+            return TRUE;
+        } else if (self->overflow == OFONO_EVENT_STREAM_DROP_OLDEST) {
+            /* Race with the consumer for the oldest event */
+            OfonoEvent oldest = self->ring[tail & self->mask];
+            if (g_atomic_int_compare_and_exchange(&self->tail, (gint)tail,
+                (gint)(tail + 1))) {
+                ofono_event_clear(&oldest);
+                g_atomic_int_inc(&self->dropped);
+            }
+        } else {
+            return FALSE;
+        }
+    }
+}
+
+static
+void
+ofono_event_stream_flush(
+    OfonoEventStream* self)
+{
+    OfonoEvent* event;
+    while ((event = g_queue_peek_head(&self->backlog)) != NULL &&
+        ofono_event_stream_push(self, event)) {
+        /* The ring now owns the contents of the event */
+        g_hash_table_remove(self->backlog_keys, event);
+        g_queue_pop_head(&self->backlog);
+        g_slice_free(OfonoEvent, event);
+    }
+}
+
+static
+gboolean
+ofono_event_stream_flush_timeout(
+    gpointer data)
+{
+    OfonoEventStream* self = data;
+    ofono_event_stream_flush(self);
+    if (g_queue_is_empty(&self->backlog)) {
+        self->flush_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static
+void
+ofono_event_stream_backlog_remove(
+    OfonoEventStream* self,
+    GList* link)
+{
+    OfonoEvent* queued = link->data;
+    g_hash_table_remove(self->backlog_keys, queued);
+    g_queue_delete_link(&self->backlog, link);
+    ofono_event_free(queued);
+    g_atomic_int_inc(&self->dropped);
+}
+
+static
+void
+ofono_event_stream_backlog_drop_path(
+    OfonoEventStream* self,
+    const char* path)
+{
+    GList* link = self->backlog.head;
+    while (link) {
+        GList* next = link->next;
+        const OfonoEvent* queued = link->data;
+        if (queued->path == path &&
+            (queued->type == OFONO_EVENT_PROPERTY_CHANGED ||
+             queued->type == OFONO_EVENT_VALID_CHANGED)) {
+            ofono_event_stream_backlog_remove(self, link);
+        }
+        link = next;
+    }
+}
+
+static
+void
+ofono_event_stream_add(
+    OfonoEventStream* self,
+    const OfonoEvent* event)
+{
+    /* Backlogged events go first */
+    ofono_event_stream_flush(self);
+    if (!g_queue_is_empty(&self->backlog) ||
+        !ofono_event_stream_push(self, event)) {
+        GList* link = g_hash_table_lookup(self->backlog_keys, event);
+        if (link) {
+            /*
+             * The older event with the same key is replaced by the new
+             * one at the tail, which keeps the events in order. If the
+             * object is gone, its pending changes go too.
+             */
+            ofono_event_stream_backlog_remove(self, link);
+            if (event->type == OFONO_EVENT_MODEM_REMOVED ||
+                event->type == OFONO_EVENT_CONTEXT_REMOVED) {
+                ofono_event_stream_backlog_drop_path(self, event->path);
+            }
+        }
+        g_queue_push_tail(&self->backlog, g_slice_dup(OfonoEvent, event));
+        g_hash_table_insert(self->backlog_keys, self->backlog.tail->data,
+            self->backlog.tail);
+        if (!self->flush_id) {
+            self->flush_id = ofono_timeout_add(self->context,
+                OFONO_EVENT_STREAM_FLUSH_DELAY,
+                ofono_event_stream_flush_timeout, self);
+        }
+    }
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+void
+ofono_event_stream_post(
+    OfonoContext* context,
+    OFONO_EVENT_TYPE type,
+    const char* path,
+    const char* name,
+    OfonoSnapshot* snapshot)
+{
+    if (context->event_streams) {
+        GSList* l;
+        OfonoEvent event;
+        event.type = type;
+        event.path = g_intern_string(path);
+        event.name = g_intern_string(name);
+        for (l = context->event_streams; l; l = l->next) {
+            event.snapshot = ofono_snapshot_ref(snapshot);
+            ofono_event_stream_add(l->data, &event);
+        }
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+OfonoEventStream*
+ofono_event_stream_new(
+    guint capacity,
+    OFONO_EVENT_STREAM_OVERFLOW overflow)
+{
+    OfonoEventStream* self;
+    guint size = OFONO_EVENT_STREAM_MIN_CAPACITY;
+    int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (fd < 0) {
+        GERR("eventfd: %s", strerror(errno));
+        return NULL;
+    }
+
+    /* Power of two makes index wrap-around seamless */
+    while (size < capacity && size < 0x80000000) {
+        size <<= 1;
+    }
+    self = g_slice_new0(OfonoEventStream);
+    self->context = ofono_context_ref(ofono_context_current());
+    self->ring = g_new(OfonoEvent, size);
+    self->mask = size - 1;
+    self->fd = fd;
+    self->overflow = overflow;
+    g_queue_init(&self->backlog);
+    self->backlog_keys = g_hash_table_new(ofono_event_key_hash,
+        ofono_event_key_equal);
+    self->context->event_streams = g_slist_append(self->context->event_streams,
+        self);
+    return self;
+}
+
+void
+ofono_event_stream_free(
+    OfonoEventStream* self)
+{
+    if (G_LIKELY(self)) {
+        OfonoEvent event;
+        gpointer queued;
+        OfonoContext* context = self->context;
+        context->event_streams = g_slist_remove(context->event_streams, self);
+        if (self->flush_id) {
+            ofono_source_remove(context, self->flush_id);
+        }
+        while (ofono_event_stream_pop(self, &event)) {
+            ofono_event_clear(&event);
+        }
+        g_hash_table_destroy(self->backlog_keys);
+        while ((queued = g_queue_pop_head(&self->backlog)) != NULL) {
+            ofono_event_free(queued);
+        }
+        close(self->fd);
+        g_free(self->ring);
+        g_slice_free(OfonoEventStream, self);
+        ofono_context_unref(context);
+    }
+}
+
+int
+ofono_event_stream_fd(
+    OfonoEventStream* self)
+{
+    return G_LIKELY(self) ? self->fd : -1;
+}
+
+/*
+ * Called by the consumer thread. It should read (reset) the descriptor
+ * before taking the events out of the stream, until this returns FALSE.
+ */
+gboolean
+ofono_event_stream_pop(
+    OfonoEventStream* self,
+    OfonoEvent* event)
+{
+    if (G_LIKELY(self) && G_LIKELY(event)) {
+        for (;;) {
+            const guint tail = (guint)g_atomic_int_get(&self->tail);
+            const guint head = (guint)g_atomic_int_get(&self->head);
+            if (tail == head) {
+                break;
+            }
+            /* The copy is only valid if we manage to advance the tail */
+            *event = self->ring[tail & self->mask];
+            if (g_atomic_int_compare_and_exchange(&self->tail, (gint)tail,
+                (gint)(tail + 1))) {
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+guint
+ofono_event_stream_dropped(
+    OfonoEventStream* self)
+{
+    return G_LIKELY(self) ? (guint)g_atomic_int_get(&self->dropped) : 0;
+}
+
+void
+ofono_event_clear(
+    OfonoEvent* event)
+{
+    if (G_LIKELY(event) && event->snapshot) {
+        ofono_snapshot_unref(event->snapshot);
+        event->snapshot = NULL;
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -32,6 +32,7 @@
 
 #include "gofono_manager.h"
 #include "gofono_manager_proxy.h"
+#include "gofono_context_p.h"
 #include "gofono_util_p.h"
 #include "gofono_modem.h"
 #include "gofono_names.h"
@@ -58,9 +59,9 @@ typedef struct ofono_manager_modem_data {
 struct ofono_manager_priv {
     OfonoManagerProxy* proxy;
     gulong proxy_handler_id[PROXY_HANDLER_COUNT];
-    GUtilIdlePool* pool;
     GHashTable* all_modems;
-    GPtrArray* valid_modems;
+    GPtrArray* valid_modems;    /* Sorted by path */
+    GHashTable* valid_index;    /* path => OfonoModem */
 };
 
 typedef GObjectClass OfonoManagerClass;
@@ -97,34 +98,27 @@ ofono_manager_modem_data_destroy(
     g_slice_free(OfonoManagerModemData, data);
 }
 
+/*
+ * valid_modems is kept sorted by path. Returns the position of the modem
+ * in the array or where it should be inserted if it's not there.
+ */
 static
-gint
-ofono_manager_sort_modems(
-    gconstpointer s1,
-    gconstpointer s2)
-{
-    OfonoModem* const* m1 = s1;
-    OfonoModem* const* m2 = s2;
-    return g_strcmp0(ofono_modem_path(*m1), ofono_modem_path(*m2));
-}
-
-static
-int
-ofono_manager_find_valid_modem(
+guint
+ofono_manager_valid_modem_pos(
     OfonoManager* self,
     const char* path)
 {
-    if (path) {
-        OfonoManagerPriv* priv = self->priv;
-        GPtrArray* modems = priv->valid_modems;
-        guint i;
-        for (i=0; i<modems->len; i++) {
-            if (!g_strcmp0(ofono_modem_path(modems->pdata[i]), path)) {
-                return i;
-            }
+    GPtrArray* modems = self->priv->valid_modems;
+    guint lo = 0, hi = modems->len;
+    while (lo < hi) {
+        const guint mid = (lo + hi) / 2;
+        if (strcmp(ofono_modem_path(modems->pdata[mid]), path) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
-    return -1;
+    return lo;
 }
 
 static
@@ -148,11 +142,14 @@ ofono_manager_add_valid_modem(
     OfonoManager* self,
     OfonoModem* modem)
 {
+    const char* path = ofono_modem_path(modem);
     GASSERT(ofono_modem_valid(modem));
-    if (!ofono_manager_has_modem(self, ofono_modem_path(modem))) {
+    if (!ofono_manager_has_modem(self, path)) {
         OfonoManagerPriv* priv = self->priv;
-        g_ptr_array_add(priv->valid_modems, ofono_modem_ref(modem));
-        g_ptr_array_sort(priv->valid_modems, ofono_manager_sort_modems);
+        g_ptr_array_insert(priv->valid_modems,
+            ofono_manager_valid_modem_pos(self, path),
+            ofono_modem_ref(modem));
+        g_hash_table_insert(priv->valid_index, (gpointer)path, modem);
         if (self->valid) {
             g_signal_emit(self, ofono_manager_signals[
                 MANAGER_SIGNAL_MODEM_ADDED], 0, modem);
@@ -166,10 +163,10 @@ ofono_manager_remove_valid_modem(
     OfonoManager* self,
     const char* path)
 {
-    const int index = ofono_manager_find_valid_modem(self, path);
-    if (index >= 0) {
-        OfonoManagerPriv* priv = self->priv;
-        g_ptr_array_remove_index(priv->valid_modems, index);
+    OfonoManagerPriv* priv = self->priv;
+    if (path && g_hash_table_remove(priv->valid_index, path)) {
+        g_ptr_array_remove_index(priv->valid_modems,
+            ofono_manager_valid_modem_pos(self, path));
         g_signal_emit(self, ofono_manager_signals[
             MANAGER_SIGNAL_MODEM_REMOVED], 0, path);
     }
@@ -202,9 +199,16 @@ ofono_manager_add_modem(
     OfonoManagerPriv* priv = self->priv;
     GASSERT(path);
     if (path && path[0] == '/') {
-        OfonoModem* modem = ofono_modem_new(path);
+        OfonoContext* context = ofono_context_of(self);
         OfonoManagerModemData* data = g_slice_new0(OfonoManagerModemData);
-        gpointer key = (gpointer)ofono_modem_path(modem);
+        OfonoModem* modem;
+        gpointer key;
+
+        /* May be invoked by a D-Bus signal with no context pushed */
+        ofono_context_push_thread_default(context);
+        modem = ofono_modem_new(path);
+        ofono_context_pop_thread_default(context);
+        key = (gpointer)ofono_modem_path(modem);
 
         data->modem = modem;
         data->valid_handler_id =
@@ -263,46 +267,41 @@ static
 OfonoManager*
 ofono_manager_create()
 {
-    GError* error = NULL;
-    GDBusConnection* bus = g_bus_get_sync(OFONO_BUS_TYPE, NULL, &error);
-    if (bus) {
-        OfonoManager* self = g_object_new(OFONO_TYPE_MANAGER, NULL);
-        OfonoManagerPriv* priv = self->priv;
-        guint i;
-        priv->proxy = ofono_manager_proxy_new();
-        priv->proxy_handler_id[PROXY_HANDLER_VALID_CHANGED] =
-            ofono_manager_proxy_add_valid_changed_handler(priv->proxy,
-                ofono_manager_proxy_valid_changed, self);
-        priv->proxy_handler_id[PROXY_HANDLER_MODEM_ADDED] =
-            ofono_manager_proxy_add_modem_added_handler(priv->proxy,
-                ofono_manager_modem_added, self);
-        priv->proxy_handler_id[PROXY_HANDLER_MODEM_REMOVED] =
-            ofono_manager_proxy_add_modem_removed_handler(priv->proxy,
-                ofono_manager_modem_removed, self);
-        for (i=0; i<priv->proxy->modem_paths->len; i++) {
-            ofono_manager_add_modem(self, priv->proxy->modem_paths->pdata[i]);
-        }
-        ofono_manager_update_valid(self);
-        return self;
-    } else {
-        GERR("%s", GERRMSG(error));
-        g_error_free(error);
+    OfonoManager* self = g_object_new(OFONO_TYPE_MANAGER, NULL);
+    OfonoManagerPriv* priv = self->priv;
+    guint i;
+    priv->proxy = ofono_manager_proxy_new();
+    priv->proxy_handler_id[PROXY_HANDLER_VALID_CHANGED] =
+        ofono_manager_proxy_add_valid_changed_handler(priv->proxy,
+            ofono_manager_proxy_valid_changed, self);
+    priv->proxy_handler_id[PROXY_HANDLER_MODEM_ADDED] =
+        ofono_manager_proxy_add_modem_added_handler(priv->proxy,
+            ofono_manager_modem_added, self);
+    priv->proxy_handler_id[PROXY_HANDLER_MODEM_REMOVED] =
+        ofono_manager_proxy_add_modem_removed_handler(priv->proxy,
+            ofono_manager_modem_removed, self);
+    for (i=0; i<priv->proxy->modem_paths->len; i++) {
+        ofono_manager_add_modem(self, priv->proxy->modem_paths->pdata[i]);
     }
-    return NULL;
+    ofono_manager_update_valid(self);
+    return self;
 }
 
 OfonoManager*
 ofono_manager_new()
 {
-    static OfonoManager* ofono_manager_instance = NULL;
-    if (ofono_manager_instance) {
-        ofono_manager_ref(ofono_manager_instance);
+    /* One instance per library context */
+    OfonoContext* context = ofono_context_current();
+    if (context->manager) {
+        ofono_manager_ref(context->manager);
     } else {
-        ofono_manager_instance = ofono_manager_create();
-        g_object_add_weak_pointer(G_OBJECT(ofono_manager_instance),
-            (gpointer*)&ofono_manager_instance);
+        context->manager = ofono_manager_create();
+        if (context->manager) {
+            g_object_add_weak_pointer(G_OBJECT(context->manager),
+                (gpointer*)&context->manager);
+        }
     }
-    return ofono_manager_instance;
+    return context->manager;
 }
 
 OfonoManager*
@@ -339,7 +338,8 @@ ofono_manager_get_modems(
         for (i=0; i<list->len; i++) {
             g_ptr_array_add(modems, ofono_modem_ref(list->pdata[i]));
         }
-        gutil_idle_pool_add_ptr_array(priv->pool, modems);
+        ofono_idle_pool_add(ofono_context_of(self), modems,
+            (GDestroyNotify)g_ptr_array_unref);
     }
     return modems;
 }
@@ -349,7 +349,8 @@ ofono_manager_has_modem(
     OfonoManager* self,
     const char* path)
 {
-    return self && ofono_manager_find_valid_modem(self, path) >= 0;
+    return self && path && g_hash_table_contains(self->priv->valid_index,
+        path);
 }
 
 gulong
@@ -358,7 +359,7 @@ ofono_manager_add_valid_changed_handler(
     OfonoManagerHandler cb,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(cb)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(cb)) ? ofono_signal_connect(self,
         MANAGER_SIGNAL_VALID_CHANGED_NAME, G_CALLBACK(cb), arg) : 0;
 }
 
@@ -368,7 +369,7 @@ ofono_manager_add_modem_added_handler(
     OfonoManagerModemAddedHandler cb,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(cb)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(cb)) ? ofono_signal_connect(self,
         MANAGER_SIGNAL_MODEM_ADDED_NAME, G_CALLBACK(cb), arg) : 0;
 }
 
@@ -378,7 +379,7 @@ ofono_manager_add_modem_removed_handler(
     OfonoManagerModemRemovedHandler cb,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(cb)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(cb)) ? ofono_signal_connect(self,
         MANAGER_SIGNAL_MODEM_REMOVED_NAME, G_CALLBACK(cb), arg) : 0;
 }
 
@@ -457,8 +458,9 @@ ofono_manager_init(
     OfonoManagerPriv* priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
         OFONO_TYPE_MANAGER, OfonoManagerPriv);
     self->priv = priv;
-    priv->pool = gutil_idle_pool_ref(ofono_idle_pool());
+    ofono_context_bind(self, ofono_context_current());
     priv->valid_modems = g_ptr_array_new_with_free_func(g_object_unref);
+    priv->valid_index = g_hash_table_new(g_str_hash, g_str_equal);
     priv->all_modems = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
         ofono_manager_modem_data_destroy);
 }
@@ -475,6 +477,7 @@ ofono_manager_dispose(
     OfonoManager* self = OFONO_MANAGER(object);
     OfonoManagerPriv* priv = self->priv;
     self->valid = FALSE;
+    g_hash_table_remove_all(priv->valid_index);
     g_ptr_array_set_size(priv->valid_modems, 0);
     g_hash_table_remove_all(priv->all_modems);
     gutil_disconnect_handlers(priv->proxy, priv->proxy_handler_id,
@@ -492,7 +495,7 @@ ofono_manager_finalize(
 {
     OfonoManager* self = OFONO_MANAGER(object);
     OfonoManagerPriv* priv = self->priv;
-    gutil_idle_pool_unref(priv->pool);
+    g_hash_table_destroy(priv->valid_index);
     g_ptr_array_unref(priv->valid_modems);
     g_hash_table_destroy(priv->all_modems);
     g_object_unref(priv->proxy);
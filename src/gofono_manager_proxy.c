@@ -32,7 +32,10 @@
 
 #include "gofono_manager_proxy.h"
 #include "gofono_modem_p.h"
+#include "gofono_context_p.h"
 #include "gofono_error_p.h"
+#include "gofono_eventstream_p.h"
+#include "gofono_util_p.h"
 #include "gofono_names.h"
 #include "gofono_log.h"
 
@@ -57,11 +60,13 @@ enum proxy_handler_id {
 
 struct ofono_manager_proxy_priv {
     GDBusConnection* bus;
+    guint bus_call_id;
     OrgOfonoManager* proxy;
     GCancellable* cancel;
     guint get_modems_retry_id;
     guint ofono_watch_id;
     gulong proxy_handler_id[PROXY_HANDLER_COUNT];
+    GHashTable* modem_index;    /* Keys are owned by modem_paths */
 };
 
 typedef GObjectClass OfonoManagerProxyClass;
@@ -94,33 +99,27 @@ ofono_manager_proxy_get_modems_finished(
  * Implementation
  *==========================================================================*/
 
+/*
+ * modem_paths is kept sorted. Returns the position of the path in
+ * the array or where it should be inserted if it's not there.
+ */
 static
-gint
-ofono_manager_proxy_sort_modems(
-    gconstpointer a,
-    gconstpointer b)
-{
-    const char* const* s1 = a;
-    const char* const* s2 = b;
-    return g_strcmp0(*s1, *s2);
-}
-
-static
-int
-ofono_manager_proxy_modem_index(
+guint
+ofono_manager_proxy_modem_pos(
     OfonoManagerProxy* self,
     const char* path)
 {
-    if (path) {
-        guint i;
-        GPtrArray* list = self->modem_paths;
-        for (i=0; i<list->len; i++) {
-            if (!g_strcmp0(list->pdata[i], path)) {
-                return i;
-            }
+    GPtrArray* list = self->modem_paths;
+    guint lo = 0, hi = list->len;
+    while (lo < hi) {
+        const guint mid = (lo + hi) / 2;
+        if (strcmp(list->pdata[mid], path) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
-    return -1;
+    return lo;
 }
 
 static
@@ -129,6 +128,7 @@ ofono_manager_proxy_reset(
     OfonoManagerProxy* self)
 {
     OfonoManagerProxyPriv* priv = self->priv;
+    g_hash_table_remove_all(priv->modem_index);
     g_ptr_array_set_size(self->modem_paths, 0);
     if (priv->cancel) {
         g_cancellable_cancel(priv->cancel);
@@ -142,7 +142,8 @@ ofono_manager_proxy_reset(
         priv->proxy = NULL;
     }
     if (priv->get_modems_retry_id) {
-        g_source_remove(priv->get_modems_retry_id);
+        ofono_source_remove(ofono_context_of(self),
+            priv->get_modems_retry_id);
         priv->get_modems_retry_id = 0;
     }
     if (self->valid) {
@@ -158,9 +159,14 @@ ofono_manager_proxy_add_modem(
     OfonoManagerProxy* self,
     const char* path)
 {
-    if (ofono_manager_proxy_modem_index(self, path) < 0) {
-        g_ptr_array_add(self->modem_paths, g_strdup(path));
-        g_ptr_array_sort(self->modem_paths, ofono_manager_proxy_sort_modems);
+    OfonoManagerProxyPriv* priv = self->priv;
+    if (path && !g_hash_table_contains(priv->modem_index, path)) {
+        char* copy = g_strdup(path);
+        g_ptr_array_insert(self->modem_paths,
+            ofono_manager_proxy_modem_pos(self, path), copy);
+        g_hash_table_add(priv->modem_index, copy);
+        ofono_event_stream_post(ofono_context_of(self),
+            OFONO_EVENT_MODEM_ADDED, path, NULL, NULL);
         g_signal_emit(self, ofono_manager_proxy_signals[
             SIGNAL_MODEM_ADDED], 0, path);
     }
@@ -188,11 +194,15 @@ ofono_manager_proxy_modem_removed(
     gpointer data)
 {
     OfonoManagerProxy* self = OFONO_MANAGER_PROXY(data);
-    int index = ofono_manager_proxy_modem_index(self, path);
+    OfonoManagerProxyPriv* priv = self->priv;
+    const gboolean known = path && g_hash_table_remove(priv->modem_index, path);
     GVERBOSE_("%s", path);
-    GASSERT(index >= 0);
-    if (index >= 0) {
-        g_ptr_array_remove_index(self->modem_paths, index);
+    GASSERT(known);
+    if (known) {
+        g_ptr_array_remove_index(self->modem_paths,
+            ofono_manager_proxy_modem_pos(self, path));
+        ofono_event_stream_post(ofono_context_of(self),
+            OFONO_EVENT_MODEM_REMOVED, path, NULL, NULL);
         g_signal_emit(self, ofono_manager_proxy_signals[
             SIGNAL_MODEM_REMOVED], 0, path);
     }
@@ -263,8 +273,8 @@ ofono_manager_proxy_get_modems_finished(
         /* Wait a bit, then retry */
         GERR("%s.GetModems %s", OFONO_MANAGER_INTERFACE_NAME, GERRMSG(error));
         GASSERT(!priv->get_modems_retry_id);
-        priv->get_modems_retry_id = g_timeout_add(GET_MODEMS_RETRY_DELAY,
-            ofono_manager_proxy_get_modems_retry, self);
+        priv->get_modems_retry_id = ofono_timeout_add(ofono_context_of(self),
+            GET_MODEMS_RETRY_DELAY, ofono_manager_proxy_get_modems_retry, self);
     }
 
     if (error) g_error_free(error);
@@ -337,6 +347,31 @@ ofono_manager_proxy_vanished(
     ofono_manager_proxy_reset(self);
 }
 
+static
+void
+ofono_manager_proxy_bus_ready(
+    OfonoContext* context,
+    GDBusConnection* bus,
+    gpointer data)
+{
+    OfonoManagerProxy* self = OFONO_MANAGER_PROXY(data);
+    OfonoManagerProxyPriv* priv = self->priv;
+    priv->bus_call_id = 0;
+    if (bus) {
+        GASSERT(!priv->bus);
+        priv->bus = g_object_ref(bus);
+        if (g_dbus_connection_get_unique_name(bus)) {
+            priv->ofono_watch_id = g_bus_watch_name_on_connection(bus,
+                OFONO_SERVICE, G_BUS_NAME_WATCHER_FLAGS_NONE,
+                ofono_manager_proxy_appeared, ofono_manager_proxy_vanished,
+                self, NULL);
+        } else {
+            /* Peer-to-peer connection, nothing to watch */
+            ofono_manager_proxy_appeared(bus, OFONO_SERVICE, "peer", self);
+        }
+    }
+}
+
 /*==========================================================================*
  * API
  *==========================================================================*/
@@ -345,36 +380,28 @@ static
 OfonoManagerProxy*
 ofono_manager_proxy_create()
 {
-    GError* error = NULL;
-    GDBusConnection* bus = g_bus_get_sync(OFONO_BUS_TYPE, NULL, &error);
-    if (bus) {
-        OfonoManagerProxy* self = g_object_new(OFONO_TYPE_MANAGER_PROXY, NULL);
-        OfonoManagerProxyPriv* priv = self->priv;
-        priv->bus = bus;
-        priv->ofono_watch_id = g_bus_watch_name_on_connection(bus,
-            OFONO_SERVICE, G_BUS_NAME_WATCHER_FLAGS_NONE,
-            ofono_manager_proxy_appeared, ofono_manager_proxy_vanished,
-            self, NULL);
-        return self;
-    } else {
-        GERR("%s", GERRMSG(error));
-        g_error_free(error);
-    }
-    return NULL;
+    OfonoManagerProxy* self = g_object_new(OFONO_TYPE_MANAGER_PROXY, NULL);
+    OfonoManagerProxyPriv* priv = self->priv;
+    priv->bus_call_id = ofono_context_bus_call(ofono_context_of(self),
+        ofono_manager_proxy_bus_ready, self);
+    return self;
 }
 
 OfonoManagerProxy*
 ofono_manager_proxy_new()
 {
-    static OfonoManagerProxy* ofono_manager_proxy_instance = NULL;
-    if (ofono_manager_proxy_instance) {
-        g_object_ref(ofono_manager_proxy_instance);
+    /* One instance per library context */
+    OfonoContext* context = ofono_context_current();
+    if (context->manager_proxy) {
+        g_object_ref(context->manager_proxy);
     } else {
-        ofono_manager_proxy_instance = ofono_manager_proxy_create();
-        g_object_add_weak_pointer(G_OBJECT(ofono_manager_proxy_instance),
-            (gpointer*)(&ofono_manager_proxy_instance));
+        context->manager_proxy = ofono_manager_proxy_create();
+        if (context->manager_proxy) {
+            g_object_add_weak_pointer(G_OBJECT(context->manager_proxy),
+                &context->manager_proxy);
+        }
     }
-    return ofono_manager_proxy_instance;
+    return context->manager_proxy;
 }
 
 gboolean
@@ -382,7 +409,8 @@ ofono_manager_proxy_has_modem(
     OfonoManagerProxy* self,
     const char* path)
 {
-    return self && ofono_manager_proxy_modem_index(self, path) >= 0;
+    return self && path && g_hash_table_contains(self->priv->modem_index,
+        path);
 }
 
 gulong
@@ -391,7 +419,7 @@ ofono_manager_proxy_add_valid_changed_handler(
     OfonoManagerProxyHandler cb,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(cb)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(cb)) ? ofono_signal_connect(self,
         SIGNAL_VALID_CHANGED_NAME, G_CALLBACK(cb), arg) : 0;
 }
 
@@ -401,7 +429,7 @@ ofono_manager_proxy_add_modem_added_handler(
     OfonoManagerProxyModemHandler cb,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(cb)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(cb)) ? ofono_signal_connect(self,
         SIGNAL_MODEM_ADDED_NAME, G_CALLBACK(cb), arg) : 0;
 }
 
@@ -411,7 +439,7 @@ ofono_manager_proxy_add_modem_removed_handler(
     OfonoManagerProxyModemHandler cb,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(cb)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(cb)) ? ofono_signal_connect(self,
         SIGNAL_MODEM_REMOVED_NAME, G_CALLBACK(cb), arg) : 0;
 }
 
@@ -427,9 +455,11 @@ void
 ofono_manager_proxy_init(
     OfonoManagerProxy* self)
 {
+    ofono_context_bind(self, ofono_context_current());
     self->modem_paths = g_ptr_array_new_with_free_func(g_free);
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE(self, OFONO_TYPE_MANAGER_PROXY,
         OfonoManagerProxyPriv);
+    self->priv->modem_index = g_hash_table_new(g_str_hash, g_str_equal);
 }
 
 /**
@@ -444,6 +474,11 @@ ofono_manager_proxy_dispose(
     OfonoManagerProxy* self = OFONO_MANAGER_PROXY(object);
     OfonoManagerProxyPriv* priv = self->priv;
     ofono_manager_proxy_reset(self);
+    if (priv->bus_call_id) {
+        ofono_context_bus_call_cancel(ofono_context_of(self),
+            priv->bus_call_id);
+        priv->bus_call_id = 0;
+    }
     if (priv->ofono_watch_id) {
         g_bus_unwatch_name(priv->ofono_watch_id);
         priv->ofono_watch_id = 0;
@@ -462,8 +497,9 @@ ofono_manager_proxy_finalize(
     OfonoManagerProxy* self = OFONO_MANAGER_PROXY(object);
     OfonoManagerProxyPriv* priv = self->priv;
     GVERBOSE_("");
+    g_hash_table_destroy(priv->modem_index);
     g_ptr_array_unref(self->modem_paths);
-    g_object_unref(priv->bus);
+    if (priv->bus) g_object_unref(priv->bus);
     G_OBJECT_CLASS(ofono_manager_proxy_parent_class)->finalize(object);
 }
 
@@ -33,6 +33,9 @@
 #include "gofono_modem_p.h"
 #include "gofono_modemintf.h"
 #include "gofono_manager_proxy.h"
+#include "gofono_context_p.h"
+#include "gofono_snapshot_p.h"
+#include "gofono_util_p.h"
 #include "gofono_names.h"
 #include "gofono_log.h"
 
@@ -81,7 +84,6 @@ G_DEFINE_TYPE(OfonoModem, ofono_modem, OFONO_TYPE_OBJECT)
 #define MODEM_SIGNAL_INTERFACES_CHANGED_NAME    "interfaces-changed"
 #define MODEM_SIGNAL_TYPE_CHANGED_NAME          "type-changed"
 
-static GHashTable* ofono_modem_table = NULL;
 
 /*==========================================================================*
  * Implementation
@@ -122,14 +124,15 @@ ofono_modem_destroyed(
     gpointer key,
     GObject* modem)
 {
-    GASSERT(ofono_modem_table);
+    OfonoContext* context = ofono_context_of(modem);
+    GASSERT(context->modems);
     GVERBOSE_("%s", (char*)key);
-    if (ofono_modem_table) {
-        GASSERT(g_hash_table_lookup(ofono_modem_table, key) == modem);
-        g_hash_table_remove(ofono_modem_table, key);
-        if (g_hash_table_size(ofono_modem_table) == 0) {
-            g_hash_table_unref(ofono_modem_table);
-            ofono_modem_table = NULL;
+    if (context->modems) {
+        GASSERT(g_hash_table_lookup(context->modems, key) == modem);
+        g_hash_table_remove(context->modems, key);
+        if (g_hash_table_size(context->modems) == 0) {
+            g_hash_table_unref(context->modems);
+            context->modems = NULL;
         }
     }
 }
@@ -154,6 +157,7 @@ ofono_modem_removed(
     OfonoModem* self = OFONO_MODEM(arg);
     if (!g_strcmp0(path, ofono_modem_path(self))) {
         GDEBUG("Modem '%s' is gone", path);
+        ofono_modem_cancel_calls(self);
         ofono_modem_update_ready(self);
     }
 }
@@ -209,8 +213,9 @@ OfonoModem*
 ofono_modem_new(
     const char* path)
 {
-    OfonoModem* modem = (path && ofono_modem_table) ?
-        ofono_modem_ref(g_hash_table_lookup(ofono_modem_table, path)) : NULL;
+    OfonoContext* context = ofono_context_current();
+    OfonoModem* modem = (path && context->modems) ?
+        ofono_modem_ref(g_hash_table_lookup(context->modems, path)) : NULL;
     if (!modem) {
         OfonoObject* object;
         OfonoModemPriv* priv;
@@ -221,11 +226,11 @@ ofono_modem_new(
 
         ofono_object_initialize(object, OFONO_MODEM_INTERFACE_NAME, path);
         priv->id = ofono_object_name(object);
-        if (!ofono_modem_table) {
-            ofono_modem_table = g_hash_table_new_full(g_str_hash,
+        if (!context->modems) {
+            context->modems = g_hash_table_new_full(g_str_hash,
                 g_str_equal, g_free, NULL);
         }
-        g_hash_table_replace(ofono_modem_table, key, modem);
+        g_hash_table_replace(context->modems, key, modem);
         g_object_weak_ref(G_OBJECT(modem), ofono_modem_destroyed, key);
         ofono_modem_update_ready(modem);
         GDEBUG("Modem '%s'", path);
@@ -326,7 +331,7 @@ ofono_modem_add_powered_changed_handler(
     OfonoModemHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         MODEM_SIGNAL_POWERED_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -336,7 +341,7 @@ ofono_modem_add_online_changed_handler(
     OfonoModemHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         MODEM_SIGNAL_ONLINE_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -346,7 +351,7 @@ ofono_modem_add_lockdown_changed_handler(
     OfonoModemHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         MODEM_SIGNAL_LOCKDOWN_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -356,7 +361,7 @@ ofono_modem_add_emergency_changed_handler(
     OfonoModemHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         MODEM_SIGNAL_EMERGENCY_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -366,7 +371,7 @@ ofono_modem_add_interfaces_changed_handler(
     OfonoModemHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         MODEM_SIGNAL_INTERFACES_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -396,6 +401,22 @@ ofono_modem_set_online(
     return ofono_modem_set_online_full(modem, online, NULL, NULL) != NULL;
 }
 
+void
+ofono_modem_cancel_calls(
+    OfonoModem* modem)
+{
+    /* Interfaces and contexts share the call group with their modem */
+    ofono_call_group_cancel(ofono_object_call_group(ofono_modem_object(modem)));
+}
+
+OfonoModemSnapshot*
+ofono_modem_snapshot(
+    OfonoModem* modem)
+{
+    OfonoSnapshot* snapshot = ofono_object_snapshot(ofono_modem_object(modem));
+    return snapshot ? G_CAST(snapshot, OfonoModemSnapshot, snapshot) : NULL;
+}
+
 GCancellable*
 ofono_modem_set_powered_full(
     OfonoModem* modem,
@@ -472,6 +493,29 @@ ofono_modem_is_valid(
         OFONO_OBJECT_CLASS(SUPER_CLASS)->fn_is_valid(object);
 }
 
+static
+OfonoSnapshot*
+ofono_modem_snapshot_new(
+    OfonoObject* object)
+{
+    OfonoModem* self = OFONO_MODEM(object);
+    OfonoSnapshot* snapshot = ofono_snapshot_new(sizeof(OfonoModemSnapshot));
+    OfonoModemSnapshot* copy = G_CAST(snapshot, OfonoModemSnapshot, snapshot);
+    copy->powered = self->powered;
+    copy->online = self->online;
+    copy->lockdown = self->lockdown;
+    copy->emergency = self->emergency;
+    copy->name = ofono_snapshot_strdup(snapshot, self->name);
+    copy->manufacturer = ofono_snapshot_strdup(snapshot, self->manufacturer);
+    copy->model = ofono_snapshot_strdup(snapshot, self->model);
+    copy->revision = ofono_snapshot_strdup(snapshot, self->revision);
+    copy->serial = ofono_snapshot_strdup(snapshot, self->serial);
+    copy->features = ofono_snapshot_strv(snapshot, self->features);
+    copy->interfaces = ofono_snapshot_strv(snapshot, self->interfaces);
+    copy->type = ofono_snapshot_strdup(snapshot, self->type);
+    return snapshot;
+}
+
 /**
  * Per instance initializer
  */
@@ -482,7 +526,10 @@ ofono_modem_init(
 {
     OfonoModemPriv* priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
         OFONO_TYPE_MODEM, OfonoModemPriv);
+    OfonoCallGroup* group = ofono_call_group_new();
     self->priv = priv;
+    ofono_object_set_call_group(&self->object, group);
+    ofono_call_group_unref(group);
     priv->manager = ofono_manager_proxy_new();
     priv->manager_handler_id[MANAGER_HANDLER_VALID_CHANGED] =
         ofono_manager_proxy_add_valid_changed_handler(priv->manager,
@@ -555,6 +602,7 @@ ofono_modem_class_init(
 
     klass->fn_is_ready = ofono_modem_is_ready;
     klass->fn_is_valid = ofono_modem_is_valid;
+    klass->fn_snapshot = ofono_modem_snapshot_new;
     klass->properties = ofono_modem_properties;
     klass->nproperties = G_N_ELEMENTS(ofono_modem_properties);
     G_OBJECT_CLASS(klass)->finalize = ofono_modem_finalize;
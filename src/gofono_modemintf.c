@@ -101,6 +101,8 @@ ofono_modem_interface_initialize(
      * before GetProperties query completes for the modem interface object. */
     GASSERT(!self->modem);
     self->modem = ofono_modem_new(path);
+    ofono_object_set_call_group(&self->object,
+        ofono_object_call_group(ofono_modem_object(self->modem)));
     ofono_object_initialize(&self->object, intf, path);
     priv->modem_handler_id[MODEM_HANDLER_INTERFACES_CHANGED] =
         ofono_modem_add_interfaces_changed_handler(self->modem,
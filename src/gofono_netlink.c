@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_netlink_p.h"
+#include "gofono_log.h"
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#define OFONO_NETLINK_BUF_SIZE (32768)
+#define OFONO_NETLINK_TIMEOUT_SEC (2)
+
+struct ofono_netlink {
+    int fd;
+    guint32 seq;
+    guint8* buf;
+};
+
+static
+int
+ofono_netlink_send(
+    OfonoNetlink* self,
+    OfonoNetlinkMsg* msg)
+{
+    struct sockaddr_nl addr;
+    struct nlmsghdr* hdr = &msg->u.hdr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    hdr->nlmsg_seq = ++(self->seq);
+    if (sendto(self->fd, hdr, hdr->nlmsg_len, 0, (struct sockaddr*)&addr,
+        sizeof(addr)) < 0) {
+        const int err = errno;
+        GERR("Netlink send error: %s", strerror(err));
+        return -err;
+    }
+    return 0;
+}
+
+/* Returns 1 when the sequence is finished, 0 to keep reading, or -errno */
+static
+int
+ofono_netlink_receive(
+    OfonoNetlink* self,
+    OfonoNetlinkDumpFunc fn,
+    void* arg)
+{
+    struct nlmsghdr* hdr;
+    ssize_t len;
+    int n;
+
+    do {
+        len = recv(self->fd, self->buf, OFONO_NETLINK_BUF_SIZE, 0);
+    } while (len < 0 && errno == EINTR);
+
+    if (len < 0) {
+        const int err = errno;
+        if (err == EAGAIN || err == EWOULDBLOCK) {
+            /* SO_RCVTIMEO has expired, the kernel isn't answering */
+            GERR("Netlink receive timeout");
+            return -ETIMEDOUT;
+        } else if (err == ENOBUFS) {
+            /* Some of the replies have been dropped, can't trust the rest */
+            GERR("Netlink receive buffer overrun");
+            return -ENOBUFS;
+        }
+        GERR("Netlink receive error: %s", strerror(err));
+        return -err;
+    }
+
+    n = (int)len;
+    for (hdr = (struct nlmsghdr*)self->buf; NLMSG_OK(hdr, n);
+         hdr = NLMSG_NEXT(hdr, n)) {
+        if (hdr->nlmsg_seq != self->seq) {
+            /* Stale reply to something we have given up on */
+            continue;
+        } else if (hdr->nlmsg_type == NLMSG_DONE) {
+            return 1;
+        } else if (hdr->nlmsg_type == NLMSG_ERROR) {
+            const struct nlmsgerr* err = NLMSG_DATA(hdr);
+            return err->error ? err->error : 1;
+        } else if (fn) {
+            fn(hdr, arg);
+        }
+    }
+    return 0;
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+OfonoNetlink*
+ofono_netlink_new()
+{
+    const int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC,
+        NETLINK_ROUTE);
+    if (fd >= 0) {
+        struct sockaddr_nl addr;
+        struct timeval tv;
+        memset(&addr, 0, sizeof(addr));
+        memset(&tv, 0, sizeof(tv));
+        addr.nl_family = AF_NETLINK;
+        tv.tv_sec = OFONO_NETLINK_TIMEOUT_SEC;
+        /* The requests are synchronous, don't block forever */
+        if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+            GWARN("Netlink SO_RCVTIMEO error: %s", strerror(errno));
+        }
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+            OfonoNetlink* self = g_slice_new0(OfonoNetlink);
+            self->fd = fd;
+            self->buf = g_malloc(OFONO_NETLINK_BUF_SIZE);
+            return self;
+        }
+        GERR("Netlink bind error: %s", strerror(errno));
+        close(fd);
+    } else {
+        GERR("Netlink socket error: %s", strerror(errno));
+    }
+    return NULL;
+}
+
+void
+ofono_netlink_free(
+    OfonoNetlink* self)
+{
+    if (G_LIKELY(self)) {
+        close(self->fd);
+        g_free(self->buf);
+        g_slice_free(OfonoNetlink, self);
+    }
+}
+
+void*
+ofono_netlink_msg_init(
+    OfonoNetlinkMsg* msg,
+    guint16 type,
+    guint16 flags,
+    gsize body_size)
+{
+    memset(msg, 0, sizeof(*msg));
+    msg->u.hdr.nlmsg_len = NLMSG_LENGTH(body_size);
+    msg->u.hdr.nlmsg_type = type;
+    msg->u.hdr.nlmsg_flags = NLM_F_REQUEST | flags;
+    return NLMSG_DATA(&msg->u.hdr);
+}
+
+gboolean
+ofono_netlink_msg_add_attr(
+    OfonoNetlinkMsg* msg,
+    guint16 type,
+    const void* data,
+    gsize size)
+{
+    struct nlmsghdr* hdr = &msg->u.hdr;
+    const guint len = RTA_LENGTH(size);
+    const guint offset = NLMSG_ALIGN(hdr->nlmsg_len);
+    if (offset + RTA_ALIGN(len) <= sizeof(msg->u.data)) {
+        struct rtattr* rta = (struct rtattr*)(msg->u.data + offset);
+        rta->rta_type = type;
+        rta->rta_len = len;
+        if (size) memcpy(RTA_DATA(rta), data, size);
+        hdr->nlmsg_len = offset + RTA_ALIGN(len);
+        return TRUE;
+    }
+    GERR("Netlink message overflow");
+    return FALSE;
+}
+
+int
+ofono_netlink_request(
+    OfonoNetlink* self,
+    OfonoNetlinkMsg* msg)
+{
+    int ret;
+    msg->u.hdr.nlmsg_flags |= NLM_F_ACK;
+    ret = ofono_netlink_send(self, msg);
+    while (!ret) {
+        ret = ofono_netlink_receive(self, NULL, NULL);
+    }
+    return (ret > 0) ? 0 : ret;
+}
+
+int
+ofono_netlink_dump(
+    OfonoNetlink* self,
+    OfonoNetlinkMsg* msg,
+    OfonoNetlinkDumpFunc fn,
+    void* arg)
+{
+    int ret;
+    msg->u.hdr.nlmsg_flags |= NLM_F_DUMP;
+    ret = ofono_netlink_send(self, msg);
+    while (!ret) {
+        ret = ofono_netlink_receive(self, fn, arg);
+    }
+    return (ret > 0) ? 0 : ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_NETLINK_PRIVATE_H
+#define GOFONO_NETLINK_PRIVATE_H
+
+#include "gofono_types.h"
+
+#include <linux/rtnetlink.h>
+
+/*
+ * Minimal synchronous rtnetlink client. Requests are small and handled
+ * by the kernel right away, so there's no point in making it async.
+ * Replies are still awaited with a timeout, -ETIMEDOUT is returned if
+ * the kernel doesn't answer in time.
+ */
+
+typedef struct ofono_netlink OfonoNetlink;
+
+#define OFONO_NETLINK_MSG_SIZE (512)
+
+typedef struct ofono_netlink_msg {
+    union {
+        struct nlmsghdr hdr;
+        guint8 data[OFONO_NETLINK_MSG_SIZE];
+    } u;
+} OfonoNetlinkMsg;
+
+typedef
+void
+(*OfonoNetlinkDumpFunc)(
+    const struct nlmsghdr* msg,
+    void* arg);
+
+OfonoNetlink*
+ofono_netlink_new(void);
+
+void
+ofono_netlink_free(
+    OfonoNetlink* netlink);
+
+/* Body is the fixed part (ifaddrmsg, rtmsg etc.) following the header */
+void*
+ofono_netlink_msg_init(
+    OfonoNetlinkMsg* msg,
+    guint16 type,
+    guint16 flags,
+    gsize body_size);
+
+gboolean
+ofono_netlink_msg_add_attr(
+    OfonoNetlinkMsg* msg,
+    guint16 type,
+    const void* data,
+    gsize size);
+
+/* Returns zero on success, negative errno on failure */
+int
+ofono_netlink_request(
+    OfonoNetlink* netlink,
+    OfonoNetlinkMsg* msg);
+
+int
+ofono_netlink_dump(
+    OfonoNetlink* netlink,
+    OfonoNetlinkMsg* msg,
+    OfonoNetlinkDumpFunc fn,
+    void* arg);
+
+#endif /* GOFONO_NETLINK_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -32,24 +32,132 @@
 
 #include "gofono_netreg.h"
 #include "gofono_modem_p.h"
+#include "gofono_context_p.h"
 #include "gofono_names.h"
-#include "gofono_util.h"
+#include "gofono_snapshot_p.h"
+#include "gofono_util_p.h"
 #include "gofono_log.h"
 
+#include <gutil_misc.h>
+
 /* Generated headers */
 #define OFONO_OBJECT_PROXY OrgOfonoNetworkRegistration
 #include "org.ofono.NetworkRegistration.h"
 #include "gofono_modemintf_p.h"
 
 /* Object definition */
+enum proxy_handler_id {
+    PROXY_HANDLER_OPERATORS_CHANGED,
+    PROXY_HANDLER_COUNT
+};
+
+typedef enum ofono_netreg_call_id {
+    NETREG_CALL_GET_OPERATORS,
+    NETREG_CALL_SCAN,
+    NETREG_CALL_COUNT
+} NETREG_CALL_ID;
+
+typedef struct ofono_netreg_call_type {
+    const char* name;
+    int timeout;
+    void (*call)(OrgOfonoNetworkRegistration* proxy,
+        GCancellable* cancellable, GAsyncReadyCallback callback,
+        gpointer user_data);
+    gboolean (*finish)(OrgOfonoNetworkRegistration* proxy,
+        GVariant** operators, GAsyncResult* result, GError** error);
+} OfonoNetRegCallType;
+
+/* Scan takes a while */
+#define NETREG_SCAN_TIMEOUT_MS (120000)
+
+static const OfonoNetRegCallType ofono_netreg_call_types[] = {
+    {
+        "GetOperators",
+        OFONO_CALL_TIMEOUT_DEFAULT,
+        org_ofono_network_registration_call_get_operators,
+        org_ofono_network_registration_call_get_operators_finish
+    },{
+        "Scan",
+        NETREG_SCAN_TIMEOUT_MS,
+        org_ofono_network_registration_call_scan,
+        org_ofono_network_registration_call_scan_finish
+    }
+};
+
+G_STATIC_ASSERT(G_N_ELEMENTS(ofono_netreg_call_types) == NETREG_CALL_COUNT);
+
+/* D-Bus call shared by all requests made while it's in progress */
+typedef struct ofono_netreg_call {
+    OfonoNetReg* self;          /* NULL if the call has been abandoned */
+    const OfonoNetRegCallType* type;
+    GCancellable* cancel;
+    GSList* waiters;            /* OfonoNetRegCallWaiter */
+} OfonoNetRegCall;
+
+typedef struct ofono_netreg_call_waiter {
+    OfonoNetRegCall* call;
+    GTask* task;
+    guint cancel_id;
+} OfonoNetRegCallWaiter;
+
+typedef struct ofono_netreg_strength_watch {
+    gulong id;
+    guint* thresholds;
+    guint count;
+    guint hysteresis;
+    guint level;
+    OfonoNetRegStrengthLevelHandler fn;
+    void* arg;
+    GMainContext* context;      /* Registering thread, NULL if it's ours */
+} OfonoNetRegStrengthWatch;
+
+typedef struct ofono_netreg_strength_change {
+    gulong id;
+    guint level;
+    GMainContext* context;
+} OfonoNetRegStrengthChange;
+
+typedef struct ofono_netreg_strength_call {
+    OfonoNetReg* netreg;
+    GMainContext* owner;
+    gulong id;
+    guint level;
+} OfonoNetRegStrengthCall;
+
+typedef struct ofono_netreg_operator_data {
+    OfonoNetRegOperator pub;
+    gint ref_count;
+    GVariant* variant;          /* (oa{sv}), strings point inside */
+} OfonoNetRegOperatorData;
+
 struct ofono_netreg_priv {
     char* mcc;
     char* mnc;
     char* name;
+    const char* country;
+    gboolean country_known;     /* Reset when MCC or MNC changes */
+    gulong proxy_handler_id[PROXY_HANDLER_COUNT];
+    OfonoNetRegCall* call[NETREG_CALL_COUNT];
+    GPtrArray* operators;       /* Immutable, replaced on change */
+    GHashTable* operator_index; /* path => OfonoNetRegOperatorData */
+    gint64 operators_time;      /* Monotonic, zero if nothing's cached */
+    gint64 scan_time;
+    GMutex strength_lock;       /* Protects the fields below */
+    GSList* strength_watches;   /* OfonoNetRegStrengthWatch */
+    gulong strength_watch_last_id;
+    gulong strength_changed_id; /* Connected while there are watches */
 };
 
 typedef OfonoModemInterfaceClass OfonoNetRegClass;
 G_DEFINE_TYPE(OfonoNetReg, ofono_netreg, OFONO_TYPE_MODEM_INTERFACE)
+#define SUPER_CLASS ofono_netreg_parent_class
+
+enum ofono_netreg_signal {
+    NETREG_SIGNAL_OPERATORS_CHANGED,
+    NETREG_SIGNAL_COUNT
+};
+
+#define NETREG_SIGNAL_OPERATORS_CHANGED_NAME          "operators-changed"
 
 #define NETREG_SIGNAL_STATUS_CHANGED_NAME             "status-changed"
 #define NETREG_SIGNAL_MODE_CHANGED_NAME               "mode-changed"
@@ -103,6 +211,583 @@ static const OfonoNameIntMap ofono_netreg_tech_map = {
     { NULL, OFONO_NETREG_TECH_UNKNOWN }
 };
 
+static const OfonoNameIntPair ofono_netreg_operator_status_values[] = {
+    { "unknown",   OFONO_NETREG_OPERATOR_STATUS_UNKNOWN },
+    { "available", OFONO_NETREG_OPERATOR_STATUS_AVAILABLE },
+    { "current",   OFONO_NETREG_OPERATOR_STATUS_CURRENT },
+    { "forbidden", OFONO_NETREG_OPERATOR_STATUS_FORBIDDEN }
+};
+
+static const OfonoNameIntMap ofono_netreg_operator_status_map = {
+    "operator status",
+    OFONO_NAME_INT_MAP_ENTRIES(ofono_netreg_operator_status_values),
+    { NULL, OFONO_NETREG_OPERATOR_STATUS_UNKNOWN }
+};
+
+static guint ofono_netreg_signals[NETREG_SIGNAL_COUNT] = { 0 };
+
+/*==========================================================================*
+ * Operators
+ *
+ * The operator list is never modified, a new one is created when
+ * something changes. Operators which didn't change are shared between
+ * the old and the new list.
+ *==========================================================================*/
+
+OFONO_INLINE
+OFONO_OBJECT_PROXY*
+ofono_netreg_proxy(
+    OfonoNetReg* self)
+{
+    return ofono_object_proxy(ofono_netreg_object(self));
+}
+
+static
+OfonoNetRegOperatorData*
+ofono_netreg_operator_new(
+    GVariant* variant)
+{
+    OfonoNetRegOperatorData* data = g_slice_new0(OfonoNetRegOperatorData);
+    OfonoNetRegOperator* op = &data->pub;
+    GVariant* props = NULL;
+    const char* status = NULL;
+    const char** techs = NULL;
+
+    data->ref_count = 1;
+    data->variant = g_variant_ref(variant);
+    g_variant_get(variant, "(&o@a{sv})", &op->path, &props);
+    g_variant_lookup(props, OFONO_OPERATOR_PROPERTY_NAME, "&s", &op->name);
+    g_variant_lookup(props, OFONO_OPERATOR_PROPERTY_MCC, "&s", &op->mcc);
+    g_variant_lookup(props, OFONO_OPERATOR_PROPERTY_MNC, "&s", &op->mnc);
+    op->status = g_variant_lookup(props, OFONO_OPERATOR_PROPERTY_STATUS,
+        "&s", &status) ? ofono_name_to_int(&ofono_netreg_operator_status_map,
+        status) : OFONO_NETREG_OPERATOR_STATUS_UNKNOWN;
+    if (g_variant_lookup(props, OFONO_OPERATOR_PROPERTY_TECHNOLOGIES,
+        "^a&s", &techs)) {
+        guint i;
+        for (i = 0; techs[i]; i++) {
+            const int tech = ofono_name_to_int(&ofono_netreg_tech_map,
+                techs[i]);
+            if (tech > OFONO_NETREG_TECH_NONE) {
+                op->techs |= OFONO_NETREG_TECH_BIT(tech);
+            }
+        }
+        g_free(techs);
+    }
+    g_variant_unref(props);
+    return data;
+}
+
+static
+OfonoNetRegOperatorData*
+ofono_netreg_operator_ref(
+    OfonoNetRegOperatorData* data)
+{
+    g_atomic_int_inc(&data->ref_count);
+    return data;
+}
+
+static
+void
+ofono_netreg_operator_unref(
+    gpointer ptr)
+{
+    OfonoNetRegOperatorData* data = ptr;
+    if (g_atomic_int_dec_and_test(&data->ref_count)) {
+        g_variant_unref(data->variant);
+        g_slice_free(OfonoNetRegOperatorData, data);
+    }
+}
+
+static
+gboolean
+ofono_netreg_operators_fresh(
+    gint64 time,
+    guint max_age)
+{
+    return time && max_age &&
+        (g_get_monotonic_time() - time) < max_age * G_TIME_SPAN_SECOND;
+}
+
+static
+void
+ofono_netreg_operators_clear(
+    OfonoNetReg* self)
+{
+    OfonoNetRegPriv* priv = self->priv;
+    priv->operators_time = priv->scan_time = 0;
+    if (priv->operators) {
+        g_hash_table_remove_all(priv->operator_index);
+        g_ptr_array_unref(priv->operators);
+        priv->operators = NULL;
+        g_signal_emit(self, ofono_netreg_signals
+            [NETREG_SIGNAL_OPERATORS_CHANGED], 0);
+    }
+}
+
+static
+void
+ofono_netreg_operators_update(
+    OfonoNetReg* self,
+    GVariant* list)
+{
+    OfonoNetRegPriv* priv = self->priv;
+    GPtrArray* old = priv->operators;
+    const guint n = g_variant_n_children(list);
+    GPtrArray* ops = g_ptr_array_new_full(n, ofono_netreg_operator_unref);
+    gboolean changed = !old || old->len != n;
+    guint i;
+
+    priv->operators_time = g_get_monotonic_time();
+    for (i = 0; i < n; i++) {
+        GVariant* child = g_variant_get_child_value(list, i);
+        const char* path = NULL;
+        OfonoNetRegOperatorData* data;
+
+        g_variant_get_child(child, 0, "&o", &path);
+        data = g_hash_table_lookup(priv->operator_index, path);
+        if (data && g_variant_equal(data->variant, child)) {
+            ofono_netreg_operator_ref(data);
+        } else {
+            data = ofono_netreg_operator_new(child);
+        }
+        if (!changed && old->pdata[i] != data) {
+            changed = TRUE;
+        }
+        g_ptr_array_add(ops, data);
+        g_variant_unref(child);
+    }
+
+    if (changed) {
+        g_hash_table_remove_all(priv->operator_index);
+        for (i = 0; i < ops->len; i++) {
+            OfonoNetRegOperatorData* data = ops->pdata[i];
+            g_hash_table_replace(priv->operator_index,
+                (gpointer)data->pub.path, data);
+        }
+        priv->operators = ops;
+        if (old) g_ptr_array_unref(old);
+        GDEBUG("%u operator(s)", ops->len);
+        g_signal_emit(self, ofono_netreg_signals
+            [NETREG_SIGNAL_OPERATORS_CHANGED], 0);
+    } else {
+        g_ptr_array_unref(ops);
+    }
+}
+
+static
+void
+ofono_netreg_operators_changed(
+    OrgOfonoNetworkRegistration* proxy,
+    GVariant* operators,
+    gpointer data)
+{
+    GVERBOSE_("%u operator(s)", (guint)g_variant_n_children(operators));
+    ofono_netreg_operators_update(OFONO_NETREG(data), operators);
+}
+
+/*==========================================================================*
+ * Async calls
+ *==========================================================================*/
+
+static
+void
+ofono_netreg_call_free(
+    OfonoNetRegCall* call)
+{
+    GASSERT(!call->waiters);
+    g_object_unref(call->cancel);
+    g_slice_free(OfonoNetRegCall, call);
+}
+
+static
+void
+ofono_netreg_call_detach(
+    OfonoNetRegCall* call)
+{
+    if (call->self) {
+        OfonoNetRegPriv* priv = call->self->priv;
+        const guint id = call->type - ofono_netreg_call_types;
+        GASSERT(priv->call[id] == call);
+        priv->call[id] = NULL;
+        call->self = NULL;
+    }
+}
+
+static
+void
+ofono_netreg_call_waiter_free(
+    OfonoNetRegCallWaiter* waiter)
+{
+    if (waiter->cancel_id) {
+        /* The task holds a reference to its source object */
+        ofono_source_remove(ofono_context_of(g_task_get_source_object(
+            waiter->task)), waiter->cancel_id);
+    }
+    g_object_unref(waiter->task);
+    g_slice_free(OfonoNetRegCallWaiter, waiter);
+}
+
+/* Completes and frees all waiters. Takes ownership of the error. */
+static
+void
+ofono_netreg_call_complete(
+    OfonoNetRegCall* call,
+    GPtrArray* operators,
+    GError* error)
+{
+    GSList* waiters = call->waiters;
+    GSList* l;
+
+    call->waiters = NULL;
+    for (l = waiters; l; l = l->next) {
+        OfonoNetRegCallWaiter* waiter = l->data;
+        if (operators) {
+            g_task_return_pointer(waiter->task, g_ptr_array_ref(operators),
+                (GDestroyNotify)g_ptr_array_unref);
+        } else {
+            g_task_return_error(waiter->task, g_error_copy(error));
+        }
+        ofono_netreg_call_waiter_free(waiter);
+    }
+    g_slist_free(waiters);
+    if (error) g_error_free(error);
+}
+
+static
+void
+ofono_netreg_call_finished(
+    GObject* proxy,
+    GAsyncResult* result,
+    gpointer data)
+{
+    OfonoNetRegCall* call = data;
+    OfonoNetReg* self = call->self;
+    GVariant* operators = NULL;
+    GError* error = NULL;
+
+    if (call->type->finish(ORG_OFONO_NETWORK_REGISTRATION(proxy),
+        &operators, result, &error)) {
+        if (self) {
+            OfonoNetRegPriv* priv = self->priv;
+
+            ofono_netreg_call_detach(call);
+            ofono_netreg_operators_update(self, operators);
+            if (call->type == ofono_netreg_call_types + NETREG_CALL_SCAN) {
+                priv->scan_time = priv->operators_time;
+            }
+            ofono_netreg_call_complete(call, priv->operators, NULL);
+        }
+        g_variant_unref(operators);
+    } else if (self) {
+        GERR("%s.%s %s", OFONO_NETREG_INTERFACE_NAME, call->type->name,
+            GERRMSG(error));
+        ofono_netreg_call_detach(call);
+        ofono_netreg_call_complete(call, NULL, error);
+        error = NULL;
+    }
+    if (error) g_error_free(error);
+    ofono_netreg_call_free(call);
+}
+
+static
+gboolean
+ofono_netreg_call_waiter_cancelled(
+    GCancellable* cancellable,
+    gpointer arg)
+{
+    OfonoNetRegCallWaiter* waiter = arg;
+    OfonoNetRegCall* call = waiter->call;
+
+    waiter->cancel_id = 0;
+    call->waiters = g_slist_remove(call->waiters, waiter);
+    g_task_return_error_if_cancelled(waiter->task);
+    ofono_netreg_call_waiter_free(waiter);
+    if (!call->waiters) {
+        /* Nobody needs the result anymore */
+        GDEBUG("Cancelling %s", call->type->name);
+        ofono_netreg_call_detach(call);
+        g_cancellable_cancel(call->cancel);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+ofono_netreg_call_cancel_all(
+    OfonoNetReg* self,
+    const GError* error)
+{
+    OfonoNetRegPriv* priv = self->priv;
+    guint i;
+
+    for (i = 0; i < NETREG_CALL_COUNT; i++) {
+        OfonoNetRegCall* call = priv->call[i];
+        if (call) {
+            ofono_netreg_call_detach(call);
+            g_cancellable_cancel(call->cancel);
+            ofono_netreg_call_complete(call, NULL, g_error_copy(error));
+        }
+    }
+}
+
+static
+void
+ofono_netreg_call_start(
+    OfonoNetReg* self,
+    NETREG_CALL_ID id,
+    guint max_age,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    GTask* task = g_task_new(self, cancellable, callback, user_data);
+
+    if (G_UNLIKELY(!self)) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+            "No network registration");
+    } else if (!ofono_netreg_proxy(self)) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
+            "Network registration is not available");
+    } else if (!g_task_return_error_if_cancelled(task)) {
+        OfonoNetRegPriv* priv = self->priv;
+        OfonoNetRegCallWaiter* waiter;
+        OfonoNetRegCall* call;
+
+        if (ofono_netreg_operators_fresh((id == NETREG_CALL_SCAN) ?
+            priv->scan_time : priv->operators_time, max_age)) {
+            g_task_return_pointer(task, g_ptr_array_ref(priv->operators),
+                (GDestroyNotify)g_ptr_array_unref);
+            g_object_unref(task);
+            return;
+        }
+
+        call = priv->call[id];
+        if (!call) {
+            const OfonoNetRegCallType* type = ofono_netreg_call_types + id;
+
+            GDEBUG("%s.%s", OFONO_NETREG_INTERFACE_NAME, type->name);
+            call = g_slice_new0(OfonoNetRegCall);
+            call->self = self;
+            call->type = type;
+            call->cancel = g_cancellable_new();
+            priv->call[id] = call;
+            ofono_object_prepare_call(ofono_netreg_object(self),
+                type->timeout);
+            type->call(ofono_netreg_proxy(self), call->cancel,
+                ofono_netreg_call_finished, call);
+        } else {
+            GDEBUG("%s.%s is already in progress",
+                OFONO_NETREG_INTERFACE_NAME, call->type->name);
+        }
+
+        waiter = g_slice_new0(OfonoNetRegCallWaiter);
+        waiter->call = call;
+        waiter->task = task;
+        if (cancellable) {
+            waiter->cancel_id = ofono_cancellable_add(ofono_context_of(self),
+                cancellable, ofono_netreg_call_waiter_cancelled, waiter);
+        }
+        call->waiters = g_slist_append(call->waiters, waiter);
+        return;
+    }
+    g_object_unref(task);
+}
+
+/*==========================================================================*
+ * Strength levels
+ *
+ * Levels of all watches are updated by a single "strength-changed"
+ * handler, which is only connected while there are watches. Unless
+ * the level changes, that's one or two comparisons per watch.
+ *
+ * Watches may be added and removed by any thread, hence the lock.
+ * Like signal handlers (see ofono_signal_connect), level handlers are
+ * invoked on the thread-default context of the registering thread.
+ *==========================================================================*/
+
+static
+guint
+ofono_netreg_strength_watch_level(
+    const OfonoNetRegStrengthWatch* watch,
+    guint strength)
+{
+    guint level = watch->level;
+    while (level < watch->count && strength >= watch->thresholds[level]) {
+        level++;
+    }
+    while (level > 0 && strength + watch->hysteresis <
+        watch->thresholds[level - 1]) {
+        level--;
+    }
+    return level;
+}
+
+static
+OfonoNetRegStrengthWatch*
+ofono_netreg_strength_watch_find(
+    OfonoNetReg* self,
+    gulong id)
+{
+    GSList* l;
+    for (l = self->priv->strength_watches; l; l = l->next) {
+        OfonoNetRegStrengthWatch* watch = l->data;
+        if (watch->id == id) {
+            return watch;
+        }
+    }
+    return NULL;
+}
+
+static
+void
+ofono_netreg_strength_watch_free(
+    gpointer data)
+{
+    OfonoNetRegStrengthWatch* watch = data;
+    if (watch->context) {
+        g_main_context_unref(watch->context);
+    }
+    g_free(watch->thresholds);
+    g_slice_free(OfonoNetRegStrengthWatch, watch);
+}
+
+static
+void
+ofono_netreg_strength_watch_invoke(
+    OfonoNetReg* self,
+    gulong id,
+    guint level)
+{
+    OfonoNetRegPriv* priv = self->priv;
+    OfonoNetRegStrengthLevelHandler fn = NULL;
+    OfonoNetRegStrengthWatch* watch;
+    void* arg = NULL;
+
+    /* The watch may have been removed in the meantime */
+    g_mutex_lock(&priv->strength_lock);
+    watch = ofono_netreg_strength_watch_find(self, id);
+    if (watch) {
+        fn = watch->fn;
+        arg = watch->arg;
+    }
+    g_mutex_unlock(&priv->strength_lock);
+    if (fn) {
+        fn(self, level, arg);
+    }
+}
+
+static
+gboolean
+ofono_netreg_strength_call_proc(
+    gpointer data)
+{
+    OfonoNetRegStrengthCall* call = data;
+    ofono_netreg_strength_watch_invoke(call->netreg, call->id, call->level);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+ofono_netreg_strength_call_release(
+    gpointer data)
+{
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+ofono_netreg_strength_call_destroy(
+    gpointer data)
+{
+    OfonoNetRegStrengthCall* call = data;
+    g_object_unref(call->netreg);
+    g_main_context_unref(call->owner);
+    g_slice_free(OfonoNetRegStrengthCall, call);
+}
+
+static
+void
+ofono_netreg_strength_call_free(
+    gpointer data)
+{
+    OfonoNetRegStrengthCall* call = data;
+
+    /* The reference is released on the library thread */
+    g_main_context_invoke_full(call->owner, G_PRIORITY_DEFAULT,
+        ofono_netreg_strength_call_release, call,
+        ofono_netreg_strength_call_destroy);
+}
+
+static
+void
+ofono_netreg_strength_watch_post(
+    OfonoNetReg* self,
+    const OfonoNetRegStrengthChange* change)
+{
+    OfonoNetRegStrengthCall* call = g_slice_new(OfonoNetRegStrengthCall);
+    call->netreg = g_object_ref(self);
+    call->owner = g_main_context_ref(ofono_context_of(self)->main_context);
+    call->id = change->id;
+    call->level = change->level;
+    g_main_context_invoke_full(change->context, G_PRIORITY_DEFAULT,
+        ofono_netreg_strength_call_proc, call,
+        ofono_netreg_strength_call_free);
+}
+
+static
+void
+ofono_netreg_strength_changed(
+    OfonoNetReg* self,
+    gpointer data)
+{
+    OfonoNetRegPriv* priv = self->priv;
+    GArray* changed = NULL;
+    GSList* l;
+
+    g_mutex_lock(&priv->strength_lock);
+    for (l = priv->strength_watches; l; l = l->next) {
+        OfonoNetRegStrengthWatch* watch = l->data;
+        const guint level = ofono_netreg_strength_watch_level(watch,
+            self->strength);
+
+        if (watch->level != level) {
+            OfonoNetRegStrengthChange change;
+
+            watch->level = level;
+            change.id = watch->id;
+            change.level = level;
+            change.context = watch->context ?
+                g_main_context_ref(watch->context) : NULL;
+            if (!changed) {
+                changed = g_array_new(FALSE, FALSE, sizeof(change));
+            }
+            g_array_append_val(changed, change);
+        }
+    }
+    g_mutex_unlock(&priv->strength_lock);
+
+    if (changed) {
+        guint i;
+
+        /* Handlers may add or remove watches */
+        g_object_ref(self);
+        for (i = 0; i < changed->len; i++) {
+            const OfonoNetRegStrengthChange* change =
+                &g_array_index(changed, OfonoNetRegStrengthChange, i);
+            if (change->context) {
+                ofono_netreg_strength_watch_post(self, change);
+                g_main_context_unref(change->context);
+            } else {
+                ofono_netreg_strength_watch_invoke(self, change->id,
+                    change->level);
+            }
+        }
+        g_object_unref(self);
+        g_array_free(changed, TRUE);
+    }
+}
+
 /*==========================================================================*
  * API
  *==========================================================================*/
@@ -151,18 +836,31 @@ ofono_netreg_unref(
     }
 }
 
+OfonoNetRegSnapshot*
+ofono_netreg_snapshot(
+    OfonoNetReg* self)
+{
+    OfonoSnapshot* snapshot = ofono_object_snapshot(ofono_netreg_object(self));
+    return snapshot ? G_CAST(snapshot, OfonoNetRegSnapshot, snapshot) : NULL;
+}
+
 const char*
 ofono_netreg_country(
     OfonoNetReg* self)
 {
-    const char* country = NULL;
     if (ofono_netreg_valid(self)) {
-        country = ofono_country_code(self->mcc, self->mnc);
-        if (!country && self->mnc) {
-            country = ofono_country_code(self->mcc, self->mnc);
+        OfonoNetRegPriv* priv = self->priv;
+        if (!priv->country_known) {
+            priv->country_known = TRUE;
+            priv->country = ofono_country_code(self->mcc, self->mnc);
+            if (!priv->country && self->mnc) {
+                /* Unknown MNC, MCC alone may still be good enough */
+                priv->country = ofono_country_code(self->mcc, NULL);
+            }
         }
+        return priv->country;
     }
-    return country;
+    return NULL;
 }
 
 const char*
@@ -186,6 +884,71 @@ ofono_netreg_tech_string(
     return ofono_int_to_name(&ofono_netreg_tech_map, tech);
 }
 
+const char*
+ofono_netreg_operator_status_string(
+    OFONO_NETREG_OPERATOR_STATUS status)
+{
+    return ofono_int_to_name(&ofono_netreg_operator_status_map, status);
+}
+
+GPtrArray*
+ofono_netreg_get_operators(
+    OfonoNetReg* self,
+    guint max_age)
+{
+    if (G_LIKELY(self)) {
+        OfonoNetRegPriv* priv = self->priv;
+        if (ofono_netreg_operators_fresh(priv->operators_time, max_age)) {
+            return g_ptr_array_ref(priv->operators);
+        }
+    }
+    return NULL;
+}
+
+void
+ofono_netreg_get_operators_async(
+    OfonoNetReg* self,
+    guint max_age,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    ofono_netreg_call_start(self, NETREG_CALL_GET_OPERATORS, max_age,
+        cancellable, callback, user_data);
+}
+
+GPtrArray*
+ofono_netreg_get_operators_finish(
+    OfonoNetReg* self,
+    GAsyncResult* result,
+    GError** error)
+{
+    GASSERT(g_task_is_valid(result, self));
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+void
+ofono_netreg_scan_async(
+    OfonoNetReg* self,
+    guint max_age,
+    GCancellable* cancellable,
+    GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+    ofono_netreg_call_start(self, NETREG_CALL_SCAN, max_age,
+        cancellable, callback, user_data);
+}
+
+GPtrArray*
+ofono_netreg_scan_finish(
+    OfonoNetReg* self,
+    GAsyncResult* result,
+    GError** error)
+{
+    GASSERT(g_task_is_valid(result, self));
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
+
 gulong
 ofono_netreg_add_property_changed_handler(
     OfonoNetReg* self,
@@ -207,13 +970,23 @@ ofono_netreg_add_valid_changed_handler(
         &self->intf.object, (OfonoObjectHandler)fn, arg) : 0;
 }
 
+gulong
+ofono_netreg_add_operators_changed_handler(
+    OfonoNetReg* self,
+    OfonoNetRegHandler fn,
+    void* arg)
+{
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
+        NETREG_SIGNAL_OPERATORS_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
+}
+
 gulong
 ofono_netreg_add_status_changed_handler(
     OfonoNetReg* self,
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_STATUS_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -223,7 +996,7 @@ ofono_netreg_add_mode_changed_handler(
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_MODE_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -233,7 +1006,7 @@ ofono_netreg_add_tech_changed_handler(
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_TECHNOLOGY_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -243,7 +1016,7 @@ ofono_netreg_add_mcc_changed_handler(
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_MCC_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -253,7 +1026,7 @@ ofono_netreg_add_mnc_changed_handler(
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_MNC_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -263,7 +1036,7 @@ ofono_netreg_add_name_changed_handler(
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_NAME_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -273,7 +1046,7 @@ ofono_netreg_add_cell_changed_handler(
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_CELL_ID_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -283,7 +1056,7 @@ ofono_netreg_add_areacode_changed_handler(
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_LOCATION_AREA_CODE_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -293,10 +1066,112 @@ ofono_netreg_add_strength_changed_handler(
     OfonoNetRegHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         NETREG_SIGNAL_STRENGTH_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
+gulong
+ofono_netreg_add_strength_level_handler(
+    OfonoNetReg* self,
+    const guint* thresholds,
+    guint count,
+    guint hysteresis,
+    OfonoNetRegStrengthLevelHandler fn,
+    void* arg)
+{
+    if (G_LIKELY(self) && G_LIKELY(fn) && G_LIKELY(thresholds) && count) {
+        OfonoNetRegPriv* priv = self->priv;
+        GMainContext* main_context = ofono_context_of(self)->main_context;
+        GMainContext* context = g_main_context_ref_thread_default();
+        OfonoNetRegStrengthWatch* watch;
+        gulong id;
+        guint i;
+
+        for (i = 1; i < count; i++) {
+            if (thresholds[i] <= thresholds[i - 1]) {
+                GWARN("Strength thresholds must be in ascending order");
+                g_main_context_unref(context);
+                return 0;
+            }
+        }
+
+        watch = g_slice_new0(OfonoNetRegStrengthWatch);
+        watch->thresholds = ofono_memdup(thresholds, count * sizeof(guint));
+        watch->count = count;
+        /* Strength is a byte, so that's enough to never drop a level */
+        watch->hysteresis = MIN(hysteresis, G_MAXUINT8);
+        watch->level = ofono_netreg_strength_watch_level(watch,
+            self->strength);
+        watch->fn = fn;
+        watch->arg = arg;
+        if (main_context && context != main_context) {
+            /* Handler gets invoked on the thread which has registered it */
+            watch->context = g_main_context_ref(context);
+        }
+        g_main_context_unref(context);
+
+        g_mutex_lock(&priv->strength_lock);
+        id = watch->id = ++(priv->strength_watch_last_id);
+        priv->strength_watches = g_slist_append(priv->strength_watches,
+            watch);
+        if (!priv->strength_changed_id) {
+            /* Levels are updated on the library thread */
+            priv->strength_changed_id = g_signal_connect(self,
+                NETREG_SIGNAL_STRENGTH_CHANGED_NAME,
+                G_CALLBACK(ofono_netreg_strength_changed), NULL);
+        }
+        g_mutex_unlock(&priv->strength_lock);
+        return id;
+    }
+    return 0;
+}
+
+guint
+ofono_netreg_strength_level(
+    OfonoNetReg* self,
+    gulong id)
+{
+    guint level = 0;
+    if (G_LIKELY(self) && G_LIKELY(id)) {
+        OfonoNetRegPriv* priv = self->priv;
+        OfonoNetRegStrengthWatch* watch;
+
+        g_mutex_lock(&priv->strength_lock);
+        watch = ofono_netreg_strength_watch_find(self, id);
+        if (watch) {
+            level = watch->level;
+        }
+        g_mutex_unlock(&priv->strength_lock);
+    }
+    return level;
+}
+
+void
+ofono_netreg_remove_strength_level_handler(
+    OfonoNetReg* self,
+    gulong id)
+{
+    if (G_LIKELY(self) && G_LIKELY(id)) {
+        OfonoNetRegPriv* priv = self->priv;
+        OfonoNetRegStrengthWatch* watch;
+
+        g_mutex_lock(&priv->strength_lock);
+        watch = ofono_netreg_strength_watch_find(self, id);
+        if (watch) {
+            priv->strength_watches = g_slist_remove(priv->strength_watches,
+                watch);
+            if (!priv->strength_watches && priv->strength_changed_id) {
+                g_signal_handler_disconnect(self, priv->strength_changed_id);
+                priv->strength_changed_id = 0;
+            }
+        }
+        g_mutex_unlock(&priv->strength_lock);
+        if (watch) {
+            ofono_netreg_strength_watch_free(watch);
+        }
+    }
+}
+
 void
 ofono_netreg_remove_handler(
     OfonoNetReg* self,
@@ -323,6 +1198,15 @@ ofono_netreg_remove_handler(
 #define NETREG_DEFINE_PROPERTY_STRING(NAME,var) \
     OFONO_OBJECT_DEFINE_PROPERTY_STRING(NETREG,netreg,NAME,OfonoNetReg,var)
 
+#define NETREG_DEFINE_PROPERTY_CODE(NAME,var) { \
+    OFONO_NETREG_PROPERTY_##NAME,                                       \
+    NETREG_SIGNAL_##NAME##_CHANGED_NAME, 0,                             \
+    ofono_netreg_property_priv,                                         \
+    ofono_object_property_string_value,                                 \
+    ofono_netreg_property_code_apply,                                   \
+    G_STRUCT_OFFSET(OfonoNetReg,var), G_STRUCT_OFFSET(OfonoNetRegPriv,var), \
+    NULL}
+
 #define NETREG_DEFINE_PROPERTY_ENUM(NAME,var) \
     OFONO_OBJECT_DEFINE_PROPERTY_ENUM(NETREG,NAME,OfonoNetReg,var, \
     &ofono_netreg_##var##_map)
@@ -340,10 +1224,80 @@ ofono_netreg_property_priv(
     return OFONO_NETREG(object)->priv;
 }
 
+static
+gboolean
+ofono_netreg_property_code_apply(
+    OfonoObject* object,
+    const OfonoObjectProperty* prop,
+    GVariant* value)
+{
+    if (ofono_object_property_string_apply(object, prop, value)) {
+        /* Country will be looked up again when someone asks for it */
+        OFONO_NETREG(object)->priv->country_known = FALSE;
+        return TRUE;
+    }
+    return FALSE;
+}
+
 /*==========================================================================*
  * Internals
  *==========================================================================*/
 
+static
+OfonoSnapshot*
+ofono_netreg_snapshot_new(
+    OfonoObject* object)
+{
+    OfonoNetReg* self = OFONO_NETREG(object);
+    OfonoSnapshot* snapshot = ofono_snapshot_new(sizeof(OfonoNetRegSnapshot));
+    OfonoNetRegSnapshot* copy = G_CAST(snapshot, OfonoNetRegSnapshot,
+        snapshot);
+    copy->status = self->status;
+    copy->mode = self->mode;
+    copy->tech = self->tech;
+    copy->mcc = ofono_snapshot_strdup(snapshot, self->mcc);
+    copy->mnc = ofono_snapshot_strdup(snapshot, self->mnc);
+    copy->name = ofono_snapshot_strdup(snapshot, self->name);
+    copy->cell = self->cell;
+    copy->areacode = self->areacode;
+    copy->strength = self->strength;
+    return snapshot;
+}
+
+static
+void
+ofono_netreg_proxy_created(
+    OfonoObject* object,
+    OFONO_OBJECT_PROXY* proxy)
+{
+    OfonoNetReg* self = OFONO_NETREG(object);
+    OfonoNetRegPriv* priv = self->priv;
+
+    GASSERT(!priv->proxy_handler_id[PROXY_HANDLER_OPERATORS_CHANGED]);
+    priv->proxy_handler_id[PROXY_HANDLER_OPERATORS_CHANGED] =
+        g_signal_connect(proxy, "operators-changed",
+        G_CALLBACK(ofono_netreg_operators_changed), self);
+    OFONO_OBJECT_CLASS(SUPER_CLASS)->fn_proxy_created(object, proxy);
+}
+
+static
+void
+ofono_netreg_ready_changed(
+    OfonoObject* object,
+    gboolean ready)
+{
+    if (!ready) {
+        OfonoNetReg* self = OFONO_NETREG(object);
+        GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_CLOSED,
+            "Network registration is gone");
+
+        ofono_netreg_call_cancel_all(self, error);
+        ofono_netreg_operators_clear(self);
+        g_error_free(error);
+    }
+    OFONO_OBJECT_CLASS(SUPER_CLASS)->fn_ready_changed(object, ready);
+}
+
 /**
  * Per instance initializer
  */
@@ -352,8 +1306,11 @@ void
 ofono_netreg_init(
     OfonoNetReg* self)
 {
-    self->priv = G_TYPE_INSTANCE_GET_PRIVATE(self, OFONO_TYPE_NETREG,
-        OfonoNetRegPriv);
+    OfonoNetRegPriv* priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
+        OFONO_TYPE_NETREG, OfonoNetRegPriv);
+    self->priv = priv;
+    priv->operator_index = g_hash_table_new(g_str_hash, g_str_equal);
+    g_mutex_init(&priv->strength_lock);
 }
 
 /**
@@ -366,10 +1323,17 @@ ofono_netreg_finalize(
 {
     OfonoNetReg* self = OFONO_NETREG(object);
     OfonoNetRegPriv* priv = self->priv;
+    gutil_disconnect_handlers(ofono_netreg_proxy(self),
+        priv->proxy_handler_id, G_N_ELEMENTS(priv->proxy_handler_id));
+    if (priv->operators) g_ptr_array_unref(priv->operators);
+    g_hash_table_destroy(priv->operator_index);
+    g_slist_free_full(priv->strength_watches,
+        ofono_netreg_strength_watch_free);
+    g_mutex_clear(&priv->strength_lock);
     g_free(priv->mcc);
     g_free(priv->mnc);
     g_free(priv->name);
-    G_OBJECT_CLASS(ofono_netreg_parent_class)->finalize(object);
+    G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
 }
 
 /**
@@ -384,8 +1348,8 @@ ofono_netreg_class_init(
         NETREG_DEFINE_PROPERTY_ENUM(STATUS,status),
         NETREG_DEFINE_PROPERTY_ENUM(MODE,mode),
         NETREG_DEFINE_PROPERTY_ENUM(TECHNOLOGY,tech),
-        NETREG_DEFINE_PROPERTY_STRING(MCC,mcc),
-        NETREG_DEFINE_PROPERTY_STRING(MNC,mnc),
+        NETREG_DEFINE_PROPERTY_CODE(MCC,mcc),
+        NETREG_DEFINE_PROPERTY_CODE(MNC,mnc),
         NETREG_DEFINE_PROPERTY_STRING(NAME,name),
         NETREG_DEFINE_PROPERTY_UINT32(CELL_ID,cell),
         NETREG_DEFINE_PROPERTY_UINT16(LOCATION_AREA_CODE,areacode),
@@ -395,10 +1359,17 @@ ofono_netreg_class_init(
     OfonoObjectClass* ofono = &klass->object;
     G_OBJECT_CLASS(klass)->finalize = ofono_netreg_finalize;
     g_type_class_add_private(klass, sizeof(OfonoNetRegPriv));
+    ofono->fn_snapshot = ofono_netreg_snapshot_new;
+    ofono->fn_proxy_created = ofono_netreg_proxy_created;
+    ofono->fn_ready_changed = ofono_netreg_ready_changed;
     ofono->properties = ofono_netreg_properties;
     ofono->nproperties = G_N_ELEMENTS(ofono_netreg_properties);
     OFONO_OBJECT_CLASS_SET_PROXY_CALLBACKS_RO(ofono,
         org_ofono_network_registration);
+    ofono_netreg_signals[NETREG_SIGNAL_OPERATORS_CHANGED] =
+        g_signal_new(NETREG_SIGNAL_OPERATORS_CHANGED_NAME,
+            G_OBJECT_CLASS_TYPE(klass), G_SIGNAL_RUN_FIRST,
+            0, NULL, NULL, NULL, G_TYPE_NONE, 0);
     ofono_class_initialize(ofono);
 }
 
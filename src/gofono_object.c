@@ -31,7 +31,11 @@
  */
 
 #include "gofono_object_p.h"
+#include "gofono_callgroup_p.h"
+#include "gofono_context_p.h"
+#include "gofono_snapshot_p.h"
 #include "gofono_error_p.h"
+#include "gofono_eventstream_p.h"
 #include "gofono_util_p.h"
 #include "gofono_names.h"
 #include "gofono_log.h"
@@ -43,6 +47,7 @@
 typedef struct ofono_object_get_properties_call {
     GDBusProxy* proxy;
     GCancellable* cancel;
+    OfonoCallGroup* group;
     OfonoObject* object;
     gboolean (*fn_finish)(
         GDBusProxy* proxy,
@@ -56,17 +61,65 @@ struct ofono_object_priv {
     char* intf;
     char* path;
     GDBusConnection* bus;
+    guint bus_call_id;
     GDBusProxy* proxy;
     gboolean ready;
     gboolean get_properties_ok;
     OfonoObjectGetPropertiesCall* get_properties_pending;
     guint get_properties_retry_id;
     gulong property_changed_signal_id;
-    GUtilIdlePool* pool;
     GHashTable* properties;
     GList* pending_calls;
+    OfonoCallGroup* call_group;
+    int call_timeout;
+    OFONO_OBJECT_WRITE_FLAGS write_flags;
+    GHashTable* writes;
+    GHashTable* optimistic;
+    guint optimistic_serial;
+    OfonoSnapshot* snapshot;
+    guint snapshot_serial;
+    guint hold_count;
+    gboolean hold_all;
+    GHashTable* hold_names;             /* Names of the held properties */
+    GPtrArray* held_properties;
 };
 
+/* Locally applied value waiting for confirmation */
+typedef struct ofono_object_optimistic {
+    guint serial;
+    guint calls;                /* Number of calls in progress */
+    GVariant* confirmed;        /* Value to restore on failure */
+} OfonoObjectOptimistic;
+
+typedef struct ofono_object_optimistic_call {
+    char* name;
+    guint serial;
+    OfonoObjectCallFinishedCallback callback;
+    void* arg;
+} OfonoObjectOptimisticCall;
+
+/* Combined SetProperty request */
+typedef struct ofono_object_write_request {
+    GCancellable* cancellable;
+    OfonoCallGroup* group;
+    OfonoObjectCallFinishedCallback callback;
+    void* arg;
+} OfonoObjectWriteRequest;
+
+/* Per-property state of the combined SetProperty calls */
+typedef struct ofono_object_write {
+    char* name;
+    GSList* requests;           /* Waiting for the call in progress */
+    GVariant* next_value;       /* The latest value waiting to be sent */
+    int next_timeout;
+    GSList* next_requests;      /* Waiting for next_value to be sent */
+} OfonoObjectWrite;
+
+typedef struct ofono_object_write_done {
+    OfonoObject* object;
+    OfonoObjectWriteRequest* request;
+} OfonoObjectWriteDone;
+
 G_DEFINE_TYPE(OfonoObject, ofono_object, G_TYPE_OBJECT)
 static OfonoObjectClass* ofono_object_class = NULL;
 
@@ -84,6 +137,7 @@ static guint ofono_object_signals[OFONO_OBJECT_SIGNAL_COUNT] = { 0 };
 typedef struct ofono_object_pending_call_priv {
     OfonoObjectPendingCall call;
     OfonoObjectProxyCallFinishedCallback finished;
+    OfonoCallGroup* group;
 } OfonoObjectPendingCallPriv;
 
 OFONO_INLINE OfonoObjectPendingCallPriv*
@@ -298,6 +352,7 @@ ofono_object_setup_finished(
     GError* error = NULL;
     GVariant* props = NULL;
     int retry_ms = -1;
+    gboolean requery = FALSE;
     gboolean ok = call->fn_finish(G_DBUS_PROXY(proxy), &props, result, &error);
 
     if (ok) {
@@ -315,7 +370,11 @@ ofono_object_setup_finished(
             /* Retry after delay */
             GWARN("%s.GetProperties %s", object->priv->intf, GERRMSG(error));
             retry_ms = OFONO_BUSY_RETRY_DELAY;
-        } else if (error->code != G_IO_ERROR_CANCELLED) {
+        } else if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            /* The call group has been cancelled, start over */
+            GDEBUG("%s.GetProperties cancelled", object->priv->intf);
+            requery = TRUE;
+        } else {
             /* Something unrecoverable */
             GERR("%s.GetProperties %s", object->priv->intf, GERRMSG(error));
         }
@@ -324,19 +383,23 @@ ofono_object_setup_finished(
     if (retry_ms >= 0) {
         OfonoObjectPriv* priv = object->priv;
         GASSERT(!priv->get_properties_retry_id);
-        priv->get_properties_retry_id = g_timeout_add(retry_ms,
+        priv->get_properties_retry_id = ofono_timeout_add(
+            ofono_context_of(object), retry_ms,
             ofono_object_get_properties_retry, object);
     } else {
-        if (call->object) {
-            OfonoObjectPriv* priv = call->object->priv;
+        if (object) {
+            OfonoObjectPriv* priv = object->priv;
             priv->get_properties_ok = ok;
             priv->get_properties_pending = NULL;
-            ofono_object_update_valid(call->object);
+            if (!requery) ofono_object_update_valid(object);
         }
+        ofono_call_group_remove(call->group, call->cancel);
+        ofono_call_group_unref(call->group);
         g_object_unref(call->proxy);
         g_object_unref(call->cancel);
         g_slice_free(OfonoObjectGetPropertiesCall, call);
-   }
+        if (requery) ofono_object_query_properties(object, TRUE);
+    }
     if (error) g_error_free(error);
 }
 
@@ -352,7 +415,8 @@ ofono_object_cancel_get_properties(
         priv->get_properties_pending = NULL;
     }
     if (priv->get_properties_retry_id) {
-        g_source_remove(priv->get_properties_retry_id);
+        ofono_source_remove(ofono_context_of(self),
+            priv->get_properties_retry_id);
         priv->get_properties_retry_id = 0;
     }
 }
@@ -367,6 +431,7 @@ ofono_object_get_properties_retry(
     priv->get_properties_retry_id = 0;
     GDEBUG("Retrying %s.GetProperties", priv->intf);
     GASSERT(priv->get_properties_pending);
+    ofono_object_prepare_call(self, OFONO_CALL_TIMEOUT_DEFAULT);
     OFONO_OBJECT_GET_CLASS(self)->fn_proxy_call_get_properties(priv->proxy,
         priv->get_properties_pending->cancel, ofono_object_setup_finished,
         priv->get_properties_pending);
@@ -420,12 +485,55 @@ ofono_object_create_proxy_finished(
  * Implementation
  *==========================================================================*/
 
+int
+ofono_object_call_timeout(
+    OfonoObject* self)
+{
+    OfonoObjectPriv* priv = self->priv;
+    if (priv->call_timeout == OFONO_CALL_TIMEOUT_DEFAULT) {
+        /* Derived classes may have their own defaults */
+        OfonoObjectClass* klass = OFONO_OBJECT_GET_CLASS(self);
+        while (klass->call_timeout == OFONO_CALL_TIMEOUT_DEFAULT &&
+               klass != ofono_object_class) {
+            klass = OFONO_OBJECT_CLASS(g_type_class_peek_parent(klass));
+        }
+        return klass->call_timeout;
+    }
+    return priv->call_timeout;
+}
+
+void
+ofono_object_prepare_call(
+    OfonoObject* self,
+    int timeout_msec)
+{
+    OfonoObjectPriv* priv = self->priv;
+    if (priv->proxy) {
+        /* Generated stubs don't take the timeout parameter, they use
+         * the default one. This works because we are single-threaded. */
+        g_dbus_proxy_set_default_timeout(priv->proxy, (timeout_msec < 0) ?
+            ofono_object_call_timeout(self) : timeout_msec);
+    }
+}
+
 OfonoObjectPendingCall*
 ofono_object_pending_call_new(
     OfonoObject* self,
     OfonoObjectProxyCallFinishedCallback finished,
     OfonoObjectCallFinishedCallback callback,
     void* arg)
+{
+    return ofono_object_pending_call_new_full(self,
+        OFONO_CALL_TIMEOUT_DEFAULT, finished, callback, arg);
+}
+
+OfonoObjectPendingCall*
+ofono_object_pending_call_new_full(
+    OfonoObject* self,
+    int timeout_msec,
+    OfonoObjectProxyCallFinishedCallback finished,
+    OfonoObjectCallFinishedCallback callback,
+    void* arg)
 {
     OfonoObjectPendingCallPriv* call = g_new(OfonoObjectPendingCallPriv, 1);
     OfonoObjectPriv* priv = self->priv;
@@ -434,7 +542,10 @@ ofono_object_pending_call_new(
     call->call.callback = callback;
     call->call.arg = arg;
     call->finished = finished;
+    call->group = ofono_call_group_ref(priv->call_group);
+    ofono_call_group_add(call->group, call->call.cancellable);
     priv->pending_calls = g_list_prepend(priv->pending_calls, call);
+    ofono_object_prepare_call(self, timeout_msec);
     return &call->call;
 }
 
@@ -445,6 +556,8 @@ ofono_object_pending_call_free(
 {
     OfonoObjectPriv* priv = call->call.object->priv;
     priv->pending_calls = g_list_remove(priv->pending_calls, call);
+    ofono_call_group_remove(call->group, call->call.cancellable);
+    ofono_call_group_unref(call->group);
     ofono_object_unref(call->call.object);
     g_object_unref(call->call.cancellable);
     g_free(call);
@@ -498,16 +611,82 @@ ofono_object_apply_property(
         name, value);
 }
 
+static
+void
+ofono_object_publish_snapshot(
+    OfonoObject* self)
+{
+    OfonoObjectClass* klass = OFONO_OBJECT_GET_CLASS(self);
+    if (klass->fn_snapshot) {
+        OfonoObjectPriv* priv = self->priv;
+        OfonoSnapshot* snapshot = klass->fn_snapshot(self);
+        snapshot->path = ofono_snapshot_strdup(snapshot, priv->path);
+        snapshot->serial = ++(priv->snapshot_serial);
+        snapshot->valid = self->valid;
+        ofono_snapshot_publish(ofono_context_of(self), &priv->snapshot,
+            snapshot);
+    }
+}
+
+static
+void
+ofono_object_hold_property(
+    OfonoObject* self,
+    const OfonoObjectProperty* property)
+{
+    OfonoObjectPriv* priv = self->priv;
+    GPtrArray* held = priv->held_properties;
+    guint i;
+
+    if (!held) {
+        held = priv->held_properties = g_ptr_array_new();
+    }
+    /* Each property is reported once, no matter how many times it changed */
+    for (i = 0; i < held->len; i++) {
+        if (held->pdata[i] == property) {
+            return;
+        }
+    }
+    g_ptr_array_add(held, (gpointer)property);
+}
+
+static
+gboolean
+ofono_object_property_held(
+    OfonoObject* self,
+    const OfonoObjectProperty* property)
+{
+    OfonoObjectPriv* priv = self->priv;
+    return priv->hold_count && (priv->hold_all || (priv->hold_names &&
+        g_hash_table_contains(priv->hold_names, property->name)));
+}
+
 static
 void
 ofono_object_emit_property_change_signals(
     OfonoObject* self,
     GPtrArray* plist)
 {
+    gboolean published = FALSE;
     guint i;
+
     for (i = 0; i < plist->len; i++) {
         const OfonoObjectProperty* property = plist->pdata[i];
         GVariant* value = NULL;
+
+        if (ofono_object_property_held(self, property)) {
+            /* Signal gets emitted by ofono_object_release_signals() */
+            ofono_object_hold_property(self, property);
+            continue;
+        }
+        if (!published) {
+            /* Publish the new state before anyone gets notified */
+            ofono_object_publish_snapshot(self);
+            published = TRUE;
+        }
+        ofono_event_stream_post(ofono_context_of(self),
+            OFONO_EVENT_PROPERTY_CHANGED, self->path, property->name,
+            self->priv->snapshot);
         ofono_object_emit_property_changed_signal(self, property);
         if (property->fn_value) {
             value = property->fn_value(self, property);
@@ -551,6 +730,7 @@ ofono_object_apply_properties(
             }
 
             g_hash_table_replace(priv->properties, g_strdup(name), value);
+            g_hash_table_remove(priv->optimistic, name);
             property = ofono_object_apply_property(self, name, value);
             if (property) {
                 /* Property has changed */
@@ -604,6 +784,7 @@ ofono_object_reset_properties(
 {
     GPtrArray* plist = ofono_object_reset_properties_r(self,
         OFONO_OBJECT_GET_CLASS(self), NULL);
+    g_hash_table_remove_all(self->priv->optimistic);
     if (plist) {
         ofono_object_emit_property_change_signals(self, plist);
         g_ptr_array_free(plist, TRUE);
@@ -628,6 +809,9 @@ ofono_object_property_changed(
         g_variant_get_variant(variant) : g_variant_ref(variant);
     g_hash_table_replace(priv->properties, g_strdup(name), value);
 
+    /* This confirms (or overrides) the locally applied value */
+    g_hash_table_remove(priv->optimistic, name);
+
 #if GUTIL_LOG_VERBOSE
     if (GLOG_ENABLED(GLOG_LEVEL_VERBOSE)) {
         gchar* text = g_variant_print(value, FALSE);
@@ -638,7 +822,13 @@ ofono_object_property_changed(
 
     g_variant_ref(value);
     changed = ofono_object_apply_property(self, name, value);
-    if (changed) {
+    if (changed && ofono_object_property_held(self, changed)) {
+        ofono_object_hold_property(self, changed);
+    } else if (changed) {
+        ofono_object_publish_snapshot(self);
+        ofono_event_stream_post(ofono_context_of(self),
+            OFONO_EVENT_PROPERTY_CHANGED, self->path, changed->name,
+            priv->snapshot);
         ofono_object_emit_property_changed_signal(self, changed);
         g_signal_emit(self, ofono_object_signals
             [OFONO_OBJECT_SIGNAL_PROPERTY_CHANGED], detail, name, value);
@@ -646,15 +836,172 @@ ofono_object_property_changed(
     g_variant_unref(value);
 }
 
+/*
+ * While signals are held, changes of the held properties are applied but
+ * not reported. Releasing the last hold emits one signal per changed
+ * property. NULL names hold all properties.
+ */
+void
+ofono_object_hold_signals(
+    OfonoObject* self,
+    const char* const* names)
+{
+    OfonoObjectPriv* priv = self->priv;
+    if (!names) {
+        priv->hold_all = TRUE;
+    } else if (!priv->hold_all) {
+        if (!priv->hold_names) {
+            priv->hold_names = g_hash_table_new_full(g_str_hash,
+                g_str_equal, g_free, NULL);
+        }
+        while (*names) {
+            g_hash_table_add(priv->hold_names, g_strdup(*names++));
+        }
+    }
+    priv->hold_count++;
+}
+
+void
+ofono_object_release_signals(
+    OfonoObject* self)
+{
+    OfonoObjectPriv* priv = self->priv;
+    GASSERT(priv->hold_count > 0);
+    if (!--priv->hold_count) {
+        priv->hold_all = FALSE;
+        if (priv->hold_names) {
+            g_hash_table_destroy(priv->hold_names);
+            priv->hold_names = NULL;
+        }
+    }
+    if (!priv->hold_count && priv->held_properties) {
+        GPtrArray* plist = priv->held_properties;
+        priv->held_properties = NULL;
+        ofono_object_emit_property_change_signals(self, plist);
+        g_ptr_array_free(plist, TRUE);
+    }
+}
+
+/*==========================================================================*
+ * Optimistic updates
+ *
+ * The requested value is applied locally (and the change signals are
+ * emitted) before the SetProperty call is even sent. PropertyChanged
+ * signal or successful completion of the call confirm the new value.
+ * If the last outstanding call fails before that, the last confirmed
+ * value gets restored and the change signals are emitted again.
+ *==========================================================================*/
+
+static
+void
+ofono_object_optimistic_free(
+    gpointer data)
+{
+    OfonoObjectOptimistic* entry = data;
+    if (entry->confirmed) g_variant_unref(entry->confirmed);
+    g_slice_free(OfonoObjectOptimistic, entry);
+}
+
 static
 void
-ofono_object_set_property_finished(
+ofono_object_update_property(
+    OfonoObject* self,
+    const char* name,
+    GVariant* value)
+{
+    OfonoObjectPriv* priv = self->priv;
+    const OfonoObjectProperty* changed;
+
+    if (value) {
+        g_hash_table_replace(priv->properties, g_strdup(name),
+            g_variant_ref(value));
+    } else {
+        g_hash_table_remove(priv->properties, name);
+    }
+    changed = ofono_object_apply_property(self, name, value);
+    if (changed) {
+        GPtrArray* plist = g_ptr_array_new();
+        g_ptr_array_add(plist, (gpointer) changed);
+        ofono_object_emit_property_change_signals(self, plist);
+        g_ptr_array_free(plist, TRUE);
+    }
+}
+
+static
+void
+ofono_object_optimistic_call_finished(
+    OfonoObject* self,
+    const GError* error,
+    void* arg)
+{
+    OfonoObjectOptimisticCall* call = arg;
+    OfonoObjectPriv* priv = self->priv;
+    OfonoObjectOptimistic* entry = g_hash_table_lookup(priv->optimistic,
+        call->name);
+
+    /* Entry may have been confirmed and replaced by a newer one */
+    if (entry && entry->serial == call->serial) {
+        GASSERT(entry->calls > 0);
+        if (!--entry->calls) {
+            GVariant* confirmed = entry->confirmed;
+            entry->confirmed = NULL;
+            g_hash_table_remove(priv->optimistic, call->name);
+            if (error) {
+                GDEBUG("%s %s rolled back", priv->path, call->name);
+                ofono_object_update_property(self, call->name, confirmed);
+            }
+            if (confirmed) g_variant_unref(confirmed);
+        }
+    }
+
+    if (call->callback) call->callback(self, error, call->arg);
+    g_free(call->name);
+    g_slice_free(OfonoObjectOptimisticCall, call);
+}
+
+static
+OfonoObjectOptimisticCall*
+ofono_object_optimistic_apply(
+    OfonoObject* self,
+    const char* name,
+    GVariant* value,
+    OfonoObjectCallFinishedCallback callback,
+    void* arg)
+{
+    OfonoObjectPriv* priv = self->priv;
+    OfonoObjectOptimisticCall* call = NULL;
+    OfonoObjectOptimistic* entry = g_hash_table_lookup(priv->optimistic, name);
+    GVariant* cached = g_hash_table_lookup(priv->properties, name);
+    GVariant* v = g_variant_is_of_type(value, G_VARIANT_TYPE_VARIANT) ?
+        g_variant_get_variant(value) : g_variant_ref(value);
+
+    if (entry || !cached || !g_variant_equal(cached, v)) {
+        if (!entry) {
+            entry = g_slice_new0(OfonoObjectOptimistic);
+            entry->serial = ++priv->optimistic_serial;
+            if (cached) entry->confirmed = g_variant_ref(cached);
+            g_hash_table_insert(priv->optimistic, g_strdup(name), entry);
+        }
+        entry->calls++;
+        call = g_slice_new0(OfonoObjectOptimisticCall);
+        call->name = g_strdup(name);
+        call->serial = entry->serial;
+        call->callback = callback;
+        call->arg = arg;
+        ofono_object_update_property(self, name, v);
+    }
+    g_variant_unref(v);
+    return call;
+}
+
+static
+GError*
+ofono_object_set_property_result(
+    OfonoObject* self,
     GDBusProxy* proxy,
-    GAsyncResult* result,
-    const OfonoObjectPendingCall* call)
+    GAsyncResult* result)
 {
     GError* error = NULL;
-    OfonoObject* self = call->object;
     OfonoObjectClass* klass = OFONO_OBJECT_GET_CLASS(self);
 
     /* Retrieve the result */
@@ -666,6 +1013,18 @@ ofono_object_set_property_finished(
             GERR("%s", GERRMSG(error));
         }
     }
+    return error;
+}
+
+static
+void
+ofono_object_set_property_finished(
+    GDBusProxy* proxy,
+    GAsyncResult* result,
+    const OfonoObjectPendingCall* call)
+{
+    OfonoObject* self = call->object;
+    GError* error = ofono_object_set_property_result(self, proxy, result);
 
     /* Notify the derived class if necessary */
     if (call->callback) call->callback(self, error, call->arg);
@@ -674,6 +1033,260 @@ ofono_object_set_property_finished(
     if (error) g_error_free(error);
 }
 
+/*==========================================================================*
+ * Write combining
+ *
+ * At most one SetProperty call per property is in flight. While it's in
+ * progress, only the latest requested value is kept. It gets sent when
+ * the current call completes, unless it's equal to the cached value by
+ * then. All requests which have been combined into one call receive the
+ * result of that call.
+ *==========================================================================*/
+
+static
+OfonoObjectWriteRequest*
+ofono_object_write_request_new(
+    OfonoObject* self,
+    GCancellable* cancellable,
+    OfonoObjectCallFinishedCallback callback,
+    void* arg)
+{
+    OfonoObjectWriteRequest* req = g_slice_new0(OfonoObjectWriteRequest);
+    if (cancellable) {
+        /* This one is already tracked by the pending call */
+        g_object_ref(req->cancellable = cancellable);
+    } else {
+        req->cancellable = g_cancellable_new();
+        req->group = ofono_call_group_ref(self->priv->call_group);
+        ofono_call_group_add(req->group, req->cancellable);
+    }
+    req->callback = callback;
+    req->arg = arg;
+    return req;
+}
+
+static
+void
+ofono_object_write_request_complete(
+    OfonoObject* self,
+    OfonoObjectWriteRequest* req,
+    const GError* error)
+{
+    if (req->callback) {
+        if (!error && g_cancellable_is_cancelled(req->cancellable)) {
+            GError* cancelled = g_error_new_literal(G_IO_ERROR,
+                G_IO_ERROR_CANCELLED, "Operation was cancelled");
+            req->callback(self, cancelled, req->arg);
+            g_error_free(cancelled);
+        } else {
+            req->callback(self, error, req->arg);
+        }
+    }
+    ofono_call_group_remove(req->group, req->cancellable);
+    ofono_call_group_unref(req->group);
+    g_object_unref(req->cancellable);
+    g_slice_free(OfonoObjectWriteRequest, req);
+}
+
+static
+void
+ofono_object_write_complete_all(
+    OfonoObject* self,
+    GSList* requests,
+    const GError* error)
+{
+    GSList* l;
+    for (l = requests; l; l = l->next) {
+        ofono_object_write_request_complete(self, l->data, error);
+    }
+    g_slist_free(requests);
+}
+
+static
+gboolean
+ofono_object_write_done(
+    gpointer data)
+{
+    OfonoObjectWriteDone* done = data;
+    ofono_object_write_request_complete(done->object, done->request, NULL);
+    ofono_object_unref(done->object);
+    g_slice_free(OfonoObjectWriteDone, done);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+ofono_object_write_unchanged(
+    OfonoObject* self,
+    const char* name,
+    GVariant* value)
+{
+    gboolean unchanged = FALSE;
+    if (self->valid) {
+        OfonoObjectPriv* priv = self->priv;
+        OfonoObjectOptimistic* entry = g_hash_table_lookup(priv->optimistic,
+            name);
+        /* Compare against the value which oFono is known to have */
+        GVariant* cached = entry ? entry->confirmed :
+            g_hash_table_lookup(priv->properties, name);
+        if (cached) {
+            GVariant* v = g_variant_is_of_type(value, G_VARIANT_TYPE_VARIANT) ?
+                g_variant_get_variant(value) : g_variant_ref(value);
+            unchanged = g_variant_equal(cached, v);
+            g_variant_unref(v);
+        }
+    }
+    return unchanged;
+}
+
+static
+void
+ofono_object_write_free(
+    OfonoObject* self,
+    OfonoObjectWrite* write)
+{
+    OfonoObjectPriv* priv = self->priv;
+    GASSERT(!write->requests);
+    GASSERT(!write->next_requests);
+    GASSERT(!write->next_value);
+    g_hash_table_remove(priv->writes, write->name);
+    g_free(write->name);
+    g_slice_free(OfonoObjectWrite, write);
+}
+
+static
+void
+ofono_object_write_finished(
+    GDBusProxy* proxy,
+    GAsyncResult* result,
+    const OfonoObjectPendingCall* call);
+
+static
+GCancellable*
+ofono_object_write_send(
+    OfonoObject* self,
+    OfonoObjectWrite* write,
+    GVariant* value,
+    int timeout_msec)
+{
+    OfonoObjectPriv* priv = self->priv;
+    OfonoObjectClass* klass = OFONO_OBJECT_GET_CLASS(self);
+    OfonoObjectPendingCall* pc = ofono_object_pending_call_new_full(self,
+        timeout_msec, ofono_object_write_finished, NULL, write);
+    GVERBOSE("%s %s (combined)", priv->path, write->name);
+    klass->fn_proxy_call_set_property(priv->proxy, write->name, value,
+        pc->cancellable, ofono_object_pending_call_finished, pc);
+    return pc->cancellable;
+}
+
+static
+void
+ofono_object_write_next(
+    OfonoObject* self,
+    OfonoObjectWrite* write)
+{
+    GVariant* value = write->next_value;
+    GSList* requests = write->next_requests;
+    GSList* live = NULL;
+    GSList* l;
+
+    write->next_value = NULL;
+    write->next_requests = NULL;
+
+    /*
+     * Drop the requests which have been cancelled in the meantime. The
+     * outcome of the previous call has nothing to do with the queued
+     * requests, they may have come from other callers.
+     */
+    for (l = requests; l; l = l->next) {
+        OfonoObjectWriteRequest* req = l->data;
+        if (g_cancellable_is_cancelled(req->cancellable)) {
+            ofono_object_write_request_complete(self, req, NULL);
+        } else {
+            live = g_slist_append(live, req);
+        }
+    }
+    g_slist_free(requests);
+
+    if (live) {
+        if (ofono_object_write_unchanged(self, write->name, value)) {
+            /* Nothing to do */
+            ofono_object_write_complete_all(self, live, NULL);
+        } else {
+            write->requests = live;
+            ofono_object_write_send(self, write, value, write->next_timeout);
+            g_variant_unref(value);
+            return;
+        }
+    }
+    g_variant_unref(value);
+}
+
+static
+void
+ofono_object_write_finished(
+    GDBusProxy* proxy,
+    GAsyncResult* result,
+    const OfonoObjectPendingCall* call)
+{
+    OfonoObject* self = call->object;
+    OfonoObjectWrite* write = call->arg;
+    GError* error = ofono_object_set_property_result(self, proxy, result);
+    GSList* requests = write->requests;
+
+    /* Completion callbacks may submit new requests for the same property */
+    write->requests = NULL;
+    ofono_object_write_complete_all(self, requests, error);
+    while (!write->requests && write->next_value) {
+        ofono_object_write_next(self, write);
+    }
+    if (!write->requests) {
+        ofono_object_write_free(self, write);
+    }
+    if (error) g_error_free(error);
+}
+
+static
+GCancellable*
+ofono_object_write(
+    OfonoObject* self,
+    const char* name,
+    GVariant* value,
+    int timeout_msec,
+    OfonoObjectCallFinishedCallback callback,
+    void* arg)
+{
+    OfonoObjectPriv* priv = self->priv;
+    OfonoObjectWrite* write = g_hash_table_lookup(priv->writes, name);
+    OfonoObjectWriteRequest* req;
+
+    if (write) {
+        /* The previous pending value (if any) gets dropped */
+        GVERBOSE("%s %s (pending)", priv->path, name);
+        req = ofono_object_write_request_new(self, NULL, callback, arg);
+        if (write->next_value) g_variant_unref(write->next_value);
+        write->next_value = g_variant_ref(value);
+        write->next_timeout = timeout_msec;
+        write->next_requests = g_slist_append(write->next_requests, req);
+    } else if (ofono_object_write_unchanged(self, name, value)) {
+        OfonoObjectWriteDone* done = g_slice_new(OfonoObjectWriteDone);
+        GVERBOSE("%s %s (unchanged)", priv->path, name);
+        req = ofono_object_write_request_new(self, NULL, callback, arg);
+        done->object = ofono_object_ref(self);
+        done->request = req;
+        ofono_idle_add(ofono_context_of(self), ofono_object_write_done, done);
+    } else {
+        GCancellable* cancellable;
+        write = g_slice_new0(OfonoObjectWrite);
+        write->name = g_strdup(name);
+        g_hash_table_insert(priv->writes, write->name, write);
+        cancellable = ofono_object_write_send(self, write, value, timeout_msec);
+        req = ofono_object_write_request_new(self, cancellable, callback, arg);
+        write->requests = g_slist_append(NULL, req);
+    }
+    return req->cancellable;
+}
+
 /*==========================================================================*
  * API
  *==========================================================================*/
@@ -709,6 +1322,26 @@ ofono_object_unref(
     }
 }
 
+static
+void
+ofono_object_bus_ready(
+    OfonoContext* context,
+    GDBusConnection* bus,
+    gpointer data)
+{
+    OfonoObject* self = OFONO_OBJECT(data);
+    OfonoObjectPriv* priv = self->priv;
+    priv->bus_call_id = 0;
+    if (bus) {
+        GASSERT(!priv->bus);
+        priv->bus = g_object_ref(bus);
+        OFONO_OBJECT_GET_CLASS(self)->fn_proxy_new(priv->bus,
+            G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES, OFONO_SERVICE,
+            self->path, NULL, ofono_object_create_proxy_finished,
+            ofono_object_ref(self));
+    }
+}
+
 void
 ofono_object_initialize(
     OfonoObject* self,
@@ -719,12 +1352,9 @@ ofono_object_initialize(
     GASSERT(!priv->path);
     self->intf = priv->intf = g_strdup(intf);
     self->path = priv->path = g_strdup(path);
-    if (priv->bus) {
-        OFONO_OBJECT_GET_CLASS(self)->fn_proxy_new(priv->bus,
-            G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES, OFONO_SERVICE,
-            self->path, NULL, ofono_object_create_proxy_finished,
-            ofono_object_ref(self));
-    }
+    ofono_object_publish_snapshot(self);
+    priv->bus_call_id = ofono_context_bus_call(ofono_context_of(self),
+        ofono_object_bus_ready, self);
 }
 
 void
@@ -748,6 +1378,9 @@ ofono_object_update_valid(
     const gboolean valid = klass->fn_is_valid(self);
     if (self->valid != valid) {
         self->valid = valid;
+        ofono_object_publish_snapshot(self);
+        ofono_event_stream_post(ofono_context_of(self),
+            OFONO_EVENT_VALID_CHANGED, self->path, NULL, self->priv->snapshot);
         klass->fn_valid_changed(self);
     }
 }
@@ -767,6 +1400,8 @@ ofono_object_query_properties(
 
                 call = g_slice_new0(OfonoObjectGetPropertiesCall);
                 call->cancel = g_cancellable_new();
+                call->group = ofono_call_group_ref(priv->call_group);
+                ofono_call_group_add(call->group, call->cancel);
                 call->object = self;
                 g_object_ref(call->proxy = priv->proxy);
                 call->fn_finish = klass->fn_proxy_call_get_properties_finish;
@@ -777,6 +1412,7 @@ ofono_object_query_properties(
                 ofono_object_cancel_get_properties(self);
                 priv->get_properties_ok = FALSE;
                 priv->get_properties_pending = call;
+                ofono_object_prepare_call(self, OFONO_CALL_TIMEOUT_DEFAULT);
                 klass->fn_proxy_call_get_properties(priv->proxy, call->cancel,
                     ofono_object_setup_finished, call);
             }
@@ -802,7 +1438,8 @@ ofono_object_get_properties(
         g_variant_builder_add(&builder, "{sv}", key, value);
     }
     properties = g_variant_take_ref(g_variant_builder_end(&builder));
-    gutil_idle_pool_add_variant(priv->pool, properties);
+    ofono_idle_pool_add(ofono_context_of(self), properties,
+        (GDestroyNotify)g_variant_unref);
     return properties;
 }
 
@@ -815,7 +1452,8 @@ ofono_object_get_property(
     OfonoObjectPriv* priv = self->priv;
     GVariant* value = g_hash_table_lookup(priv->properties, name);
     if (value && (!type || g_variant_is_of_type(value, type))) {
-        gutil_idle_pool_add_variant_ref(priv->pool, value);
+        ofono_idle_pool_add(ofono_context_of(self), g_variant_ref(value),
+            (GDestroyNotify)g_variant_unref);
         return value;
     } else {
         return NULL;
@@ -859,7 +1497,8 @@ ofono_object_get_property_keys(
     GPtrArray* keys = g_ptr_array_new_with_free_func(g_free);
     g_hash_table_foreach(priv->properties,
         ofono_object_get_property_keys_callback, keys);
-    gutil_idle_pool_add_ptr_array(priv->pool, keys);
+    ofono_idle_pool_add(ofono_context_of(self), keys,
+        (GDestroyNotify)g_ptr_array_unref);
     return keys;
 }
 
@@ -870,6 +1509,19 @@ ofono_object_set_property(
     GVariant* value,
     OfonoObjectCallFinishedCallback callback,
     void* arg)
+{
+    return ofono_object_set_property_full(self, name, value,
+        OFONO_CALL_TIMEOUT_DEFAULT, callback, arg);
+}
+
+GCancellable*
+ofono_object_set_property_full(
+    OfonoObject* self,
+    const char* name,
+    GVariant* value,
+    int timeout_msec,
+    OfonoObjectCallFinishedCallback callback,
+    void* arg)
 {
     GCancellable* cancellable = NULL;
     g_variant_ref_sink(value);
@@ -879,11 +1531,27 @@ ofono_object_set_property(
             OfonoObjectPriv* priv = self->priv;
             GASSERT(priv->proxy);
             if (G_LIKELY(priv->proxy)) {
-                OfonoObjectPendingCall* pc = ofono_object_pending_call_new(self,
-                    ofono_object_set_property_finished, callback, arg);
-                klass->fn_proxy_call_set_property(priv->proxy, name, value,
-                    pc->cancellable, ofono_object_pending_call_finished, pc);
-                cancellable = pc->cancellable;
+                if (priv->write_flags & OFONO_OBJECT_WRITE_OPTIMISTIC) {
+                    OfonoObjectOptimisticCall* oc =
+                        ofono_object_optimistic_apply(self, name, value,
+                            callback, arg);
+                    if (oc) {
+                        callback = ofono_object_optimistic_call_finished;
+                        arg = oc;
+                    }
+                }
+                if (priv->write_flags & OFONO_OBJECT_WRITE_COMBINE) {
+                    cancellable = ofono_object_write(self, name, value,
+                        timeout_msec, callback, arg);
+                } else {
+                    OfonoObjectPendingCall* pc =
+                        ofono_object_pending_call_new_full(self, timeout_msec,
+                            ofono_object_set_property_finished, callback, arg);
+                    klass->fn_proxy_call_set_property(priv->proxy, name, value,
+                        pc->cancellable, ofono_object_pending_call_finished,
+                        pc);
+                    cancellable = pc->cancellable;
+                }
             }
         }
     }
@@ -929,7 +1597,7 @@ ofono_object_add_valid_changed_handler(
     OfonoObjectHandler handler,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? ofono_signal_connect(self,
         OFONO_OBJECT_SIGNAL_VALID_CHANGED_NAME, G_CALLBACK(handler), arg) : 0;
 }
 
@@ -952,7 +1620,7 @@ ofono_object_add_property_changed_handler(
             tmp = NULL;
             signal_name = OFONO_OBJECT_SIGNAL_PROPERTY_CHANGED_NAME;
         }
-        id = g_signal_connect(self, signal_name, G_CALLBACK(fn), arg);
+        id = ofono_signal_connect(self, signal_name, G_CALLBACK(fn), arg);
         g_free(tmp);
     }
     return id;
@@ -977,6 +1645,91 @@ ofono_object_remove_handlers(
     gutil_disconnect_handlers(self, ids, count);
 }
 
+void
+ofono_object_class_set_call_timeout(
+    GType type,
+    int timeout_msec)
+{
+    if (g_type_is_a(type, OFONO_TYPE_OBJECT)) {
+        OfonoObjectClass* klass = g_type_class_ref(type);
+        klass->call_timeout = (timeout_msec < 0) ?
+            OFONO_CALL_TIMEOUT_DEFAULT : timeout_msec;
+        g_type_class_unref(klass);
+    }
+}
+
+void
+ofono_object_set_call_timeout(
+    OfonoObject* self,
+    int timeout_msec)
+{
+    if (G_LIKELY(self)) {
+        self->priv->call_timeout = (timeout_msec < 0) ?
+            OFONO_CALL_TIMEOUT_DEFAULT : timeout_msec;
+    }
+}
+
+void
+ofono_object_set_call_group(
+    OfonoObject* self,
+    OfonoCallGroup* group)
+{
+    if (G_LIKELY(self)) {
+        OfonoObjectPriv* priv = self->priv;
+        if (priv->call_group != group) {
+            /* Calls already in progress stay in the old group */
+            ofono_call_group_unref(priv->call_group);
+            priv->call_group = ofono_call_group_ref(group);
+        }
+    }
+}
+
+void
+ofono_object_set_write_flags(
+    OfonoObject* self,
+    OFONO_OBJECT_WRITE_FLAGS flags)
+{
+    if (G_LIKELY(self)) {
+        self->priv->write_flags = flags;
+    }
+}
+
+gboolean
+ofono_object_property_pending(
+    OfonoObject* self,
+    const char* name)
+{
+    return G_LIKELY(self) && G_LIKELY(name) &&
+        g_hash_table_contains(self->priv->optimistic, name);
+}
+
+OfonoCallGroup*
+ofono_object_call_group(
+    OfonoObject* self)
+{
+    return G_LIKELY(self) ? self->priv->call_group : NULL;
+}
+
+void
+ofono_object_cancel_calls(
+    OfonoObject* self)
+{
+    if (G_LIKELY(self)) {
+        GList* l;
+        for (l = self->priv->pending_calls; l; l = l->next) {
+            OfonoObjectPendingCall* call = l->data;
+            g_cancellable_cancel(call->cancellable);
+        }
+    }
+}
+
+OfonoSnapshot*
+ofono_object_snapshot(
+    OfonoObject* self)
+{
+    return G_LIKELY(self) ? ofono_snapshot_get(&self->priv->snapshot) : NULL;
+}
+
 GDBusConnection*
 ofono_object_bus(
     OfonoObject* self)
@@ -1289,16 +2042,6 @@ ofono_object_is_valid(
         !priv->get_properties_retry_id && priv->get_properties_ok;
 }
 
-static
-void
-ofono_object_cancel_call(
-    gpointer list_data,
-    gpointer user_data)
-{
-    OfonoObjectPendingCall* call = list_data;
-    g_cancellable_cancel(call->cancellable);
-}
-
 static
 void
 ofono_object_ready_changed(
@@ -1316,7 +2059,7 @@ ofono_object_ready_changed(
         priv->get_properties_ok = FALSE;
         ofono_object_cancel_get_properties(self);
         ofono_object_reset_properties(self);
-        g_list_foreach(priv->pending_calls, ofono_object_cancel_call, NULL);
+        ofono_object_cancel_calls(self);
         ofono_object_update_valid(self);
     }
 }
@@ -1353,6 +2096,11 @@ ofono_object_dispose(
     OfonoObject* self = OFONO_OBJECT(object);
     OfonoObjectPriv* priv = self->priv;
     ofono_object_cancel_get_properties(self);
+    if (priv->bus_call_id) {
+        ofono_context_bus_call_cancel(ofono_context_of(self),
+            priv->bus_call_id);
+        priv->bus_call_id = 0;
+    }
     if (priv->proxy) {
         gutil_disconnect_handlers(priv->proxy,
             &priv->property_changed_signal_id, 1);
@@ -1363,6 +2111,10 @@ ofono_object_dispose(
         g_object_unref(priv->bus);
         priv->bus = NULL;
     }
+    if (priv->snapshot) {
+        ofono_snapshot_publish(ofono_context_of(self), &priv->snapshot,
+            NULL);
+    }
     G_OBJECT_CLASS(ofono_object_parent_class)->dispose(object);
 }
 
@@ -1377,7 +2129,12 @@ ofono_object_finalize(
     OfonoObject* self = OFONO_OBJECT(object);
     OfonoObjectPriv* priv = self->priv;
     GASSERT(!priv->pending_calls);
-    gutil_idle_pool_unref(priv->pool);
+    GASSERT(!g_hash_table_size(priv->writes));
+    g_hash_table_destroy(priv->writes);
+    g_hash_table_destroy(priv->optimistic);
+    if (priv->held_properties) g_ptr_array_free(priv->held_properties, TRUE);
+    if (priv->hold_names) g_hash_table_destroy(priv->hold_names);
+    ofono_call_group_unref(priv->call_group);
     g_hash_table_unref(priv->properties);
     g_free(priv->intf);
     g_free(priv->path);
@@ -1392,20 +2149,17 @@ void
 ofono_object_init(
     OfonoObject* self)
 {
-    GError* error = NULL;
+    OfonoContext* context = ofono_context_current();
     OfonoObjectPriv* priv = G_TYPE_INSTANCE_GET_PRIVATE(self,
         OFONO_TYPE_OBJECT, OfonoObjectPriv);
     self->priv = priv;
-    priv->pool = gutil_idle_pool_ref(ofono_idle_pool());
-    priv->bus = g_bus_get_sync(OFONO_BUS_TYPE, NULL, &error);
-    if (priv->bus) {
-        g_dbus_connection_set_exit_on_close(priv->bus, FALSE);
-    } else {
-        GERR("%s", GERRMSG(error));
-        g_error_free(error);
-    }
+    ofono_context_bind(self, context);
+    priv->call_timeout = OFONO_CALL_TIMEOUT_DEFAULT;
     priv->properties = g_hash_table_new_full(g_str_hash, g_str_equal,
         g_free, ofono_object_cleanup_property);
+    priv->writes = g_hash_table_new(g_str_hash, g_str_equal);
+    priv->optimistic = g_hash_table_new_full(g_str_hash, g_str_equal,
+        g_free, ofono_object_optimistic_free);
 }
 
 /**
@@ -1419,6 +2173,7 @@ ofono_object_class_init(
     GObjectClass* object_class = G_OBJECT_CLASS(klass);
     ofono_object_class = klass;
     g_type_class_add_private(klass, sizeof(OfonoObjectPriv));
+    klass->call_timeout = OFONO_CALL_TIMEOUT_DEFAULT;
     klass->fn_is_ready = ofono_object_is_ready;
     klass->fn_is_valid = ofono_object_is_valid;
     klass->fn_ready_changed = ofono_object_ready_changed;
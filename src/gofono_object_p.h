@@ -59,6 +59,7 @@ typedef struct ofono_object_class {
     GObjectClass object;
     OfonoObjectProperty* properties;
     guint nproperties;
+    int call_timeout;
     void (*fn_proxy_created)(
         OfonoObject* object,
         OFONO_OBJECT_PROXY* proxy);
@@ -71,6 +72,9 @@ typedef struct ofono_object_class {
         OfonoObject* object);
     void (*fn_valid_changed)(
         OfonoObject* object);
+    /* Copies typed state of the object into a new snapshot */
+    OfonoSnapshot* (*fn_snapshot)(
+        OfonoObject* object);
     /* Functions below point to generated stubs */
     void (*fn_proxy_new)(
         GDBusConnection* bus,
@@ -182,12 +186,30 @@ ofono_object_pending_call_new(
     OfonoObjectCallFinishedCallback callback,
     void* arg);
 
+OfonoObjectPendingCall*
+ofono_object_pending_call_new_full(
+    OfonoObject* object,
+    int timeout_msec,
+    OfonoObjectProxyCallFinishedCallback finished,
+    OfonoObjectCallFinishedCallback callback,
+    void* arg);
+
 void
 ofono_object_pending_call_finished(
     GObject* proxy,
     GAsyncResult* result,
     gpointer data);
 
+int
+ofono_object_call_timeout(
+    OfonoObject* object);
+
+/* Sets the timeout for the next call issued via the object's proxy */
+void
+ofono_object_prepare_call(
+    OfonoObject* object,
+    int timeout_msec);
+
 void
 ofono_object_query_properties(
     OfonoObject* object,
@@ -197,6 +219,19 @@ void
 ofono_object_reset_properties(
     OfonoObject* object);
 
+/*
+ * Defers change signals of the named properties (all if names is NULL)
+ * until the last hold is released
+ */
+void
+ofono_object_hold_signals(
+    OfonoObject* object,
+    const char* const* names);
+
+void
+ofono_object_release_signals(
+    OfonoObject* object);
+
 /* Properties */
 
 GVariant*
@@ -33,7 +33,8 @@
 #include "gofono_simmgr.h"
 #include "gofono_modem_p.h"
 #include "gofono_names.h"
-#include "gofono_util.h"
+#include "gofono_snapshot_p.h"
+#include "gofono_util_p.h"
 #include "gofono_log.h"
 
 /* Generated headers */
@@ -162,6 +163,14 @@ ofono_simmgr_unref(
     }
 }
 
+OfonoSimMgrSnapshot*
+ofono_simmgr_snapshot(
+    OfonoSimMgr* self)
+{
+    OfonoSnapshot* snapshot = ofono_object_snapshot(ofono_simmgr_object(self));
+    return snapshot ? G_CAST(snapshot, OfonoSimMgrSnapshot, snapshot) : NULL;
+}
+
 
 // TODO: const gchar* ?
 // TODO: return if operation succeeded ?
@@ -343,7 +352,7 @@ ofono_simmgr_add_imsi_changed_handler(
     OfonoSimMgrHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         SIMMGR_SIGNAL_IMSI_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -353,7 +362,7 @@ ofono_simmgr_add_mcc_changed_handler(
     OfonoSimMgrHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         SIMMGR_SIGNAL_MCC_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -363,7 +372,7 @@ ofono_simmgr_add_mnc_changed_handler(
     OfonoSimMgrHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         SIMMGR_SIGNAL_MNC_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -373,7 +382,7 @@ ofono_simmgr_add_spn_changed_handler(
     OfonoSimMgrHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         SIMMGR_SIGNAL_SPN_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -383,7 +392,7 @@ ofono_simmgr_add_present_changed_handler(
     OfonoSimMgrHandler fn,
     void* arg)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         SIMMGR_SIGNAL_PRESENT_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -393,7 +402,7 @@ ofono_simmgr_add_pin_required_changed_handler(
     OfonoSimMgrHandler fn,
     void* arg) /* Since 2.0.8 */
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ? g_signal_connect(self,
+    return (G_LIKELY(self) && G_LIKELY(fn)) ? ofono_signal_connect(self,
         SIMMGR_SIGNAL_PIN_REQUIRED_CHANGED_NAME, G_CALLBACK(fn), arg) : 0;
 }
 
@@ -453,6 +462,24 @@ ofono_simmgr_property_present_apply(
  * Internals
  *==========================================================================*/
 
+static
+OfonoSnapshot*
+ofono_simmgr_snapshot_new(
+    OfonoObject* object)
+{
+    OfonoSimMgr* self = OFONO_SIMMGR(object);
+    OfonoSnapshot* snapshot = ofono_snapshot_new(sizeof(OfonoSimMgrSnapshot));
+    OfonoSimMgrSnapshot* copy = G_CAST(snapshot, OfonoSimMgrSnapshot,
+        snapshot);
+    copy->present = self->present;
+    copy->imsi = ofono_snapshot_strdup(snapshot, self->imsi);
+    copy->mcc = ofono_snapshot_strdup(snapshot, self->mcc);
+    copy->mnc = ofono_snapshot_strdup(snapshot, self->mnc);
+    copy->spn = ofono_snapshot_strdup(snapshot, self->spn);
+    copy->pin_required = self->pin_required;
+    return snapshot;
+}
+
 /**
  * Per instance initializer
  */
@@ -512,6 +539,7 @@ ofono_simmgr_class_init(
     object_class->finalize = ofono_simmgr_finalize;
     g_type_class_add_private(klass, sizeof(OfonoSimMgrPriv));
     ofono->fn_proxy_created = ofono_simmgr_proxy_created;
+    ofono->fn_snapshot = ofono_simmgr_snapshot_new;
     ofono->properties = ofono_simmgr_properties;
     ofono->nproperties = G_N_ELEMENTS(ofono_simmgr_properties);
     OFONO_OBJECT_CLASS_SET_PROXY_CALLBACKS(ofono, org_ofono_sim_manager);
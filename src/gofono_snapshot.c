@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_snapshot_p.h"
+#include "gofono_context_p.h"
+#include "gofono_util_p.h"
+#include "gofono_log.h"
+
+#define OFONO_SNAPSHOT_RECLAIM_DELAY (10) /* ms */
+
+struct ofono_snapshot_priv {
+    gint ref_count;
+    GPtrArray* data;
+};
+
+/*
+ * Readers announce themselves in ofono_snapshot_readers while they are
+ * between loading the published pointer and taking a reference to it.
+ * A replaced snapshot is retired and the publisher's reference to it
+ * gets dropped only after the number of such readers has been seen
+ * dropping to zero, i.e. after a grace period. The list of retired
+ * snapshots belongs to the library context and is only touched by the
+ * thread running that context.
+ */
+static gint ofono_snapshot_readers = 0;
+
+static
+void
+ofono_snapshot_reclaim(
+    OfonoContext* context)
+{
+    GSList* list = context->retired_snapshots;
+    context->retired_snapshots = NULL;
+    g_slist_free_full(list, (GDestroyNotify)ofono_snapshot_unref);
+}
+
+static
+gboolean
+ofono_snapshot_reclaim_timeout(
+    gpointer data)
+{
+    OfonoContext* context = data;
+    if (g_atomic_int_get(&ofono_snapshot_readers)) {
+        /* Grace period hasn't expired yet */
+        return G_SOURCE_CONTINUE;
+    } else {
+        context->reclaim_id = 0;
+        ofono_snapshot_reclaim(context);
+        return G_SOURCE_REMOVE;
+    }
+}
+
+static
+void
+ofono_snapshot_retire(
+    OfonoContext* context,
+    OfonoSnapshot* snapshot)
+{
+    context->retired_snapshots = g_slist_prepend(context->retired_snapshots,
+        snapshot);
+    if (!g_atomic_int_get(&ofono_snapshot_readers)) {
+        /* Nobody can be holding the retired pointers */
+        if (context->reclaim_id) {
+            ofono_source_remove(context, context->reclaim_id);
+            context->reclaim_id = 0;
+        }
+        ofono_snapshot_reclaim(context);
+    } else if (!context->reclaim_id) {
+        context->reclaim_id = ofono_timeout_add(context,
+            OFONO_SNAPSHOT_RECLAIM_DELAY, ofono_snapshot_reclaim_timeout,
+            context);
+    }
+}
+
+static
+gpointer
+ofono_snapshot_keep(
+    OfonoSnapshot* self,
+    gpointer data)
+{
+    OfonoSnapshotPriv* priv = self->priv;
+    if (!priv->data) {
+        priv->data = g_ptr_array_new_with_free_func(g_free);
+    }
+    g_ptr_array_add(priv->data, data);
+    return data;
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+void
+ofono_snapshot_release_retired(
+    OfonoContext* context)
+{
+    if (context->reclaim_id) {
+        GSource* source = g_main_context_find_source_by_id(
+            context->main_context, context->reclaim_id);
+        if (source) g_source_destroy(source);
+        context->reclaim_id = 0;
+    }
+    /* The context is going away, wait for the grace period to expire */
+    while (g_atomic_int_get(&ofono_snapshot_readers)) {
+        g_thread_yield();
+    }
+    ofono_snapshot_reclaim(context);
+}
+
+OfonoSnapshot*
+ofono_snapshot_new(
+    gsize size)
+{
+    OfonoSnapshot* self;
+    GASSERT(size >= sizeof(OfonoSnapshot));
+    self = g_malloc0(size);
+    self->priv = g_slice_new0(OfonoSnapshotPriv);
+    self->priv->ref_count = 1;
+    return self;
+}
+
+const char*
+ofono_snapshot_strdup(
+    OfonoSnapshot* self,
+    const char* str)
+{
+    return str ? ofono_snapshot_keep(self, g_strdup(str)) : NULL;
+}
+
+gconstpointer
+ofono_snapshot_memdup(
+    OfonoSnapshot* self,
+    gconstpointer data,
+    gsize size)
+{
+    return (data && size) ?
+        ofono_snapshot_keep(self, ofono_memdup(data, size)) : NULL;
+}
+
+char* const*
+ofono_snapshot_strv(
+    OfonoSnapshot* self,
+    const GPtrArray* strings)
+{
+    if (strings) {
+        char** strv = g_new(char*, strings->len + 1);
+        guint i;
+        for (i = 0; i < strings->len; i++) {
+            strv[i] = (char*)ofono_snapshot_strdup(self, strings->pdata[i]);
+        }
+        strv[i] = NULL;
+        return ofono_snapshot_keep(self, strv);
+    }
+    return NULL;
+}
+
+char* const*
+ofono_snapshot_strv_dup(
+    OfonoSnapshot* self,
+    char* const* strv)
+{
+    if (strv) {
+        const guint n = g_strv_length((char**)strv);
+        char** copy = g_new(char*, n + 1);
+        guint i;
+        for (i = 0; i < n; i++) {
+            copy[i] = (char*)ofono_snapshot_strdup(self, strv[i]);
+        }
+        copy[i] = NULL;
+        return ofono_snapshot_keep(self, copy);
+    }
+    return NULL;
+}
+
+void
+ofono_snapshot_publish(
+    OfonoContext* context,
+    OfonoSnapshot** slot,
+    OfonoSnapshot* snapshot)
+{
+    /* Takes ownership of the new snapshot */
+    OfonoSnapshot* prev = g_atomic_pointer_get(slot);
+    g_atomic_pointer_set(slot, snapshot);
+    if (prev) {
+        ofono_snapshot_retire(context, prev);
+    }
+}
+
+OfonoSnapshot*
+ofono_snapshot_get(
+    OfonoSnapshot** slot)
+{
+    OfonoSnapshot* snapshot;
+    g_atomic_int_inc(&ofono_snapshot_readers);
+    snapshot = g_atomic_pointer_get(slot);
+    if (snapshot) {
+        g_atomic_int_inc(&snapshot->priv->ref_count);
+    }
+    g_atomic_int_dec_and_test(&ofono_snapshot_readers);
+    return snapshot;
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+OfonoSnapshot*
+ofono_snapshot_ref(
+    OfonoSnapshot* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->priv->ref_count > 0);
+        g_atomic_int_inc(&self->priv->ref_count);
+    }
+    return self;
+}
+
+void
+ofono_snapshot_unref(
+    OfonoSnapshot* self)
+{
+    if (G_LIKELY(self)) {
+        OfonoSnapshotPriv* priv = self->priv;
+        GASSERT(priv->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&priv->ref_count)) {
+            if (priv->data) {
+                g_ptr_array_free(priv->data, TRUE);
+            }
+            g_slice_free(OfonoSnapshotPriv, priv);
+            g_free(self);
+        }
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GOFONO_SNAPSHOT_PRIVATE_H
+#define GOFONO_SNAPSHOT_PRIVATE_H
+
+#include "gofono_snapshot.h"
+
+/*
+ * Snapshots are created and published on the library thread. Readers
+ * only ever take references to the published ones.
+ */
+
+OfonoSnapshot*
+ofono_snapshot_new(
+    gsize size);
+
+const char*
+ofono_snapshot_strdup(
+    OfonoSnapshot* snapshot,
+    const char* str);
+
+char* const*
+ofono_snapshot_strv(
+    OfonoSnapshot* snapshot,
+    const GPtrArray* strings);
+
+char* const*
+ofono_snapshot_strv_dup(
+    OfonoSnapshot* snapshot,
+    char* const* strv);
+
+gconstpointer
+ofono_snapshot_memdup(
+    OfonoSnapshot* snapshot,
+    gconstpointer data,
+    gsize size);
+
+/* The previous snapshot is retired by the context which owns the slot */
+void
+ofono_snapshot_publish(
+    OfonoContext* context,
+    OfonoSnapshot** slot,
+    OfonoSnapshot* snapshot);
+
+OfonoSnapshot*
+ofono_snapshot_get(
+    OfonoSnapshot** slot);
+
+void
+ofono_snapshot_release_retired(
+    OfonoContext* context);
+
+#endif /* GOFONO_SNAPSHOT_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -31,8 +31,11 @@
  */
 
 #include "gofono_util_p.h"
+#include "gofono_context_p.h"
 #include "gofono_log.h"
 
+#include <string.h>
+
 typedef struct ofono_condition_wait_data {
     GMainLoop* loop;
     gboolean timed_out;
@@ -40,24 +43,398 @@ typedef struct ofono_condition_wait_data {
     OfonoConditionCheck check;
 } OfonoConditionWaitData;
 
-static GUtilIdlePool* ofono_shared_pool = NULL;
+typedef struct ofono_idle_item {
+    gpointer pointer;
+    GDestroyNotify destroy;
+} OfonoIdleItem;
+
+typedef struct ofono_invoke_data {
+    OfonoContext* context;
+    OfonoInvokeFunc fn;
+    void* arg;
+} OfonoInvokeData;
+
+/*
+ * Forwards signal emissions to another GMainContext. The copied values
+ * (including the reference to the emitting object) are released back
+ * on the owner context, so that the last reference never gets dropped
+ * by a foreign thread.
+ */
+typedef struct ofono_marshal_closure {
+    GClosure closure;
+    GClosure* target;
+    GMainContext* context;
+    GMainContext* owner;
+    gint invalid;                       /* Accessed atomically */
+} OfonoMarshalClosure;
+
+typedef struct ofono_marshal_call {
+    GClosure* closure;
+    guint n_values;
+    GValue* values;
+} OfonoMarshalCall;
+
+/*==========================================================================*
+ * Main context
+ *
+ * GUtilIdlePool drains itself on the default context. When the library
+ * runs on its own context, objects are released by the context's list
+ * of deferred objects instead, on the library thread.
+ *==========================================================================*/
 
-GUtilIdlePool*
-ofono_idle_pool()
+static
+void
+ofono_deferred_drain(
+    OfonoContext* context)
 {
-    return gutil_idle_pool_get(&ofono_shared_pool);
+    while (context->deferred && context->deferred->len) {
+        /* Destructors may add more items to the pool */
+        GPtrArray* items = context->deferred;
+        guint i;
+        context->deferred = NULL;
+        for (i = 0; i < items->len; i++) {
+            OfonoIdleItem* item = items->pdata[i];
+            item->destroy(item->pointer);
+            g_slice_free(OfonoIdleItem, item);
+        }
+        g_ptr_array_free(items, TRUE);
+    }
+}
+
+static
+gboolean
+ofono_deferred_idle(
+    gpointer data)
+{
+    OfonoContext* context = data;
+    context->deferred_id = 0;
+    ofono_deferred_drain(context);
+    return G_SOURCE_REMOVE;
 }
 
+static
 void
-ofono_idle_pool_drain()
+ofono_deferred_cancel(
+    OfonoContext* context)
+{
+    if (context->deferred_id) {
+        GSource* source = g_main_context_find_source_by_id(
+            context->main_context, context->deferred_id);
+        if (source) g_source_destroy(source);
+        context->deferred_id = 0;
+    }
+}
+
+static
+guint
+ofono_source_attach(
+    OfonoContext* context,
+    GSource* source,
+    GSourceFunc fn,
+    gpointer data)
+{
+    guint id;
+    g_source_set_callback(source, fn, data, NULL);
+    id = g_source_attach(source, context->main_context);
+    g_source_unref(source);
+    return id;
+}
+
+static
+gboolean
+ofono_invoke_proc(
+    gpointer data)
+{
+    OfonoInvokeData* invoke = data;
+    OfonoContext* context = invoke->context;
+    g_main_context_push_thread_default(context->main_context);
+    ofono_context_push_thread_default(context);
+    invoke->fn(invoke->arg);
+    ofono_context_pop_thread_default(context);
+    g_main_context_pop_thread_default(context->main_context);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+ofono_invoke_free(
+    gpointer data)
+{
+    OfonoInvokeData* invoke = data;
+    ofono_context_unref(invoke->context);
+    g_slice_free(OfonoInvokeData, invoke);
+}
+
+static
+gboolean
+ofono_marshal_call_proc(
+    gpointer data)
 {
-    if (ofono_shared_pool) {
-        gutil_idle_pool_ref(ofono_shared_pool);
-        gutil_idle_pool_drain(ofono_shared_pool);
-        gutil_idle_pool_unref(ofono_shared_pool);
+    OfonoMarshalCall* call = data;
+    OfonoMarshalClosure* mc = (OfonoMarshalClosure*)call->closure;
+    /* The handler may have been disconnected in the meantime */
+    if (!g_atomic_int_get(&mc->invalid)) {
+        g_closure_invoke(mc->target, NULL, call->n_values, call->values, NULL);
     }
+    return G_SOURCE_REMOVE;
 }
 
+static
+gboolean
+ofono_marshal_call_release(
+    gpointer data)
+{
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+ofono_marshal_call_destroy(
+    gpointer data)
+{
+    OfonoMarshalCall* call = data;
+    guint i;
+    for (i = 0; i < call->n_values; i++) {
+        g_value_unset(call->values + i);
+    }
+    g_free(call->values);
+    g_closure_unref(call->closure);
+    g_slice_free(OfonoMarshalCall, call);
+}
+
+static
+void
+ofono_marshal_call_free(
+    gpointer data)
+{
+    OfonoMarshalCall* call = data;
+    OfonoMarshalClosure* mc = (OfonoMarshalClosure*)call->closure;
+
+    /* Hand the values back to the owner context */
+    g_main_context_invoke_full(mc->owner, G_PRIORITY_DEFAULT,
+        ofono_marshal_call_release, call, ofono_marshal_call_destroy);
+}
+
+static
+void
+ofono_marshal_closure_marshal(
+    GClosure* closure,
+    GValue* return_value,
+    guint n_values,
+    const GValue* values,
+    gpointer hint,
+    gpointer marshal_data)
+{
+    OfonoMarshalClosure* mc = (OfonoMarshalClosure*)closure;
+    OfonoMarshalCall* call = g_slice_new(OfonoMarshalCall);
+    guint i;
+
+    /* Copying the values takes references to the objects and variants */
+    call->closure = g_closure_ref(closure);
+    call->n_values = n_values;
+    call->values = g_new0(GValue, n_values);
+    for (i = 0; i < n_values; i++) {
+        g_value_init(call->values + i, G_VALUE_TYPE(values + i));
+        g_value_copy(values + i, call->values + i);
+    }
+    g_main_context_invoke_full(mc->context, G_PRIORITY_DEFAULT,
+        ofono_marshal_call_proc, call, ofono_marshal_call_free);
+}
+
+static
+void
+ofono_marshal_closure_invalidate(
+    gpointer data,
+    GClosure* closure)
+{
+    OfonoMarshalClosure* mc = (OfonoMarshalClosure*)closure;
+    g_atomic_int_set(&mc->invalid, TRUE);
+}
+
+static
+void
+ofono_marshal_closure_finalize(
+    gpointer data,
+    GClosure* closure)
+{
+    OfonoMarshalClosure* mc = (OfonoMarshalClosure*)closure;
+    g_closure_unref(mc->target);
+    g_main_context_unref(mc->context);
+    g_main_context_unref(mc->owner);
+}
+
+void
+ofono_main_context_set(
+    GMainContext* context)
+{
+    OfonoContext* self = ofono_context_current();
+    if (self->main_context != context) {
+        ofono_deferred_drain(self);
+        ofono_deferred_cancel(self);
+        if (self->main_context) g_main_context_unref(self->main_context);
+        self->main_context = context ? g_main_context_ref(context) : NULL;
+    }
+}
+
+GMainContext*
+ofono_main_context()
+{
+    return ofono_context_current()->main_context;
+}
+
+void
+ofono_main_context_invoke(
+    OfonoInvokeFunc fn,
+    void* arg)
+{
+    if (G_LIKELY(fn)) {
+        OfonoContext* context = ofono_context_current();
+        OfonoInvokeData* invoke = g_slice_new(OfonoInvokeData);
+        invoke->context = ofono_context_ref(context);
+        invoke->fn = fn;
+        invoke->arg = arg;
+        g_main_context_invoke_full(context->main_context, G_PRIORITY_DEFAULT,
+            ofono_invoke_proc, invoke, ofono_invoke_free);
+    }
+}
+
+guint
+ofono_timeout_add(
+    OfonoContext* context,
+    guint msec,
+    GSourceFunc fn,
+    gpointer data)
+{
+    return ofono_source_attach(context, g_timeout_source_new(msec), fn, data);
+}
+
+guint
+ofono_timeout_add_seconds(
+    OfonoContext* context,
+    guint sec,
+    GSourceFunc fn,
+    gpointer data)
+{
+    return ofono_source_attach(context, g_timeout_source_new_seconds(sec),
+        fn, data);
+}
+
+guint
+ofono_idle_add(
+    OfonoContext* context,
+    GSourceFunc fn,
+    gpointer data)
+{
+    return ofono_source_attach(context, g_idle_source_new(), fn, data);
+}
+
+guint
+ofono_cancellable_add(
+    OfonoContext* context,
+    GCancellable* cancellable,
+    GCancellableSourceFunc fn,
+    gpointer data)
+{
+    return ofono_source_attach(context, g_cancellable_source_new(cancellable),
+        (GSourceFunc)fn, data);
+}
+
+void
+ofono_source_remove(
+    OfonoContext* context,
+    guint id)
+{
+    /* g_source_remove() only looks at the default context */
+    GSource* source = g_main_context_find_source_by_id(context->main_context,
+        id);
+    GASSERT(source);
+    if (source) {
+        g_source_destroy(source);
+    }
+}
+
+gulong
+ofono_signal_connect(
+    gpointer instance,
+    const char* signal,
+    GCallback callback,
+    gpointer data)
+{
+    gulong id;
+    GMainContext* main_context = ofono_context_of(instance)->main_context;
+    GMainContext* context = g_main_context_ref_thread_default();
+    if (main_context && context != main_context) {
+        /* Handler gets invoked on the thread which has registered it */
+        GClosure* closure = g_closure_new_simple(sizeof(OfonoMarshalClosure),
+            NULL);
+        OfonoMarshalClosure* mc = (OfonoMarshalClosure*)closure;
+        mc->target = g_cclosure_new(callback, data, NULL);
+        g_closure_ref(mc->target);
+        g_closure_sink(mc->target);
+        g_closure_set_marshal(mc->target, g_cclosure_marshal_generic);
+        mc->context = g_main_context_ref(context);
+        mc->owner = g_main_context_ref(main_context);
+        g_closure_set_marshal(closure, ofono_marshal_closure_marshal);
+        g_closure_add_invalidate_notifier(closure, NULL,
+            ofono_marshal_closure_invalidate);
+        g_closure_add_finalize_notifier(closure, NULL,
+            ofono_marshal_closure_finalize);
+        id = g_signal_connect_closure(instance, signal, closure, FALSE);
+    } else {
+        id = g_signal_connect(instance, signal, callback, data);
+    }
+    g_main_context_unref(context);
+    return id;
+}
+
+/*==========================================================================*
+ * Idle pool
+ *==========================================================================*/
+
+void
+ofono_idle_pool_add(
+    OfonoContext* context,
+    gpointer pointer,
+    GDestroyNotify destroy)
+{
+    if (context->main_context) {
+        OfonoIdleItem* item = g_slice_new(OfonoIdleItem);
+        item->pointer = pointer;
+        item->destroy = destroy;
+        if (!context->deferred) {
+            context->deferred = g_ptr_array_new();
+        }
+        g_ptr_array_add(context->deferred, item);
+        if (!context->deferred_id) {
+            context->deferred_id = ofono_idle_add(context,
+                ofono_deferred_idle, context);
+        }
+    } else {
+        gutil_idle_pool_add(context->pool, pointer, destroy);
+    }
+}
+
+void
+ofono_idle_pool_drain()
+{
+    OfonoContext* context = ofono_context_current();
+    gutil_idle_pool_drain(context->pool);
+    ofono_deferred_drain(context);
+}
+
+void
+ofono_idle_pool_release(
+    OfonoContext* context)
+{
+    gutil_idle_pool_drain(context->pool);
+    ofono_deferred_drain(context);
+    ofono_deferred_cancel(context);
+}
+
+/*==========================================================================*
+ * Condition wait
+ *==========================================================================*/
+
 static
 gboolean
 ofono_condition_wait_timeout(
@@ -94,13 +471,14 @@ ofono_condition_wait_internal(
 {
     gboolean ok;
     OfonoConditionWaitData wait;
+    OfonoContext* context = ofono_context_of(object);
     const gulong id = add_handler(object, ofono_condition_wait_handler, &wait);
     g_object_ref(object);
     memset(&wait, 0, sizeof(wait));
-    wait.loop = g_main_loop_new(NULL, TRUE);
+    wait.loop = g_main_loop_new(context->main_context, TRUE);
     wait.check = check;
     if (timeout_msec > 0) {
-        wait.timeout_id = g_timeout_add(timeout_msec,
+        wait.timeout_id = ofono_timeout_add(context, timeout_msec,
             ofono_condition_wait_timeout, &wait);
     }
 
@@ -108,7 +486,7 @@ ofono_condition_wait_internal(
     g_main_loop_unref(wait.loop);
 
     remove_handler(object, id);
-    if (wait.timeout_id) g_source_remove(wait.timeout_id);
+    if (wait.timeout_id) ofono_source_remove(context, wait.timeout_id);
     ok = check(object);
     g_object_unref(object);
     if (ok) {
@@ -219,6 +597,15 @@ ofono_string_array_equal(
     }
 }
 
+/* Replaces g_memdup() which is deprecated since glib 2.68 */
+gpointer
+ofono_memdup(
+    gconstpointer ptr,
+    gsize size)
+{
+    return (ptr && size) ? memcpy(g_malloc(size), ptr, size) : NULL;
+}
+
 int
 ofono_name_to_int(
     const OfonoNameIntMap* map,
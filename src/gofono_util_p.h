@@ -70,8 +70,61 @@ ofono_condition_wait(
     int timeout_msec,
     GError** error);
 
-GUtilIdlePool*
-ofono_idle_pool(void);
+/* Released on the context's main context, see ofono_main_context_set */
+void
+ofono_idle_pool_add(
+    OfonoContext* context,
+    gpointer pointer,
+    GDestroyNotify destroy);
+
+void
+ofono_idle_pool_release(
+    OfonoContext* context);
+
+/*
+ * Sources attached to the main context of the library context. The
+ * context which owns the source must be passed to ofono_source_remove,
+ * the thread default one may be different when it's being removed.
+ */
+
+guint
+ofono_timeout_add(
+    OfonoContext* context,
+    guint msec,
+    GSourceFunc fn,
+    gpointer data);
+
+guint
+ofono_timeout_add_seconds(
+    OfonoContext* context,
+    guint sec,
+    GSourceFunc fn,
+    gpointer data);
+
+guint
+ofono_idle_add(
+    OfonoContext* context,
+    GSourceFunc fn,
+    gpointer data);
+
+guint
+ofono_cancellable_add(
+    OfonoContext* context,
+    GCancellable* cancellable,
+    GCancellableSourceFunc fn,
+    gpointer data);
+
+void
+ofono_source_remove(
+    OfonoContext* context,
+    guint id);
+
+gulong
+ofono_signal_connect(
+    gpointer instance,
+    const char* signal,
+    GCallback callback,
+    gpointer data);
 
 GPtrArray*
 ofono_string_array_from_variant(
@@ -86,6 +139,11 @@ ofono_string_array_equal(
     GPtrArray* strings1,
     GPtrArray* strings2);
 
+gpointer
+ofono_memdup(
+    gconstpointer ptr,
+    gsize size);
+
 #endif /* GOFONO_UTIL_PRIVATE_H */
 
 /*
@@ -0,0 +1,444 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_apndb.h"
+
+#include <gutil_log.h>
+
+#include <string.h>
+
+#define RET_OK          (0)
+#define RET_NOTFOUND    (1)
+#define RET_ERR         (2)
+
+#define MAX_APNS        (64)
+
+/*
+ * Compiles serviceproviders.xml from mobile-broadband-provider-info:
+ *
+ * <serviceproviders>
+ *   <country code="xx">
+ *     <provider primary="true">
+ *       <name>Provider</name>
+ *       <gsm>
+ *         <network-id mcc="123" mnc="45"/>
+ *         <apn value="internet">
+ *           <usage type="internet"/>
+ *           <name>Internet</name>
+ *           <username>user</username>
+ *           <password>pass</password>
+ *           <authentication method="chap"/>
+ *           <mmsc>http://mms</mmsc>
+ *           <mmsproxy>1.2.3.4:8080</mmsproxy>
+ *         </apn>
+ *       </gsm>
+ *     </provider>
+ *   </country>
+ * </serviceproviders>
+ *
+ * CDMA providers are skipped.
+ */
+
+typedef struct network_id {
+    char* mcc;
+    char* mnc;
+} NetworkId;
+
+typedef struct apn_parser {
+    OfonoApnDbBuilder* builder;
+    GString* text;
+    GArray* networks;
+    GPtrArray* apns;
+    char* provider;
+    gboolean primary;
+    gboolean in_gsm;
+    gboolean in_apn;
+    gboolean skip_apn;
+    gboolean in_name;
+    OfonoApnDbApn apn;
+    guint count;
+} ApnParser;
+
+static
+void
+apn_parser_clear_apn(
+    ApnParser* parser)
+{
+    OfonoApnDbApn* apn = &parser->apn;
+    g_free((char*)apn->apn);
+    g_free((char*)apn->name);
+    g_free((char*)apn->username);
+    g_free((char*)apn->password);
+    g_free((char*)apn->mms_center);
+    g_free((char*)apn->mms_proxy);
+    memset(apn, 0, sizeof(*apn));
+    apn->type = OFONO_CONNCTX_TYPE_INTERNET;
+    apn->auth = OFONO_CONNCTX_AUTH_ANY;
+}
+
+static
+void
+apn_parser_clear_provider(
+    ApnParser* parser)
+{
+    guint i;
+    for (i = 0; i < parser->networks->len; i++) {
+        NetworkId* id = &g_array_index(parser->networks, NetworkId, i);
+        g_free(id->mcc);
+        g_free(id->mnc);
+    }
+    g_array_set_size(parser->networks, 0);
+    g_free(parser->provider);
+    parser->provider = NULL;
+    parser->primary = FALSE;
+}
+
+static
+const char*
+apn_parser_attr(
+    const char** names,
+    const char** values,
+    const char* name)
+{
+    guint i;
+    for (i = 0; names[i]; i++) {
+        if (!strcmp(names[i], name)) {
+            return values[i];
+        }
+    }
+    return NULL;
+}
+
+static
+void
+apn_parser_start_element(
+    GMarkupParseContext* context,
+    const char* element,
+    const char** names,
+    const char** values,
+    gpointer data,
+    GError** error)
+{
+    ApnParser* parser = data;
+
+    g_string_truncate(parser->text, 0);
+    if (!strcmp(element, "provider")) {
+        apn_parser_clear_provider(parser);
+        parser->primary = !g_strcmp0(apn_parser_attr(names, values,
+            "primary"), "true");
+    } else if (!strcmp(element, "gsm")) {
+        parser->in_gsm = TRUE;
+    } else if (parser->in_gsm) {
+        if (!strcmp(element, "network-id")) {
+            const char* mcc = apn_parser_attr(names, values, "mcc");
+            const char* mnc = apn_parser_attr(names, values, "mnc");
+            if (mcc && mnc) {
+                NetworkId id;
+                id.mcc = g_strdup(mcc);
+                id.mnc = g_strdup(mnc);
+                g_array_append_val(parser->networks, id);
+            }
+        } else if (!strcmp(element, "apn")) {
+            apn_parser_clear_apn(parser);
+            parser->apn.apn = g_strdup(apn_parser_attr(names, values,
+                "value"));
+            parser->in_apn = TRUE;
+            parser->skip_apn = FALSE;
+        } else if (parser->in_apn) {
+            if (!strcmp(element, "usage")) {
+                const char* type = apn_parser_attr(names, values, "type");
+                if (!g_strcmp0(type, "internet")) {
+                    parser->apn.type = OFONO_CONNCTX_TYPE_INTERNET;
+                } else if (!g_strcmp0(type, "mms")) {
+                    parser->apn.type = OFONO_CONNCTX_TYPE_MMS;
+                } else if (!g_strcmp0(type, "wap")) {
+                    parser->apn.type = OFONO_CONNCTX_TYPE_WAP;
+                } else if (!g_strcmp0(type, "ims")) {
+                    parser->apn.type = OFONO_CONNCTX_TYPE_IMS;
+                } else {
+                    GDEBUG("Skipping %s APN %s", type ? type : "(none)",
+                        parser->apn.apn ? parser->apn.apn : "(none)");
+                    parser->skip_apn = TRUE;
+                }
+            } else if (!strcmp(element, "authentication")) {
+                const char* method = apn_parser_attr(names, values,
+                    "method");
+                if (!g_strcmp0(method, "pap")) {
+                    parser->apn.auth = OFONO_CONNCTX_AUTH_PAP;
+                } else if (!g_strcmp0(method, "chap")) {
+                    parser->apn.auth = OFONO_CONNCTX_AUTH_CHAP;
+                } else if (!g_strcmp0(method, "none")) {
+                    parser->apn.auth = OFONO_CONNCTX_AUTH_NONE;
+                }
+            }
+        }
+    }
+}
+
+static
+void
+apn_parser_end_element(
+    GMarkupParseContext* context,
+    const char* element,
+    gpointer data,
+    GError** error)
+{
+    ApnParser* parser = data;
+    char* text = g_strstrip(g_strdup(parser->text->str));
+
+    g_string_truncate(parser->text, 0);
+    if (parser->in_apn) {
+        OfonoApnDbApn* apn = &parser->apn;
+        if (!strcmp(element, "apn")) {
+            if (!parser->skip_apn && apn->apn) {
+                /* Provider name is not known yet (it may follow <gsm>) */
+                g_ptr_array_add(parser->apns, g_slice_dup(OfonoApnDbApn,
+                    apn));
+                memset(apn, 0, sizeof(*apn));
+            }
+            apn_parser_clear_apn(parser);
+            parser->in_apn = FALSE;
+        } else if (!strcmp(element, "name")) {
+            g_free((char*)apn->name);
+            apn->name = text;
+            text = NULL;
+        } else if (!strcmp(element, "username")) {
+            g_free((char*)apn->username);
+            apn->username = text;
+            text = NULL;
+        } else if (!strcmp(element, "password")) {
+            g_free((char*)apn->password);
+            apn->password = text;
+            text = NULL;
+        } else if (!strcmp(element, "mmsc")) {
+            g_free((char*)apn->mms_center);
+            apn->mms_center = text;
+            text = NULL;
+        } else if (!strcmp(element, "mmsproxy")) {
+            g_free((char*)apn->mms_proxy);
+            apn->mms_proxy = text;
+            text = NULL;
+        }
+    } else if (!strcmp(element, "gsm")) {
+        parser->in_gsm = FALSE;
+    } else if (!strcmp(element, "name")) {
+        /* Provider name, the first one wins */
+        if (!parser->provider) {
+            parser->provider = text;
+            text = NULL;
+        }
+    } else if (!strcmp(element, "provider")) {
+        guint i, k;
+        for (i = 0; i < parser->apns->len; i++) {
+            OfonoApnDbApn* apn = parser->apns->pdata[i];
+            apn->provider = parser->provider;
+            for (k = 0; k < parser->networks->len; k++) {
+                NetworkId* id = &g_array_index(parser->networks,
+                    NetworkId, k);
+                if (ofono_apndb_builder_add(parser->builder, id->mcc,
+                    id->mnc, parser->primary, apn)) {
+                    parser->count++;
+                } else {
+                    GWARN("Invalid network %s/%s", id->mcc, id->mnc);
+                }
+            }
+            apn->provider = NULL;
+        }
+        g_ptr_array_set_size(parser->apns, 0);
+        apn_parser_clear_provider(parser);
+    }
+    g_free(text);
+}
+
+static
+void
+apn_parser_text(
+    GMarkupParseContext* context,
+    const char* text,
+    gsize len,
+    gpointer data,
+    GError** error)
+{
+    ApnParser* parser = data;
+    g_string_append_len(parser->text, text, len);
+}
+
+static
+void
+apn_parser_free_apn(
+    gpointer data)
+{
+    OfonoApnDbApn* apn = data;
+    g_free((char*)apn->apn);
+    g_free((char*)apn->name);
+    g_free((char*)apn->username);
+    g_free((char*)apn->password);
+    g_free((char*)apn->mms_center);
+    g_free((char*)apn->mms_proxy);
+    g_slice_free(OfonoApnDbApn, apn);
+}
+
+static
+int
+apndb_compile(
+    const char* in,
+    const char* out)
+{
+    int ret = RET_ERR;
+    char* buf = NULL;
+    gsize len = 0;
+    GError* error = NULL;
+
+    if (g_file_get_contents(in, &buf, &len, &error)) {
+        static const GMarkupParser apn_parser = {
+            apn_parser_start_element,
+            apn_parser_end_element,
+            apn_parser_text,
+            NULL,
+            NULL
+        };
+        ApnParser parser;
+        GMarkupParseContext* context;
+
+        memset(&parser, 0, sizeof(parser));
+        parser.builder = ofono_apndb_builder_new();
+        parser.text = g_string_new(NULL);
+        parser.networks = g_array_new(FALSE, FALSE, sizeof(NetworkId));
+        parser.apns = g_ptr_array_new_with_free_func(apn_parser_free_apn);
+        apn_parser_clear_apn(&parser);
+        context = g_markup_parse_context_new(&apn_parser, 0, &parser, NULL);
+        if (g_markup_parse_context_parse(context, buf, len, &error) &&
+            g_markup_parse_context_end_parse(context, &error) &&
+            ofono_apndb_builder_write(parser.builder, out, &error)) {
+            GDEBUG("%u APN(s) written to %s", parser.count, out);
+            ret = RET_OK;
+        }
+        g_markup_parse_context_free(context);
+        apn_parser_clear_apn(&parser);
+        apn_parser_clear_provider(&parser);
+        g_ptr_array_free(parser.apns, TRUE);
+        g_array_free(parser.networks, TRUE);
+        g_string_free(parser.text, TRUE);
+        ofono_apndb_builder_free(parser.builder);
+        g_free(buf);
+    }
+    if (error) {
+        GERR("%s", error->message);
+        g_error_free(error);
+    }
+    return ret;
+}
+
+static
+int
+apndb_lookup(
+    const char* path,
+    const char* mcc,
+    const char* mnc,
+    const char* spn)
+{
+    int ret = RET_ERR;
+    GError* error = NULL;
+    OfonoApnDb* db = ofono_apndb_open(path, &error);
+
+    if (db) {
+        OfonoApnDbApn apns[MAX_APNS];
+        const guint n = ofono_apndb_lookup(db, mcc, mnc, spn, apns,
+            G_N_ELEMENTS(apns));
+        guint i;
+
+        for (i = 0; i < n && i < G_N_ELEMENTS(apns); i++) {
+            const OfonoApnDbApn* apn = apns + i;
+            printf("%s\t%s\t%s\n", apn->provider ? apn->provider : "",
+                ofono_connctx_type_string(apn->type),
+                apn->apn ? apn->apn : "");
+            if (apn->name) printf("  Name: %s\n", apn->name);
+            if (apn->username) printf("  Username: %s\n", apn->username);
+            if (apn->password) printf("  Password: %s\n", apn->password);
+            printf("  Authentication: %s\n",
+                ofono_connctx_auth_string(apn->auth));
+            if (apn->mms_center) printf("  MMSC: %s\n", apn->mms_center);
+            if (apn->mms_proxy) printf("  MMS proxy: %s\n", apn->mms_proxy);
+        }
+        ret = n ? RET_OK : RET_NOTFOUND;
+        ofono_apndb_unref(db);
+    } else {
+        GERR("%s", error->message);
+        g_error_free(error);
+    }
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    int ret = RET_ERR;
+    gboolean verbose = FALSE;
+    GOptionEntry entries[] = {
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose,
+          "Enable verbose output", NULL },
+        { NULL }
+    };
+    GError* error = NULL;
+    GOptionContext* options = g_option_context_new("\n"
+        "  compile serviceproviders.xml FILE\n"
+        "  lookup FILE MCC MNC [SPN]");
+    gutil_log_timestamp = FALSE;
+    gutil_log_set_type(GLOG_TYPE_STDERR, "ofono-apndb");
+    gutil_log_default.level = GLOG_LEVEL_DEFAULT;
+    g_option_context_add_main_entries(options, entries, NULL);
+    if (g_option_context_parse(options, &argc, &argv, &error)) {
+        if (verbose) gutil_log_default.level = GLOG_LEVEL_VERBOSE;
+        if (argc == 4 && !strcmp(argv[1], "compile")) {
+            ret = apndb_compile(argv[2], argv[3]);
+        } else if ((argc == 5 || argc == 6) && !strcmp(argv[1], "lookup")) {
+            ret = apndb_lookup(argv[2], argv[3], argv[4],
+                (argc == 6) ? argv[5] : NULL);
+        } else {
+            char* help = g_option_context_get_help(options, TRUE, NULL);
+            fprintf(stderr, "%s", help);
+            g_free(help);
+        }
+    } else {
+        GERR("%s", error->message);
+        g_error_free(error);
+    }
+    g_option_context_free(options);
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_util.h"
+
+#include <gutil_log.h>
+
+#include <string.h>
+
+#define RET_OK          (0)
+#define RET_MISMATCH    (1)
+#define RET_ERR         (2)
+
+#define DEFAULT_FILE    "data/MCC"
+#define DEFAULT_ROUNDS  (1000)
+
+/*
+ * Times ofono_country_code() over every MCC/MNC pair listed in the MCC
+ * file the country table has been generated from, and checks that each
+ * pair resolves to the country listed in the file.
+ */
+
+typedef struct bench_entry {
+    char mcc[4];
+    char mnc[4];
+    char cc[3];
+} BenchEntry;
+
+typedef struct app {
+    const char* file;
+    gint rounds;
+} App;
+
+static
+GArray*
+bench_load(
+    const char* file)
+{
+    GError* error = NULL;
+    char* contents = NULL;
+    GArray* entries = NULL;
+
+    if (g_file_get_contents(file, &contents, NULL, &error)) {
+        char** lines = g_strsplit(contents, "\n", -1);
+        GHashTable* seen = g_hash_table_new_full(g_str_hash, g_str_equal,
+            g_free, NULL);
+        char** ptr;
+
+        entries = g_array_new(FALSE, FALSE, sizeof(BenchEntry));
+        for (ptr = lines; *ptr; ptr++) {
+            const char* line = *ptr;
+            char** f;
+
+            if (line[0] == '#') continue;
+            f = g_strsplit_set(line, " \t", 4);
+            if (g_strv_length(f) >= 3 && strlen(f[0]) == 3 &&
+                (strlen(f[1]) == 2 || strlen(f[1]) == 3) &&
+                strlen(f[2]) == 2) {
+                char* key = g_strconcat(f[0], "/", f[1], NULL);
+
+                /* The first entry wins, same as in country_table.awk */
+                if (g_hash_table_add(seen, key)) {
+                    BenchEntry e;
+                    memset(&e, 0, sizeof(e));
+                    strcpy(e.mcc, f[0]);
+                    strcpy(e.mnc, f[1]);
+                    strcpy(e.cc, f[2]);
+                    g_array_append_val(entries, e);
+                }
+            }
+            g_strfreev(f);
+        }
+        g_hash_table_destroy(seen);
+        g_strfreev(lines);
+        g_free(contents);
+    } else {
+        GERR("%s", GERRMSG(error));
+        g_error_free(error);
+    }
+    return entries;
+}
+
+static
+int
+app_run(
+    App* app)
+{
+    int ret = RET_ERR;
+    GArray* entries = bench_load(app->file);
+
+    if (entries && entries->len) {
+        const BenchEntry* e = (BenchEntry*)entries->data;
+        const guint n = entries->len;
+        guint i, r, mismatches = 0;
+        gint64 start, elapsed;
+        gsize found = 0;
+
+        for (i = 0; i < n; i++) {
+            const char* cc = ofono_country_code(e[i].mcc, e[i].mnc);
+            if (g_strcmp0(cc, e[i].cc)) {
+                GERR("%s/%s => %s (expected %s)", e[i].mcc, e[i].mnc,
+                    cc ? cc : "(null)", e[i].cc);
+                mismatches++;
+            }
+        }
+
+        start = g_get_monotonic_time();
+        for (r = 0; r < (guint)app->rounds; r++) {
+            for (i = 0; i < n; i++) {
+                /* Counting the results keeps the calls from being dropped */
+                if (ofono_country_code(e[i].mcc, e[i].mnc)) found++;
+            }
+        }
+        elapsed = g_get_monotonic_time() - start;
+
+        printf("%u x %u lookups in %.3f ms, %.1f ns per lookup\n",
+            app->rounds, n, elapsed / 1000.0,
+            elapsed * 1000.0 / ((double)n * app->rounds));
+        GDEBUG("%lu hits", (unsigned long)found);
+        if (mismatches) {
+            printf("%u mismatch(es)\n", mismatches);
+            ret = RET_MISMATCH;
+        } else {
+            ret = RET_OK;
+        }
+    } else if (entries) {
+        GERR("No entries in %s", app->file);
+    }
+    if (entries) g_array_free(entries, TRUE);
+    return ret;
+}
+
+static
+gboolean
+app_init(
+    App* app,
+    int argc,
+    char* argv[])
+{
+    gboolean ok = FALSE;
+    gboolean verbose = FALSE;
+    GOptionEntry entries[] = {
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose,
+          "Enable verbose output", NULL },
+        { "rounds", 'r', 0, G_OPTION_ARG_INT,
+          &app->rounds, "Number of passes over the file [1000]", "N" },
+        { NULL }
+    };
+    GError* error = NULL;
+    GOptionContext* options = g_option_context_new("[MCC]");
+    g_option_context_add_main_entries(options, entries, NULL);
+    if (g_option_context_parse(options, &argc, &argv, &error)) {
+        if (argc < 3 && app->rounds > 0) {
+            if (argc > 1) app->file = argv[1];
+            if (verbose) gutil_log_default.level = GLOG_LEVEL_VERBOSE;
+            ok = TRUE;
+        } else {
+            char* help = g_option_context_get_help(options, TRUE, NULL);
+            fprintf(stderr, "%s", help);
+            g_free(help);
+        }
+    } else {
+        GERR("%s", error->message);
+        g_error_free(error);
+    }
+    g_option_context_free(options);
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    int ret = RET_ERR;
+    App app;
+    memset(&app, 0, sizeof(app));
+    app.file = DEFAULT_FILE;
+    app.rounds = DEFAULT_ROUNDS;
+    gutil_log_timestamp = FALSE;
+    gutil_log_set_type(GLOG_TYPE_STDERR, "ofono-bench-country");
+    gutil_log_default.level = GLOG_LEVEL_DEFAULT;
+    if (app_init(&app, argc, argv)) {
+        ret = app_run(&app);
+    }
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
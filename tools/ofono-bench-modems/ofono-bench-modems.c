@@ -0,0 +1,490 @@
+/*
+ * Copyright (C) 2020 Jolla Ltd.
+ * Contact: Slava Monich <slava.monich@jolla.com>
+ *
+ * You may use this file under the terms of BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the name of the Jolla Ltd nor the names of its contributors
+ *      may be used to endorse or promote products derived from this software
+ *      without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gofono_context.h"
+#include "gofono_manager.h"
+#include "gofono_names.h"
+#include "gofono_util.h"
+
+#include <gutil_log.h>
+
+#include <gio/gio.h>
+
+#include <string.h>
+
+#define RET_OK          (0)
+#define RET_ERR         (2)
+#define RET_TIMEOUT     (3)
+
+#define DEFAULT_COUNT   (500)
+#define DEFAULT_TIMEOUT (30)
+
+#define MODEM_ROOT      "/bench"
+
+/*
+ * Creates and removes a bunch of modems through a stand-in oFono
+ * service running on a private session bus (requires dbus-daemon),
+ * and measures how long it takes OfonoManager to catch up.
+ */
+
+static const char bench_introspect_xml[] =
+    "<node>"
+    "  <interface name='" OFONO_MANAGER_INTERFACE_NAME "'>"
+    "    <method name='GetModems'>"
+    "      <arg name='modems' type='a(oa{sv})' direction='out'/>"
+    "    </method>"
+    "    <signal name='ModemAdded'>"
+    "      <arg name='path' type='o'/>"
+    "      <arg name='properties' type='a{sv}'/>"
+    "    </signal>"
+    "    <signal name='ModemRemoved'>"
+    "      <arg name='path' type='o'/>"
+    "    </signal>"
+    "  </interface>"
+    "  <interface name='" OFONO_MODEM_INTERFACE_NAME "'>"
+    "    <method name='GetProperties'>"
+    "      <arg name='properties' type='a{sv}' direction='out'/>"
+    "    </method>"
+    "  </interface>"
+    "</node>";
+
+typedef struct app {
+    gint count;
+    gint timeout;
+    GMainLoop* loop;
+    GDBusConnection* service;
+    GDBusNodeInfo* info;
+    GHashTable* modems;
+    guint added;
+    guint removed;
+    guint expected;
+    gboolean timed_out;
+} App;
+
+/*==========================================================================*
+ * Stand-in service
+ *==========================================================================*/
+
+static
+GVariant*
+bench_modem_properties()
+{
+    GVariantBuilder b;
+    g_variant_builder_init(&b, G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&b, "{sv}", OFONO_MODEM_PROPERTY_POWERED,
+        g_variant_new_boolean(FALSE));
+    g_variant_builder_add(&b, "{sv}", OFONO_MODEM_PROPERTY_ONLINE,
+        g_variant_new_boolean(FALSE));
+    g_variant_builder_add(&b, "{sv}", OFONO_MODEM_PROPERTY_INTERFACES,
+        g_variant_new_strv(NULL, 0));
+    return g_variant_builder_end(&b);
+}
+
+static
+void
+bench_manager_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* call,
+    gpointer data)
+{
+    App* app = data;
+    GVariantBuilder b;
+    GHashTableIter it;
+    gpointer key;
+
+    g_variant_builder_init(&b, G_VARIANT_TYPE("a(oa{sv})"));
+    g_hash_table_iter_init(&it, app->modems);
+    while (g_hash_table_iter_next(&it, &key, NULL)) {
+        g_variant_builder_add(&b, "(o@a{sv})", key,
+            bench_modem_properties());
+    }
+    g_dbus_method_invocation_return_value(call,
+        g_variant_new("(a(oa{sv}))", &b));
+}
+
+static
+void
+bench_modem_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* call,
+    gpointer data)
+{
+    g_dbus_method_invocation_return_value(call,
+        g_variant_new("(@a{sv})", bench_modem_properties()));
+}
+
+static const GDBusInterfaceVTable bench_manager_vtable = {
+    bench_manager_method_call
+};
+
+static const GDBusInterfaceVTable bench_modem_vtable = {
+    bench_modem_method_call
+};
+
+static
+char**
+bench_modem_enumerate(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    gpointer data)
+{
+    /* Modems are dispatched without being enumerated */
+    return g_new0(char*, 1);
+}
+
+static
+GDBusInterfaceInfo**
+bench_modem_introspect(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* node,
+    gpointer data)
+{
+    App* app = data;
+    GDBusInterfaceInfo** ifaces = g_new0(GDBusInterfaceInfo*, 2);
+    if (node) {
+        ifaces[0] = g_dbus_interface_info_ref(
+            g_dbus_node_info_lookup_interface(app->info,
+            OFONO_MODEM_INTERFACE_NAME));
+    }
+    return ifaces;
+}
+
+static
+const GDBusInterfaceVTable*
+bench_modem_dispatch(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* node,
+    gpointer* out_data,
+    gpointer data)
+{
+    *out_data = data;
+    return (node && !g_strcmp0(iface, OFONO_MODEM_INTERFACE_NAME)) ?
+        &bench_modem_vtable : NULL;
+}
+
+static const GDBusSubtreeVTable bench_modem_subtree = {
+    bench_modem_enumerate,
+    bench_modem_introspect,
+    bench_modem_dispatch
+};
+
+static
+gboolean
+bench_service_start(
+    App* app,
+    const char* address)
+{
+    GError* error = NULL;
+    GVariant* ret;
+
+    app->service = g_dbus_connection_new_for_address_sync(address,
+        G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+        G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION, NULL, NULL, &error);
+    if (!app->service) {
+        GERR("%s", GERRMSG(error));
+        g_error_free(error);
+        return FALSE;
+    }
+    g_dbus_connection_register_object(app->service, "/",
+        g_dbus_node_info_lookup_interface(app->info,
+        OFONO_MANAGER_INTERFACE_NAME), &bench_manager_vtable, app, NULL,
+        NULL);
+    g_dbus_connection_register_subtree(app->service, MODEM_ROOT,
+        &bench_modem_subtree,
+        G_DBUS_SUBTREE_FLAGS_DISPATCH_TO_UNENUMERATED_NODES, app, NULL, NULL);
+    ret = g_dbus_connection_call_sync(app->service, "org.freedesktop.DBus",
+        "/org/freedesktop/DBus", "org.freedesktop.DBus", "RequestName",
+        g_variant_new("(su)", OFONO_SERVICE, 0), G_VARIANT_TYPE("(u)"),
+        G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+    if (!ret) {
+        GERR("%s", GERRMSG(error));
+        g_error_free(error);
+        return FALSE;
+    }
+    g_variant_unref(ret);
+    return TRUE;
+}
+
+static
+void
+bench_modem_added(
+    App* app,
+    const char* path)
+{
+    g_hash_table_add(app->modems, g_strdup(path));
+    g_dbus_connection_emit_signal(app->service, NULL, "/",
+        OFONO_MANAGER_INTERFACE_NAME, "ModemAdded",
+        g_variant_new("(o@a{sv})", path, bench_modem_properties()), NULL);
+}
+
+static
+void
+bench_modem_removed(
+    App* app,
+    const char* path)
+{
+    g_hash_table_remove(app->modems, path);
+    g_dbus_connection_emit_signal(app->service, NULL, "/",
+        OFONO_MANAGER_INTERFACE_NAME, "ModemRemoved",
+        g_variant_new("(o)", path), NULL);
+}
+
+/*==========================================================================*
+ * Benchmark
+ *==========================================================================*/
+
+static
+void
+bench_manager_modem_added(
+    OfonoManager* manager,
+    OfonoModem* modem,
+    void* arg)
+{
+    App* app = arg;
+    app->added++;
+    if (app->added == app->expected) g_main_loop_quit(app->loop);
+}
+
+static
+void
+bench_manager_modem_removed(
+    OfonoManager* manager,
+    const char* path,
+    void* arg)
+{
+    App* app = arg;
+    app->removed++;
+    if (app->removed == app->expected) g_main_loop_quit(app->loop);
+}
+
+static
+gboolean
+bench_timeout(
+    gpointer data)
+{
+    App* app = data;
+    app->timed_out = TRUE;
+    g_main_loop_quit(app->loop);
+    return G_SOURCE_CONTINUE;
+}
+
+static
+double
+bench_elapsed_ms(
+    gint64 start)
+{
+    return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+static
+int
+bench_run(
+    App* app,
+    OfonoManager* manager)
+{
+    const guint n = app->count;
+    char** paths = g_new0(char*, n + 1);
+    guint timeout_id = 0;
+    guint i, found;
+    gint64 start;
+
+    for (i = 0; i < n; i++) {
+        paths[i] = g_strdup_printf(MODEM_ROOT "/modem%u", i);
+    }
+    if (app->timeout > 0) {
+        timeout_id = g_timeout_add_seconds(app->timeout, bench_timeout, app);
+    }
+
+    /* Emitting signals is cheap, most of the time is spent catching up */
+    app->expected = n;
+    start = g_get_monotonic_time();
+    for (i = 0; i < n; i++) {
+        bench_modem_added(app, paths[i]);
+    }
+    g_main_loop_run(app->loop);
+    if (!app->timed_out) {
+        printf("Added %u modems in %.3f ms\n", n, bench_elapsed_ms(start));
+
+        found = 0;
+        start = g_get_monotonic_time();
+        for (i = 0; i < n; i++) {
+            if (ofono_manager_has_modem(manager, paths[i])) found++;
+        }
+        printf("Looked up %u modems in %.3f ms\n", found,
+            bench_elapsed_ms(start));
+
+        start = g_get_monotonic_time();
+        for (i = 0; i < n; i++) {
+            bench_modem_removed(app, paths[i]);
+        }
+        g_main_loop_run(app->loop);
+        if (!app->timed_out) {
+            printf("Removed %u modems in %.3f ms\n", n,
+                bench_elapsed_ms(start));
+        }
+    }
+
+    if (timeout_id) g_source_remove(timeout_id);
+    g_strfreev(paths);
+    if (app->timed_out) {
+        GERR("Timed out (%u added, %u removed)", app->added, app->removed);
+        return RET_TIMEOUT;
+    }
+    return RET_OK;
+}
+
+static
+int
+app_run(
+    App* app)
+{
+    int ret = RET_ERR;
+    GTestDBus* bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+
+    /* Sets DBUS_SESSION_BUS_ADDRESS */
+    g_test_dbus_up(bus);
+    app->loop = g_main_loop_new(NULL, FALSE);
+    app->info = g_dbus_node_info_new_for_xml(bench_introspect_xml, NULL);
+    app->modems = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    if (bench_service_start(app, g_test_dbus_get_bus_address(bus))) {
+        GError* error = NULL;
+        OfonoManager* manager;
+
+        ofono_context_set_bus_type(ofono_context_default(),
+            G_BUS_TYPE_SESSION);
+        manager = ofono_manager_new();
+        if (ofono_manager_wait_valid(manager, app->timeout * 1000, &error)) {
+            gulong id[2];
+            id[0] = ofono_manager_add_modem_added_handler(manager,
+                bench_manager_modem_added, app);
+            id[1] = ofono_manager_add_modem_removed_handler(manager,
+                bench_manager_modem_removed, app);
+            ret = bench_run(app, manager);
+            ofono_manager_remove_handlers(manager, id, G_N_ELEMENTS(id));
+        } else {
+            GERR("%s", GERRMSG(error));
+            ret = (error->code == G_IO_ERROR_TIMED_OUT) ? RET_TIMEOUT :
+                RET_ERR;
+            g_error_free(error);
+        }
+        ofono_manager_unref(manager);
+        ofono_idle_pool_drain();
+    }
+    if (app->service) {
+        g_dbus_connection_close_sync(app->service, NULL, NULL);
+        g_object_unref(app->service);
+    }
+    g_hash_table_destroy(app->modems);
+    g_dbus_node_info_unref(app->info);
+    g_main_loop_unref(app->loop);
+    g_test_dbus_down(bus);
+    g_object_unref(bus);
+    return ret;
+}
+
+static
+gboolean
+app_init(
+    App* app,
+    int argc,
+    char* argv[])
+{
+    gboolean ok = FALSE;
+    gboolean verbose = FALSE;
+    GOptionEntry entries[] = {
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose,
+          "Enable verbose output", NULL },
+        { "count", 'n', 0, G_OPTION_ARG_INT,
+          &app->count, "Number of modems [500]", "COUNT" },
+        { "timeout", 't', 0, G_OPTION_ARG_INT,
+          &app->timeout, "Timeout in seconds [30]", "SECONDS" },
+        { NULL }
+    };
+    GError* error = NULL;
+    GOptionContext* options = g_option_context_new(NULL);
+    g_option_context_add_main_entries(options, entries, NULL);
+    if (g_option_context_parse(options, &argc, &argv, &error)) {
+        if (argc == 1 && app->count > 0) {
+            if (verbose) gutil_log_default.level = GLOG_LEVEL_VERBOSE;
+            ok = TRUE;
+        } else {
+            char* help = g_option_context_get_help(options, TRUE, NULL);
+            fprintf(stderr, "%s", help);
+            g_free(help);
+        }
+    } else {
+        GERR("%s", error->message);
+        g_error_free(error);
+    }
+    g_option_context_free(options);
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    int ret = RET_ERR;
+    App app;
+    memset(&app, 0, sizeof(app));
+    app.count = DEFAULT_COUNT;
+    app.timeout = DEFAULT_TIMEOUT;
+    gutil_log_timestamp = FALSE;
+    gutil_log_set_type(GLOG_TYPE_STDERR, "ofono-bench-modems");
+    gutil_log_default.level = GLOG_LEVEL_DEFAULT;
+    if (app_init(&app, argc, argv)) {
+        ret = app_run(&app);
+    }
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */